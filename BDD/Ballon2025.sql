@@ -54,6 +54,112 @@ CREATE TABLE `trames` (
   `date_reception` datetime NOT NULL DEFAULT CURRENT_TIMESTAMP
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
 
+-- --------------------------------------------------------
+
+--
+-- Structure de la table `evenements`
+--
+
+CREATE TABLE `evenements` (
+  `indicatif` varchar(10) NOT NULL,
+  `type` varchar(16) NOT NULL,
+  `date_evenement` datetime(3) NOT NULL,
+  `altitude` double DEFAULT NULL,
+  `latitude` double DEFAULT NULL,
+  `longitude` double DEFAULT NULL,
+  `vitesse_verticale` double DEFAULT NULL
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
+
+-- --------------------------------------------------------
+
+--
+-- Structure de la table `predictions`
+--
+
+CREATE TABLE `predictions` (
+  `indicatif` varchar(10) NOT NULL,
+  `date_calcul` datetime(3) NOT NULL,
+  `latitude` double NOT NULL,
+  `longitude` double NOT NULL,
+  `date_atterrissage` datetime(3) NOT NULL,
+  `altitude` double DEFAULT NULL,
+  `vitesse_descente` double DEFAULT NULL
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
+
+-- --------------------------------------------------------
+
+--
+-- Structure de la table `decodages`
+--
+
+CREATE TABLE `decodages` (
+  `trame` varchar(100) NOT NULL,
+  `source` varchar(255) NOT NULL,
+  `date_reception` datetime NOT NULL,
+  `type` varchar(16) NOT NULL,
+  `latitude` double DEFAULT NULL,
+  `longitude` double DEFAULT NULL,
+  `altitude` double DEFAULT NULL,
+  `vitesse` double DEFAULT NULL,
+  `cap` int DEFAULT NULL,
+  `sequence` int DEFAULT NULL,
+  `a1` double DEFAULT NULL,
+  `a2` double DEFAULT NULL,
+  `a3` double DEFAULT NULL,
+  `a4` double DEFAULT NULL,
+  `a5` double DEFAULT NULL,
+  `bits` int DEFAULT NULL,
+  `temperature` double DEFAULT NULL,
+  `pression` double DEFAULT NULL,
+  `humidite` int DEFAULT NULL,
+  `version` int NOT NULL
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
+
+-- --------------------------------------------------------
+
+--
+-- Structure de la table `reprises`
+--
+
+CREATE TABLE `reprises` (
+  `nom` varchar(64) NOT NULL,
+  `derniere_trame` varchar(100) NOT NULL,
+  `lignes` bigint NOT NULL DEFAULT 0,
+  `date_maj` datetime NOT NULL
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
+
+-- --------------------------------------------------------
+
+--
+-- Structure de la table `station_state`
+--
+
+CREATE TABLE `station_state` (
+  `indicatif` varchar(10) NOT NULL,
+  `trames` bigint NOT NULL DEFAULT 0,
+  `date_trame` datetime(3) DEFAULT NULL,
+  `derniere_trame` text,
+  `type` varchar(16) DEFAULT NULL,
+  `date_position` datetime(3) DEFAULT NULL,
+  `latitude` double DEFAULT NULL,
+  `longitude` double DEFAULT NULL,
+  `altitude` double DEFAULT NULL,
+  `vitesse` double DEFAULT NULL,
+  `cap` int DEFAULT NULL,
+  `date_telemetrie` datetime(3) DEFAULT NULL,
+  `sequence` int DEFAULT NULL,
+  `a1` double DEFAULT NULL,
+  `a2` double DEFAULT NULL,
+  `a3` double DEFAULT NULL,
+  `a4` double DEFAULT NULL,
+  `a5` double DEFAULT NULL,
+  `bits` int DEFAULT NULL,
+  `date_meteo` datetime(3) DEFAULT NULL,
+  `temperature` double DEFAULT NULL,
+  `pression` double DEFAULT NULL,
+  `humidite` int DEFAULT NULL
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
+
 --
 -- Index pour les tables exportées
 --
@@ -68,7 +174,40 @@ ALTER TABLE `machines`
 -- Index pour la table `trames`
 --
 ALTER TABLE `trames`
-  ADD PRIMARY KEY (`trame`);
+  ADD PRIMARY KEY (`trame`),
+  ADD KEY `idx_trames_date` (`date_reception`),
+  ADD KEY `idx_trames_source_date` (`source`,`date_reception`);
+
+--
+-- Index pour la table `decodages`
+--
+ALTER TABLE `decodages`
+  ADD PRIMARY KEY (`trame`),
+  ADD KEY `idx_decodages_source_date` (`source`,`date_reception`);
+
+--
+-- Index pour la table `reprises`
+--
+ALTER TABLE `reprises`
+  ADD PRIMARY KEY (`nom`);
+
+--
+-- Index pour la table `station_state`
+--
+ALTER TABLE `station_state`
+  ADD PRIMARY KEY (`indicatif`);
+
+--
+-- Index pour la table `evenements`
+--
+ALTER TABLE `evenements`
+  ADD PRIMARY KEY (`indicatif`,`type`,`date_evenement`);
+
+--
+-- Index pour la table `predictions`
+--
+ALTER TABLE `predictions`
+  ADD PRIMARY KEY (`indicatif`,`date_calcul`);
 
 /*!40101 SET CHARACTER_SET_CLIENT=@OLD_CHARACTER_SET_CLIENT */;
 /*!40101 SET CHARACTER_SET_RESULTS=@OLD_CHARACTER_SET_RESULTS */;
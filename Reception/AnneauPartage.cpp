@@ -0,0 +1,267 @@
+#include "AnneauPartage.h"
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+AnneauPartage::AnneauPartage()
+    : entete(nullptr), donnees(nullptr), tailleZone(0)
+{
+}
+
+AnneauPartage::~AnneauPartage()
+{
+    fermer();
+}
+
+// Droits de la mémoire partagée : le pilote LoRa et la réception, même utilisateur ou même groupe
+static const mode_t DROITS_ANNEAU = 0660;
+
+/**
+ * @brief AnneauPartage::ouvrir crée ou rejoint l'anneau
+ * @param nom le nom de la mémoire partagée POSIX ("/ballon_rx")
+ * @param producteur true pour le producteur, qui crée l'anneau ; false pour le consommateur, qui le rejoint
+ * @param capacite la taille des données, choisie par le producteur (puissance de 2)
+ * @brief Le producteur recrée toujours la mémoire à son lancement : un anneau laissé par un
+ *        arrêt brutal (en-tête jamais initialisé, positions ou attentes périmées) n'est jamais
+ *        repris. Le consommateur attend que l'anneau soit prêt et en reprend la capacité ; il
+ *        passe au nouvel anneau une fois l'ancien vidé.
+ */
+void AnneauPartage::ouvrir(const std::string &nom, bool producteur, uint32_t capacite)
+{
+    if (capacite < 64 || (capacite & (capacite - 1)) != 0)
+        throw std::invalid_argument("Capacite de l'anneau invalide.");
+    fermer();
+    this->nom = nom;
+    if (producteur)
+        creer(capacite);
+    else
+        rejoindre();
+}
+
+/**
+ * @brief AnneauPartage::perimer marque l'anneau encore en place comme remplacé et réveille son consommateur
+ * @param nom le nom de la mémoire partagée
+ */
+void AnneauPartage::perimer(const std::string &nom)
+{
+    const int fd = shm_open(nom.c_str(), O_RDWR, 0);
+    if (fd == -1)
+        return;
+    struct stat etat;
+    if (fstat(fd, &etat) == 0 && static_cast<size_t>(etat.st_size) >= sizeof(Entete)) {
+        void *zone = mmap(nullptr, sizeof(Entete), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (zone != MAP_FAILED) {
+            Entete *ancien = static_cast<Entete *>(zone);
+            ancien->initialise.store(PERIME);
+            ancien->signalEcriture.fetch_add(1);
+            reveiller(ancien->signalEcriture);
+            munmap(zone, sizeof(Entete));
+        }
+    }
+    close(fd);
+}
+
+/**
+ * @brief AnneauPartage::creer remplace la mémoire partagée par un anneau vide (côté producteur)
+ * @param capacite la taille des données
+ */
+void AnneauPartage::creer(uint32_t capacite)
+{
+    perimer(nom);
+    shm_unlink(nom.c_str());
+    const int fd = shm_open(nom.c_str(), O_RDWR | O_CREAT | O_EXCL, DROITS_ANNEAU);
+    if (fd == -1)
+        throw std::runtime_error("Erreur lors de la creation de la memoire partagee.");
+
+    tailleZone = sizeof(Entete) + capacite;
+    if (ftruncate(fd, static_cast<off_t>(tailleZone)) == -1) {
+        close(fd);
+        tailleZone = 0;
+        throw std::runtime_error("Erreur lors du dimensionnement de la memoire partagee.");
+    }
+    void *zone = mmap(nullptr, tailleZone, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (zone == MAP_FAILED) {
+        tailleZone = 0;
+        throw std::runtime_error("Erreur lors de la projection de la memoire partagee.");
+    }
+    entete = static_cast<Entete *>(zone);
+    donnees = static_cast<unsigned char *>(zone) + sizeof(Entete);
+
+    new (entete) Entete();
+    entete->capacite = capacite;
+    entete->initialise.store(MAGIQUE, std::memory_order_release);
+}
+
+/**
+ * @brief AnneauPartage::rejoindre projette l'anneau prêt du producteur (côté consommateur)
+ * @brief L'attente dure jusqu'au lancement du producteur ; une mémoire absente, pas encore
+ *        initialisée ou périmée est rouverte par son nom jusqu'à trouver l'anneau en service.
+ */
+void AnneauPartage::rejoindre()
+{
+    while (true) {
+        const int fd = shm_open(nom.c_str(), O_RDWR, 0);
+        if (fd == -1 && errno != ENOENT)
+            throw std::runtime_error("Erreur lors de l'ouverture de la memoire partagee.");
+        if (fd != -1) {
+            struct stat etat;
+            if (fstat(fd, &etat) == 0 && static_cast<size_t>(etat.st_size) >= sizeof(Entete)) {
+                const size_t taille = static_cast<size_t>(etat.st_size);
+                void *zone = mmap(nullptr, taille, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (zone != MAP_FAILED) {
+                    Entete *pret = static_cast<Entete *>(zone);
+                    if (pret->initialise.load(std::memory_order_acquire) == MAGIQUE &&
+                        sizeof(Entete) + pret->capacite == taille) {
+                        close(fd);
+                        entete = pret;
+                        donnees = static_cast<unsigned char *>(zone) + sizeof(Entete);
+                        tailleZone = taille;
+                        return;
+                    }
+                    munmap(zone, taille);
+                }
+            }
+            close(fd);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+/**
+ * @brief AnneauPartage::fermer détache l'anneau (la mémoire partagée reste en place)
+ */
+void AnneauPartage::fermer()
+{
+    if (entete != nullptr)
+        munmap(entete, tailleZone);
+    entete = nullptr;
+    donnees = nullptr;
+    tailleZone = 0;
+}
+
+/**
+ * @brief AnneauPartage::attendreSignal dort tant que le futex vaut encore valeur
+ */
+void AnneauPartage::attendreSignal(std::atomic<uint32_t> &signal, uint32_t valeur)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&signal), FUTEX_WAIT, valeur, nullptr, nullptr, 0);
+}
+
+/**
+ * @brief AnneauPartage::reveiller réveille le processus qui dort sur le futex
+ */
+void AnneauPartage::reveiller(std::atomic<uint32_t> &signal)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&signal), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+/**
+ * @brief AnneauPartage::ecrire publie un enregistrement (côté producteur)
+ * @param donneesEcrites les octets de l'enregistrement
+ * @param longueur le nombre d'octets, de 1 au quart de la capacité
+ * @param attendre true pour attendre de la place si l'anneau est plein
+ * @return false si l'anneau est plein et que attendre vaut false
+ * @brief Chaque enregistrement est précédé de sa longueur sur 4 octets et aligné sur 4 octets ;
+ *        s'il ne tient pas avant la fin des données, une marque de retour le renvoie au début.
+ */
+bool AnneauPartage::ecrire(const void *donneesEcrites, size_t longueur, bool attendre)
+{
+    const uint32_t capacite = entete->capacite;
+    if (longueur == 0 || longueur > capacite / 4)
+        throw std::invalid_argument("Longueur d'enregistrement invalide.");
+
+    const uint32_t taille = 4 + arrondir(static_cast<uint32_t>(longueur));
+    const uint32_t tete = entete->tete.load(std::memory_order_relaxed);
+    const uint32_t position = tete & (capacite - 1);
+    const uint32_t avantRetour = capacite - position;
+    const uint32_t necessaire = (taille <= avantRetour) ? taille : avantRetour + taille;
+
+    while (necessaire > capacite - (tete - entete->queue.load(std::memory_order_acquire))) {
+        if (!attendre)
+            return false;
+        const uint32_t valeur = entete->signalLecture.load();
+        entete->producteurEnAttente.store(1);
+        if (necessaire > capacite - (tete - entete->queue.load()))
+            attendreSignal(entete->signalLecture, valeur);
+        entete->producteurEnAttente.store(0);
+    }
+
+    uint32_t debut = position;
+    if (taille > avantRetour) {
+        const uint32_t marque = MARQUE_RETOUR;
+        std::memcpy(donnees + position, &marque, 4);
+        debut = 0;
+    }
+    const uint32_t longueur32 = static_cast<uint32_t>(longueur);
+    std::memcpy(donnees + debut, &longueur32, 4);
+    std::memcpy(donnees + debut + 4, donneesEcrites, longueur);
+
+    entete->tete.store(tete + necessaire);
+    entete->signalEcriture.fetch_add(1);
+    if (entete->consommateurEnAttente.load() != 0)
+        reveiller(entete->signalEcriture);
+    return true;
+}
+
+/**
+ * @brief AnneauPartage::lire consomme un enregistrement (côté consommateur)
+ * @param donneesLues le tampon à remplir
+ * @param capacite la taille du tampon ; un enregistrement plus long est tronqué
+ * @param attendre true pour attendre un enregistrement si l'anneau est vide
+ * @return le nombre d'octets copiés, 0 si l'anneau est vide et que attendre vaut false
+ */
+size_t AnneauPartage::lire(void *donneesLues, size_t capacite, bool attendre)
+{
+    uint32_t queue = entete->queue.load(std::memory_order_relaxed);
+    while (entete->tete.load(std::memory_order_acquire) == queue) {
+        // Anneau vidé et remplacé par un nouveau producteur : la lecture continue dans le nouveau
+        if (entete->initialise.load(std::memory_order_acquire) == PERIME) {
+            fermer();
+            rejoindre();
+            queue = entete->queue.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (!attendre)
+            return 0;
+        const uint32_t valeur = entete->signalEcriture.load();
+        entete->consommateurEnAttente.store(1);
+        if (entete->tete.load() == queue && entete->initialise.load() != PERIME)
+            attendreSignal(entete->signalEcriture, valeur);
+        entete->consommateurEnAttente.store(0);
+    }
+
+    const uint32_t masque = entete->capacite - 1;
+    uint32_t longueur;
+    std::memcpy(&longueur, donnees + (queue & masque), 4);
+    if (longueur == MARQUE_RETOUR) {
+        queue += entete->capacite - (queue & masque);
+        std::memcpy(&longueur, donnees + (queue & masque), 4);
+    }
+    const size_t copie = (longueur < capacite) ? longueur : capacite;
+    std::memcpy(donneesLues, donnees + (queue & masque) + 4, copie);
+
+    entete->queue.store(queue + 4 + arrondir(longueur));
+    entete->signalLecture.fetch_add(1);
+    if (entete->producteurEnAttente.load() != 0)
+        reveiller(entete->signalLecture);
+    return copie;
+}
+
+/**
+ * @brief AnneauPartage::vide
+ * @return true si aucun enregistrement n'attend d'être lu
+ */
+bool AnneauPartage::vide() const
+{
+    return entete->tete.load(std::memory_order_acquire) == entete->queue.load(std::memory_order_relaxed);
+}
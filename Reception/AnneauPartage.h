@@ -0,0 +1,64 @@
+/**
+ * AnneauPartage.h est la classe qui gère un anneau en mémoire partagée entre deux processus
+ *
+ * Un seul producteur et un seul consommateur échangent des enregistrements de longueur
+ * variable sans appel système : seule l'attente d'un anneau vide (ou plein) passe par
+ * un futex, et le réveil n'est demandé que si l'autre côté dort.
+ */
+
+#ifndef ANNEAUPARTAGE_H
+#define ANNEAUPARTAGE_H
+
+#include <atomic>   // Inclut la bibliothèque standard de C++ pour les opérations atomiques
+#include <cstddef>  // Inclut la bibliothèque standard de C pour size_t
+#include <cstdint>  // Inclut la bibliothèque standard de C pour uint32_t
+#include <string>   // Inclut la bibliothèque standard de C++ pour les chaînes de caractères
+
+class AnneauPartage
+{
+public:
+    static const uint32_t CAPACITE_DEFAUT = 16384;  // Octets de données de l'anneau (puissance de 2)
+
+    AnneauPartage();
+    ~AnneauPartage();
+
+    void ouvrir(const std::string &nom, bool producteur, uint32_t capacite = CAPACITE_DEFAUT);
+    void fermer();
+
+    bool ecrire(const void *donnees, size_t longueur, bool attendre);
+    size_t lire(void *donnees, size_t capacite, bool attendre);
+    bool vide() const;
+
+private:
+    // Début de la zone partagée, suivi des données de l'anneau
+    struct Entete
+    {
+        std::atomic<uint32_t> initialise;       // MAGIQUE une fois l'en-tête prêt, PERIME une fois remplacé
+        uint32_t capacite;                      // Taille des données (puissance de 2)
+        std::atomic<uint32_t> tete;             // Position d'écriture (octets, croissante modulo 2^32)
+        std::atomic<uint32_t> queue;            // Position de lecture (octets, croissante modulo 2^32)
+        std::atomic<uint32_t> signalEcriture;   // Futex : incrémenté à chaque enregistrement publié
+        std::atomic<uint32_t> signalLecture;    // Futex : incrémenté à chaque enregistrement consommé
+        std::atomic<uint32_t> consommateurEnAttente;
+        std::atomic<uint32_t> producteurEnAttente;
+    };
+
+    static const uint32_t MAGIQUE = 0x42414C4E;          // "BALN"
+    static const uint32_t PERIME = 0x44454144;           // "DEAD" : anneau remplacé par un nouveau producteur
+    static const uint32_t MARQUE_RETOUR = 0xFFFFFFFFu;   // Fin des données avant le retour au début
+
+    static uint32_t arrondir(uint32_t longueur) { return (longueur + 3u) & ~3u; }
+    static void attendreSignal(std::atomic<uint32_t> &signal, uint32_t valeur);
+    static void reveiller(std::atomic<uint32_t> &signal);
+
+    void creer(uint32_t capacite);
+    void rejoindre();
+    static void perimer(const std::string &nom);
+
+    std::string nom;
+    Entete *entete;
+    unsigned char *donnees;
+    size_t tailleZone;
+};
+
+#endif // ANNEAUPARTAGE_H
@@ -0,0 +1,249 @@
+#include "EnregistreurVol.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const std::chrono::seconds EnregistreurVol::INTERVALLE_ECRITURE(10);
+
+/**
+ * @brief crc32Bloc calcule le CRC32 (polynôme 0xEDB88320) d'un bloc, son champ crc compté à zéro
+ * @param bloc le bloc
+ * @return la somme de contrôle
+ */
+uint32_t crc32Bloc(const BlocVol &bloc)
+{
+    static const struct Table
+    {
+        uint32_t valeurs[256];
+        Table()
+        {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                valeurs[i] = c;
+            }
+        }
+    } table;
+
+    const unsigned char *octets = reinterpret_cast<const unsigned char *>(&bloc);
+    const size_t debutCrc = offsetof(EnteteBlocVol, crc);
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < sizeof(BlocVol); ++i) {
+        const unsigned char octet = (i >= debutCrc && i < debutCrc + sizeof(uint32_t)) ? 0 : octets[i];
+        crc = table.valeurs[(crc ^ octet) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Bloc vide, prêt à recevoir des enregistrements
+static void viderBloc(BlocVol &bloc, size_t indice)
+{
+    std::memset(&bloc, 0, sizeof(bloc));
+    bloc.entete.magique = MAGIQUE_BLOC_VOL;
+    bloc.entete.numeroBloc = static_cast<uint32_t>(indice);
+    bloc.entete.version = VERSION_BLOC_VOL;
+}
+
+EnregistreurVol::EnregistreurVol()
+    : fichier(-1), numeroSegment(0), indiceBloc(0), modifie(false), arret(false), numero(0), perdus(0)
+{
+    viderBloc(courant, 0);
+}
+
+EnregistreurVol::~EnregistreurVol()
+{
+    if (fichier != -1)
+        close(fichier);
+}
+
+/**
+ * @brief EnregistreurVol::ouvrir prépare l'enregistrement dans un nouveau segment
+ * @param nomRepertoire le répertoire des segments, créé s'il n'existe pas
+ * @brief Le segment suit le plus grand numéro déjà présent : un redémarrage en vol
+ *        n'écrase jamais les mesures d'avant la coupure.
+ */
+void EnregistreurVol::ouvrir(const std::string &nomRepertoire)
+{
+    repertoire = nomRepertoire;
+    if (mkdir(repertoire.c_str(), 0755) == -1 && errno != EEXIST)
+        throw std::runtime_error("Erreur lors de la creation du repertoire d'enregistrement.");
+
+    DIR *dossier = opendir(repertoire.c_str());
+    if (dossier == nullptr)
+        throw std::runtime_error("Erreur lors de l'ouverture du repertoire d'enregistrement.");
+    unsigned suivant = 0;
+    while (const dirent *entree = readdir(dossier)) {
+        unsigned n;
+        char fin;
+        if (std::sscanf(entree->d_name, "vol_%u.bi%c", &n, &fin) == 2 && fin == 'n' && n + 1 > suivant)
+            suivant = n + 1;
+    }
+    closedir(dossier);
+
+    numeroSegment = suivant;
+    ouvrirSegment();
+}
+
+/**
+ * @brief EnregistreurVol::ouvrirSegment crée le segment numeroSegment et alloue toute sa place d'avance
+ * @brief Les blocs sont ensuite écrits à leur place : la taille du fichier et ses métadonnées
+ *        ne changent plus pendant le vol.
+ */
+void EnregistreurVol::ouvrirSegment()
+{
+    if (fichier != -1)
+        close(fichier);
+    char nom[32];
+    std::snprintf(nom, sizeof(nom), "/vol_%04u.bin", numeroSegment);
+    const std::string chemin = repertoire + nom;
+
+    fichier = open(chemin.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fichier == -1)
+        throw std::runtime_error("Erreur lors de la creation du segment d'enregistrement.");
+    if (posix_fallocate(fichier, 0, static_cast<off_t>(NB_BLOCS_SEGMENT * TAILLE_BLOC_VOL)) != 0) {
+        close(fichier);
+        fichier = -1;
+        throw std::runtime_error("Erreur lors de l'allocation du segment d'enregistrement.");
+    }
+    fsync(fichier);
+}
+
+/**
+ * @brief EnregistreurVol::reprendreSegment retente la création du segment courant, refusée au changement de segment
+ * @return true si le segment est ouvert
+ */
+bool EnregistreurVol::reprendreSegment()
+{
+    try {
+        ouvrirSegment();
+    }
+    catch (const std::exception &) {
+        return false;
+    }
+    std::cerr << "Enregistreur de vol: segment " << numeroSegment << " ouvert, "
+              << perdus << " enregistrement(s) perdu(s)" << std::endl;
+    return true;
+}
+
+/**
+ * @brief EnregistreurVol::enregistrer range une mesure horodatée dans le bloc courant, sans écriture
+ * @param mesures les mesures des capteurs
+ * @brief Si le bloc courant est plein et pas encore repris par le thread d'écriture, la mesure est perdue.
+ */
+void EnregistreurVol::enregistrer(const MesuresNacelle &mesures)
+{
+    const int64_t instant = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::lock_guard<std::mutex> lock(mutexBloc);
+    EnteteBlocVol &entete = courant.entete;
+    if (entete.nbEnregistrements == ENREGISTREMENTS_PAR_BLOC)
+        return;
+    EnregistrementVol &enregistrement = courant.enregistrements[entete.nbEnregistrements++];
+    enregistrement.numero = numero++;
+    enregistrement.instant = instant;
+    enregistrement.mesures = mesures;
+    modifie = true;
+    if (entete.nbEnregistrements == ENREGISTREMENTS_PAR_BLOC)
+        blocPlein.notify_one();
+}
+
+/**
+ * @brief EnregistreurVol::ecrireBloc écrit un bloc à sa place dans le segment et attend qu'il soit sur la carte
+ * @param bloc le bloc, dont la somme de contrôle est calculée ici
+ * @param indice la place du bloc dans le segment
+ */
+void EnregistreurVol::ecrireBloc(BlocVol &bloc, size_t indice)
+{
+    bloc.entete.crc = crc32Bloc(bloc);
+    const char *octets = reinterpret_cast<const char *>(&bloc);
+    size_t ecrits = 0;
+    while (ecrits < sizeof(bloc)) {
+        const ssize_t n = pwrite(fichier, octets + ecrits, sizeof(bloc) - ecrits,
+                                 static_cast<off_t>(indice * TAILLE_BLOC_VOL + ecrits));
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+            std::cerr << "Erreur d'écriture de l'enregistreur de vol: " << std::strerror(errno) << std::endl;
+            return;
+        }
+        ecrits += static_cast<size_t>(n);
+    }
+    if (fdatasync(fichier) == -1)
+        std::cerr << "Erreur de synchronisation de l'enregistreur de vol: " << std::strerror(errno) << std::endl;
+}
+
+/**
+ * @brief EnregistreurVol::arreter demande au thread d'écriture d'écrire le bloc courant puis de rendre la main
+ */
+void EnregistreurVol::arreter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutexBloc);
+        arret = true;
+    }
+    blocPlein.notify_one();
+}
+
+/**
+ * @brief EnregistreurVol::executer boucle du thread d'écriture, jusqu'à l'appel d'arreter()
+ * @brief Le bloc courant est recopié sous le verrou puis écrit hors du verrou : un bloc plein
+ *        laisse la place au suivant, un bloc partiel sera réécrit à la même place, complété.
+ * @brief Si le segment suivant n'a pu être créé, la création est retentée à chaque écriture ;
+ *        en attendant, les blocs pleins sont comptés comme perdus au lieu d'être écrits.
+ */
+void EnregistreurVol::executer()
+{
+    std::unique_lock<std::mutex> lock(mutexBloc);
+    while (true) {
+        blocPlein.wait_for(lock, INTERVALLE_ECRITURE, [this]() {
+            return arret || courant.entete.nbEnregistrements == ENREGISTREMENTS_PAR_BLOC;
+        });
+        if (!modifie) {
+            if (arret) {
+                if (fichier == -1)
+                    std::cerr << "Enregistreur de vol: segment " << numeroSegment << " jamais ouvert, "
+                              << perdus << " enregistrement(s) perdu(s)" << std::endl;
+                return;
+            }
+            continue;
+        }
+
+        copie = courant;
+        const size_t indice = indiceBloc;
+        const bool plein = (courant.entete.nbEnregistrements == ENREGISTREMENTS_PAR_BLOC);
+        bool segmentSuivant = false;
+        if (plein) {
+            indiceBloc = (indiceBloc + 1) % NB_BLOCS_SEGMENT;
+            segmentSuivant = (indiceBloc == 0);
+            viderBloc(courant, indiceBloc);
+        }
+        modifie = false;
+        const bool dernier = arret;
+
+        lock.unlock();
+        if (fichier != -1 || reprendreSegment()) {
+            ecrireBloc(copie, indice);
+        } else if (plein || dernier) {
+            perdus += copie.entete.nbEnregistrements;
+        }
+        if (segmentSuivant) {
+            ++numeroSegment;
+            try {
+                ouvrirSegment();
+            }
+            catch (const std::exception &e) {
+                std::cerr << "Exception attrapée (enregistreur de vol): " << e.what()
+                          << " ; nouvelle tentative à chaque écriture" << std::endl;
+            }
+        }
+        lock.lock();
+    }
+}
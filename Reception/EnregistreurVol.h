@@ -0,0 +1,96 @@
+/**
+ * EnregistreurVol.h est la classe qui enregistre les mesures du vol sur la carte SD
+ *
+ * Les mesures sont des enregistrements binaires de taille fixe, rangés en RAM dans des
+ * blocs d'une page (4096 octets) avec leur somme de contrôle CRC32. Un thread écrit le
+ * bloc courant à sa place dans un fichier segment préalloué, une page alignée à la fois,
+ * dès qu'il est plein et au plus tard INTERVALLE_ECRITURE après la dernière écriture :
+ * une coupure d'alimentation ne fait perdre que le dernier bloc. Les blocs déjà écrits
+ * ne sont jamais réécrits ; enregistrer une mesure ne coûte qu'une copie en mémoire.
+ *
+ * Fichiers : vol_0000.bin, vol_0001.bin... de NB_BLOCS_SEGMENT blocs ; chaque lancement
+ * commence un nouveau segment. Le lecteur lecteur_vol les convertit en CSV.
+ */
+
+#ifndef ENREGISTREURVOL_H
+#define ENREGISTREURVOL_H
+
+#include "TelemetrieAPRS.h"
+#include <chrono>              // Inclut la bibliothèque standard de C++ pour les durées
+#include <condition_variable>  // Inclut la bibliothèque standard de C++ pour les variables de condition
+#include <cstddef>             // Inclut la bibliothèque standard de C pour size_t
+#include <cstdint>             // Inclut la bibliothèque standard de C pour uint32_t
+#include <mutex>               // Inclut la bibliothèque standard de C++ pour les mutex
+#include <string>              // Inclut la bibliothèque standard de C++ pour les chaînes de caractères
+
+// Mesures horodatées
+struct EnregistrementVol
+{
+    uint32_t numero;          // numéro de l'enregistrement depuis le lancement
+    uint32_t reserve;
+    int64_t instant;          // millisecondes depuis l'époque Unix
+    MesuresNacelle mesures;
+};
+
+// En-tête d'un bloc ; le CRC32 couvre tout le bloc, ce champ compté à zéro
+struct EnteteBlocVol
+{
+    uint32_t magique;
+    uint32_t numeroBloc;       // numéro du bloc dans le segment
+    uint16_t nbEnregistrements;
+    uint16_t version;
+    uint32_t crc;
+};
+
+const size_t TAILLE_BLOC_VOL = 4096;
+const size_t ENREGISTREMENTS_PAR_BLOC = (TAILLE_BLOC_VOL - sizeof(EnteteBlocVol)) / sizeof(EnregistrementVol);
+const uint32_t MAGIQUE_BLOC_VOL = 0x4C4F5642;  // "BVOL"
+const uint16_t VERSION_BLOC_VOL = 1;
+
+// Bloc tel qu'il est écrit sur la carte
+struct alignas(TAILLE_BLOC_VOL) BlocVol
+{
+    EnteteBlocVol entete;
+    EnregistrementVol enregistrements[ENREGISTREMENTS_PAR_BLOC];
+};
+
+static_assert(sizeof(EnregistrementVol) == 64, "taille d'enregistrement inattendue");
+static_assert(sizeof(BlocVol) == TAILLE_BLOC_VOL, "un bloc doit occuper exactement une page");
+
+uint32_t crc32Bloc(const BlocVol &bloc);
+
+class EnregistreurVol
+{
+public:
+    static const size_t NB_BLOCS_SEGMENT = 256;  // 1 Mio par segment
+    static const std::chrono::seconds INTERVALLE_ECRITURE;
+
+    EnregistreurVol();
+    ~EnregistreurVol();
+
+    void ouvrir(const std::string &nomRepertoire);
+    void enregistrer(const MesuresNacelle &mesures);
+    void executer();
+    void arreter();
+
+private:
+    void ouvrirSegment();
+    bool reprendreSegment();
+    void ecrireBloc(BlocVol &bloc, size_t indice);
+
+    std::string repertoire;
+    int fichier;
+    unsigned numeroSegment;
+
+    std::mutex mutexBloc;
+    std::condition_variable blocPlein;
+    BlocVol courant;       // bloc en cours de remplissage
+    BlocVol copie;         // bloc en cours d'écriture, hors verrou
+    size_t indiceBloc;     // place du bloc courant dans le segment
+    bool modifie;          // le bloc courant a des mesures non écrites
+    bool arret;            // arrêt demandé : le bloc courant est écrit une dernière fois
+    uint32_t numero;
+    uint32_t perdus;       // enregistrements perdus faute de segment ouvert
+};
+
+#endif // ENREGISTREURVOL_H
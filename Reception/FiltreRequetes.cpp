@@ -0,0 +1,177 @@
+#include "FiltreRequetes.h"
+#include <cctype>
+
+/**
+ * @brief FiltreRequetes::FiltreRequetes
+ * @param requetesParMinute le débit de reconstitution des jetons de chaque source
+ * @param rafale le nombre maximal de jetons d'une source
+ * @param fenetreDoublons la durée pendant laquelle une requête répétée est un doublon (millisecondes)
+ */
+FiltreRequetes::FiltreRequetes(float requetesParMinute, float rafale, uint32_t fenetreDoublons)
+    : jetonsParMilliseconde(requetesParMinute / 60000.0f),
+      rafale(rafale < 1.0f ? 1.0f : rafale),
+      fenetreDoublons(fenetreDoublons),
+      seaux(),
+      recentes(),
+      prochaineRecente(0),
+      totaux()
+{
+}
+
+// Hachage FNV-1a, poursuivi à partir de h
+static uint32_t hacher(uint32_t h, const char *texte, size_t longueur)
+{
+    for (size_t i = 0; i < longueur; ++i) {
+        h ^= static_cast<unsigned char>(texte[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief FiltreRequetes::cleRequete
+ * @return la clé de la requête : source et identifiant APRS, ou source et texte sans identifiant
+ */
+uint32_t FiltreRequetes::cleRequete(const Requete &requete)
+{
+    uint32_t h = hacher(2166136261u, requete.source.debut, requete.source.longueur);
+    if (!requete.identifiant.vide())
+        return hacher(hacher(h, "{", 1), requete.identifiant.debut, requete.identifiant.longueur);
+    return hacher(hacher(h, ":", 1), requete.message.debut, requete.message.longueur);
+}
+
+/**
+ * @brief FiltreRequetes::trouverSeau
+ * @return le seau de la source, rechargé à l'instant donné ; une source nouvelle prend une case
+ *         libre, sinon celle de ses candidates rechargée le moins récemment, avec une rafale pleine
+ */
+FiltreRequetes::Seau *FiltreRequetes::trouverSeau(const char *source, size_t longueur, uint32_t instant)
+{
+    size_t n = 0;
+    while (n < longueur && source[n] != '-')
+        ++n;
+    if (n == 0 || n > LONGUEUR_MAX)
+        return nullptr;
+
+    char indicatif[LONGUEUR_MAX];
+    for (size_t i = 0; i < n; ++i)
+        indicatif[i] = static_cast<char>(std::toupper(static_cast<unsigned char>(source[i])));
+
+    // Seau de la source, sinon case libre, sinon case rechargée le moins récemment
+    const size_t debut = hacher(2166136261u, indicatif, n);
+    Seau *choisi = nullptr;
+    bool trouve = false;
+    for (size_t k = 0; k < NB_CANDIDATES && !trouve; ++k) {
+        Seau &s = seaux[(debut + k) & (NB_SOURCES - 1)];
+        trouve = (s.longueur == n);
+        for (size_t i = 0; trouve && i < n; ++i)
+            trouve = (s.source[i] == indicatif[i]);
+        if (trouve || choisi == nullptr ||
+            (choisi->longueur != 0 && (s.longueur == 0 || static_cast<int32_t>(s.derniereRecharge - choisi->derniereRecharge) < 0)))
+            choisi = &s;
+    }
+    Seau &s = *choisi;
+    if (!trouve) {
+        for (size_t i = 0; i < n; ++i)
+            s.source[i] = indicatif[i];
+        s.longueur = static_cast<uint8_t>(n);
+        s.jetons = rafale;
+    } else {
+        s.jetons += static_cast<float>(instant - s.derniereRecharge) * jetonsParMilliseconde;
+        if (s.jetons > rafale)
+            s.jetons = rafale;
+    }
+    s.derniereRecharge = instant;
+    return &s;
+}
+
+/**
+ * @brief FiltreRequetes::trouverRecente
+ * @return la requête récente de même clé, nullptr s'il n'y en a pas : une requête dont la réponse
+ *         attend d'être émise reste récente, les autres le sont pendant la fenêtre des doublons
+ */
+FiltreRequetes::Recente *FiltreRequetes::trouverRecente(uint32_t cle, uint32_t instant)
+{
+    for (Recente &r : recentes) {
+        if (r.occupee && r.cle == cle && (r.enAttente || instant - r.instant < fenetreDoublons))
+            return &r;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief FiltreRequetes::filtrer décide si une requête valide appelle une réponse
+ * @param requete la requête
+ * @param instant l'instant de réception (millisecondes)
+ * @param cle la clé de la requête, à rendre à reponseEmise() une fois la réponse émise
+ * @return ACCEPTEE si la requête appelle une réponse, sinon la raison de l'écarter
+ */
+FiltreRequetes::Decision FiltreRequetes::filtrer(const Requete &requete, uint32_t instant, uint32_t &cle)
+{
+    cle = cleRequete(requete);
+    if (Recente *r = trouverRecente(cle, instant)) {
+        if (r->enAttente) {
+            ++totaux.fusionnees;
+            return FUSIONNEE;
+        }
+        ++totaux.doublons;
+        return DOUBLON;
+    }
+
+    Seau *seau = trouverSeau(requete.source.debut, requete.source.longueur, instant);
+    if (seau == nullptr || seau->jetons < 1.0f) {
+        ++totaux.limitees;
+        return LIMITEE;
+    }
+    seau->jetons -= 1.0f;
+
+    // La plus ancienne des requêtes mémorisées laisse sa place
+    Recente &r = recentes[prochaineRecente];
+    prochaineRecente = (prochaineRecente + 1) % NB_RECENTES;
+    r.cle = cle;
+    r.instant = instant;
+    r.enAttente = true;
+    r.occupee = true;
+    ++totaux.acceptees;
+    return ACCEPTEE;
+}
+
+/**
+ * @brief FiltreRequetes::reponseEmise ouvre la fenêtre des doublons d'une requête servie
+ * @param cle la clé donnée par filtrer()
+ * @param instant l'instant d'émission de la réponse (millisecondes)
+ */
+void FiltreRequetes::reponseEmise(uint32_t cle, uint32_t instant)
+{
+    for (Recente &r : recentes) {
+        if (r.occupee && r.enAttente && r.cle == cle) {
+            r.enAttente = false;
+            r.instant = instant;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief FiltreRequetes::reponsePerdue oublie une requête acceptée dont la réponse ne sera pas émise
+ *        et rend son jeton à la source : une nouvelle demande n'est ni fusionnée ni écartée
+ * @param requete la requête
+ * @param cle la clé donnée par filtrer()
+ * @param instant l'instant présent (millisecondes)
+ */
+void FiltreRequetes::reponsePerdue(const Requete &requete, uint32_t cle, uint32_t instant)
+{
+    for (Recente &r : recentes) {
+        if (r.occupee && r.enAttente && r.cle == cle) {
+            r.occupee = false;
+            break;
+        }
+    }
+
+    Seau *seau = trouverSeau(requete.source.debut, requete.source.longueur, instant);
+    if (seau != nullptr) {
+        seau->jetons += 1.0f;
+        if (seau->jetons > rafale)
+            seau->jetons = rafale;
+    }
+}
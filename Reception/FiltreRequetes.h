@@ -0,0 +1,82 @@
+/**
+ * FiltreRequetes.h est la classe qui protège le temps d'antenne de la nacelle
+ *
+ * Chaque indicatif source (sans son SSID) dispose d'un seau de jetons : une requête consomme un jeton,
+ * les jetons se reconstituent à débit fixe jusqu'à une rafale maximale. Une requête
+ * identique à une requête récente (même source et même identifiant APRS, ou même texte
+ * sans identifiant) ne coûte pas de jeton : si la réponse à la première attend encore
+ * d'être émise, elle est fusionnée avec elle, sinon elle est ignorée comme doublon.
+ * Tables de taille fixe, sans allocation.
+ */
+
+#ifndef FILTREREQUETES_H
+#define FILTREREQUETES_H
+
+#include "Requete.h"
+#include <cstddef>  // Inclut la bibliothèque standard de C pour size_t
+#include <cstdint>  // Inclut la bibliothèque standard de C pour uint32_t
+
+class FiltreRequetes
+{
+public:
+    static const size_t NB_SOURCES = 32;    // Nombre de seaux (puissance de 2)
+    static const size_t NB_CANDIDATES = 4;  // Cases examinées pour une source
+    static const size_t NB_RECENTES = 32;   // Requêtes mémorisées pour reconnaître les doublons
+    static const size_t LONGUEUR_MAX = 9;   // Longueur maximale d'un indicatif avec SSID
+
+    enum Decision
+    {
+        ACCEPTEE,   // la requête appelle une réponse
+        FUSIONNEE,  // doublon d'une requête dont la réponse attend d'être émise
+        DOUBLON,    // doublon d'une requête déjà servie
+        LIMITEE     // la source a épuisé ses jetons
+    };
+
+    // Requêtes écartées depuis le lancement
+    struct Compteurs
+    {
+        uint32_t acceptees;
+        uint32_t fusionnees;
+        uint32_t doublons;
+        uint32_t limitees;
+    };
+
+    FiltreRequetes(float requetesParMinute, float rafale, uint32_t fenetreDoublons);
+
+    Decision filtrer(const Requete &requete, uint32_t instant, uint32_t &cle);
+    void reponseEmise(uint32_t cle, uint32_t instant);
+    void reponsePerdue(const Requete &requete, uint32_t cle, uint32_t instant);
+    const Compteurs &compteurs() const { return totaux; }
+
+    static uint32_t cleRequete(const Requete &requete);
+
+private:
+    struct Seau
+    {
+        char source[LONGUEUR_MAX];
+        uint8_t longueur;           // 0 : case libre
+        float jetons;
+        uint32_t derniereRecharge;  // instant (millisecondes)
+    };
+
+    struct Recente
+    {
+        uint32_t cle;
+        uint32_t instant;  // instant de la requête, puis de l'émission de sa réponse (millisecondes)
+        bool enAttente;    // sa réponse n'a pas encore été émise
+        bool occupee;
+    };
+
+    Seau *trouverSeau(const char *source, size_t longueur, uint32_t instant);
+    Recente *trouverRecente(uint32_t cle, uint32_t instant);
+
+    float jetonsParMilliseconde;
+    float rafale;
+    uint32_t fenetreDoublons;  // millisecondes
+    Seau seaux[NB_SOURCES];
+    Recente recentes[NB_RECENTES];
+    size_t prochaineRecente;
+    Compteurs totaux;
+};
+
+#endif // FILTREREQUETES_H
@@ -1,7 +1,9 @@
 #include "GestionFile.h"
+#include <algorithm>
 #include <iostream>
 
 GestionFile::GestionFile()
+    : fileId(-1), nonBloquant(false), surAnneau(false), debutReserve(0), nbReserve(0), nbPerdus(0)
 {
 }
 
@@ -23,45 +25,257 @@ void GestionFile::obtenirFileIPC(const int key)
     }
 }
 
+/**
+ * @brief GestionFile::obtenirAnneauPartage remplace la file de messages par un anneau en mémoire partagée
+ * @param nom le nom de la mémoire partagée POSIX ("/ballon_rx")
+ * @param producteur true du côté qui écrit dans l'anneau (et le recrée), false du côté qui le lit
+ * @brief L'interface reste la même ; l'anneau n'a qu'un producteur et un consommateur, et
+ *        ne distingue pas les types de message.
+ */
+void GestionFile::obtenirAnneauPartage(const std::string &nom, bool producteur)
+{
+    anneau.ouvrir(nom, producteur);
+    surAnneau = true;
+}
+
+/**
+ * @brief GestionFile::definirNonBloquant
+ * @param actif true pour que l'écriture dans une file pleine ne bloque pas : le message est
+ *        gardé dans la réserve et renvoyé par reessayerEnvois() ou par l'écriture suivante
+ */
+void GestionFile::definirNonBloquant(bool actif)
+{
+    std::lock_guard<std::mutex> lock(mutexTx);
+    nonBloquant = actif;
+}
+
+/**
+ * @brief GestionFile::envoyer
+ * @param message le message
+ * @param taille la taille du texte envoyé, zéro final compris
+ * @return false si la file est pleine en mode non bloquant
+ */
+bool GestionFile::envoyer(const MessageTX &message, size_t taille)
+{
+    if (surAnneau)
+        return anneau.ecrire(message.text, taille, !nonBloquant);
+    while (msgsnd(fileId, &message, taille, nonBloquant ? IPC_NOWAIT : 0) == -1)
+    {
+        if (errno == EAGAIN)
+            return false;
+        if (errno != EINTR)
+            throw std::runtime_error("Erreur ecriture fileTX !");
+    }
+    return true;
+}
+
+/**
+ * @brief GestionFile::viderReserve envoie les messages de la réserve, dans l'ordre, jusqu'au premier refus
+ * @return le nombre de messages restant dans la réserve
+ */
+size_t GestionFile::viderReserve()
+{
+    while (nbReserve > 0 && envoyer(reserve[debutReserve], taillesReserve[debutReserve]))
+    {
+        debutReserve = (debutReserve + 1) % TAILLE_RESERVE;
+        --nbReserve;
+    }
+    return nbReserve;
+}
+
 /**
  * @brief GestionFile::ecrireDansLaFileIPC
  * @param payload le message à placer dans la fileTX
  * @return true si le message a pu être placé dans la fileTX
- * @brief std::lock_guard verrouille le mutex mutexTx dès sa construction.
+ */
+bool GestionFile::ecrireDansLaFileIPC(const std::string &payload)
+{
+    return ecrireDansLaFileIPC(payload.data(), payload.size());
+}
+
+/**
+ * @brief GestionFile::ecrireDansLaFileIPC
+ * @param texte le message à placer dans la fileTX
+ * @param longueur la longueur du message, tronqué à MAX_MESSAGE_SIZE - 1 caractères
+ * @return true si le message a été placé dans la fileTX ou gardé dans la réserve,
+ *         false s'il a été perdu (réserve pleine)
+ * @brief Seuls le texte et son zéro final sont envoyés, et non les MAX_MESSAGE_SIZE octets
+ *        du tableau. En mode non bloquant, le message passe après ceux de la réserve.
+ *        std::lock_guard verrouille le mutex mutexTx dès sa construction.
  *        Cela signifie que dès que lock est créé, mutexTx est verrouillé.
  *        Lorsque l'objet lock sort de sa portée son destructeur déverrouille le mutexTx.
  *        même si une exception est levée
  */
-bool GestionFile::ecrireDansLaFileIPC(const std::string &payload)
+bool GestionFile::ecrireDansLaFileIPC(const char *texte, size_t longueur)
 {
     std::lock_guard<std::mutex> lock(mutexTx);  // création d'un mutex verrouillé immédiatement
 
-    MessageTX message;
-    message.type = 2;
+    if (longueur > MAX_MESSAGE_SIZE - 1)
+        longueur = MAX_MESSAGE_SIZE - 1;
 
-    std::strcpy(message.text, payload.c_str());
+    if (viderReserve() == 0)
+    {
+        MessageTX message;
+        message.type = 2;
+        std::memcpy(message.text, texte, longueur);
+        message.text[longueur] = '\0';
+        if (envoyer(message, longueur + 1))
+            return true;
+    }
 
-    if (msgsnd(fileId, &message, sizeof(message.text), 0) == -1)
+    if (nbReserve == TAILLE_RESERVE)
     {
-        throw std::runtime_error("Erreur ecriture fileTX !");
+        ++nbPerdus;
         return false;
     }
+    const size_t fin = (debutReserve + nbReserve) % TAILLE_RESERVE;
+    reserve[fin].type = 2;
+    std::memcpy(reserve[fin].text, texte, longueur);
+    reserve[fin].text[longueur] = '\0';
+    taillesReserve[fin] = longueur + 1;
+    ++nbReserve;
     return true;
 }
 
+/**
+ * @brief GestionFile::reessayerEnvois renvoie les messages de la réserve
+ * @return le nombre de messages restant dans la réserve
+ */
+size_t GestionFile::reessayerEnvois()
+{
+    std::lock_guard<std::mutex> lock(mutexTx);
+    return viderReserve();
+}
+
+/**
+ * @brief GestionFile::envoisEnAttente
+ * @return le nombre de messages dans la réserve
+ */
+size_t GestionFile::envoisEnAttente()
+{
+    std::lock_guard<std::mutex> lock(mutexTx);
+    return nbReserve;
+}
+
+/**
+ * @brief GestionFile::envoisPerdus
+ * @return le nombre de messages perdus faute de place dans la réserve
+ */
+unsigned long GestionFile::envoisPerdus()
+{
+    std::lock_guard<std::mutex> lock(mutexTx);
+    return nbPerdus;
+}
+
 /**
  * @brief GestionFile::lireDansLaFileIPC fonction bloquante
  * @param type le type du message
  * @return une structure MessageRX
  */
- MessageRX GestionFile::lireDansLaFileIPC(int type){
+MessageRX GestionFile::lireDansLaFileIPC(int type){
 
     MessageRX message;
-    int ret;
-
-    ret = msgrcv(fileId, &message, sizeof(message) - 4, type, 0);
-    if (ret == -1){
-        throw std::runtime_error("Erreur lecture fileRX !");
-    }   
+    lireLotDansLaFileIPC(type, &message, 1, true);
     return message;
 }
+
+/**
+ * @brief GestionFile::lireLotDansLaFileIPC lit plusieurs messages d'un coup
+ * @param type le type des messages
+ * @param messages le tableau à remplir
+ * @param capacite le nombre de cases du tableau
+ * @param attendre true pour attendre le premier message si la file est vide
+ * @return le nombre de messages lus (0 seulement si attendre vaut false)
+ * @brief Après le premier message, seuls les messages déjà présents dans la file sont lus.
+ *        La taille reçue est celle des données de MessageRX sans le champ type, correcte
+ *        quelle que soit la taille de long (4 octets sur la nacelle, 8 sur un PC).
+ */
+size_t GestionFile::lireLotDansLaFileIPC(int type, MessageRX *messages, size_t capacite, bool attendre){
+
+    size_t nbLus = 0;
+    if (surAnneau){
+        struct {
+            EnteteAnneauRX entete;
+            char text[MAX_MESSAGE_SIZE];
+        } enregistrement;
+        while (nbLus < capacite){
+            const size_t taille = anneau.lire(&enregistrement, sizeof(enregistrement), attendre && nbLus == 0);
+            if (taille == 0)
+                break;
+            if (taille < sizeof(EnteteAnneauRX))
+                continue;
+            const size_t longueur = std::min(taille - sizeof(EnteteAnneauRX), sizeof(enregistrement.text) - 1);
+            messages[nbLus].type = type;
+            std::memcpy(messages[nbLus].text, enregistrement.text, longueur);
+            messages[nbLus].text[longueur] = '\0';
+            messages[nbLus].SNR = enregistrement.entete.SNR;
+            messages[nbLus].RSSI = enregistrement.entete.RSSI;
+            ++nbLus;
+        }
+        return nbLus;
+    }
+    while (nbLus < capacite){
+        const int drapeaux = (attendre && nbLus == 0) ? 0 : IPC_NOWAIT;
+        if (msgrcv(fileId, &messages[nbLus], TAILLE_DONNEES_RX, type, drapeaux) == -1){
+            if (errno == EINTR)
+                continue;
+            if (errno == ENOMSG)
+                break;
+            throw std::runtime_error("Erreur lecture fileRX !");
+        }
+        ++nbLus;
+    }
+    return nbLus;
+}
+
+/**
+ * @brief GestionFile::ecrireMessageRX dépose un message RX, côté pilote LoRa (fonction bloquante)
+ * @param message le message, son texte terminé par un zéro
+ * @brief Dans la file de messages, la structure est envoyée entière (le texte précède SNR et RSSI) ;
+ *        dans un anneau, seuls l'en-tête et le texte le sont.
+ */
+void GestionFile::ecrireMessageRX(const MessageRX &message)
+{
+    if (surAnneau){
+        struct {
+            EnteteAnneauRX entete;
+            char text[MAX_MESSAGE_SIZE];
+        } enregistrement;
+        enregistrement.entete.SNR = message.SNR;
+        enregistrement.entete.RSSI = message.RSSI;
+        const size_t longueur = strnlen(message.text, sizeof(message.text));
+        std::memcpy(enregistrement.text, message.text, longueur);
+        anneau.ecrire(&enregistrement, sizeof(EnteteAnneauRX) + longueur, true);
+        return;
+    }
+    while (msgsnd(fileId, &message, TAILLE_DONNEES_RX, 0) == -1){
+        if (errno != EINTR)
+            throw std::runtime_error("Erreur ecriture fileRX !");
+    }
+}
+
+/**
+ * @brief GestionFile::lireMessageTX lit un message à émettre, côté pilote LoRa
+ * @param message la structure MessageTX à remplir (texte terminé par un zéro)
+ * @param attendre true pour attendre un message si la file est vide
+ * @param type le type des messages lus (négatif : le plus petit type inférieur ou égal à -type
+ *        d'abord, voir msgrcv) ; ignoré sur un anneau
+ * @return false si la file est vide et que attendre vaut false
+ */
+bool GestionFile::lireMessageTX(MessageTX &message, bool attendre, long type)
+{
+    if (surAnneau){
+        const size_t taille = anneau.lire(message.text, sizeof(message.text) - 1, attendre);
+        message.type = 2;
+        message.text[taille] = '\0';
+        return taille > 0;
+    }
+    while (msgrcv(fileId, &message, sizeof(message.text) - 1, type, (attendre ? 0 : IPC_NOWAIT) | MSG_NOERROR) == -1){
+        if (errno == ENOMSG)
+            return false;
+        if (errno != EINTR)
+            throw std::runtime_error("Erreur lecture fileTX !");
+    }
+    message.text[sizeof(message.text) - 1] = '\0';
+    return true;
+}
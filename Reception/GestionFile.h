@@ -11,8 +11,10 @@
 #include <mutex>     // Inclut la bibliothèque standard de C++ pour les mutex
 #include <stdexcept> // Inclut la bibliothèque standard de C++ pour les exceptions
 #include <cstring>   // Inclut la bibliothèque standard de C pour strncpy
+#include <cerrno>    // Inclut la bibliothèque standard de C pour errno (ENOMSG, EAGAIN)
 #include <sys/ipc.h> // Inclut la bibliothèque de système pour IPC_CREAT
 #include <sys/msg.h> // Inclut la bibliothèque de système pour les files de messages
+#include "AnneauPartage.h"
 
 const int MAX_MESSAGE_SIZE = 256;      // Taille maximum du message
 const int MSG_FLAG = 0666 | IPC_CREAT; // Flag de création de la file de messages
@@ -24,7 +26,7 @@ struct MessageTX
     char text[MAX_MESSAGE_SIZE];
 };
 
-// Structure pour le message TX
+// Structure pour le message RX
 struct MessageRX
 {
     long  type;
@@ -33,19 +35,61 @@ struct MessageRX
     int   RSSI;
 };
 
+// Taille des données d'un message RX, sans le champ type (quelle que soit la taille de long)
+const size_t TAILLE_DONNEES_RX = sizeof(MessageRX) - sizeof(long);
+
+// En-tête d'un enregistrement RX dans un anneau partagé, suivi du texte (sans zéro final).
+// Un enregistrement TX ne contient que le texte et son zéro final.
+struct EnteteAnneauRX
+{
+    float   SNR;
+    int32_t RSSI;
+};
+
 class GestionFile
 {
+public:
+    static const size_t TAILLE_RESERVE = 8;  // Messages TX gardés pour un nouvel essai en mode non bloquant
+
 private:
     std::mutex mutexTx;
     int fileId;
+    bool nonBloquant;
+
+    // Transport par anneau en mémoire partagée, à la place de la file de messages
+    AnneauPartage anneau;
+    bool surAnneau;
+
+    // Réserve circulaire des messages TX refusés par une file pleine, dans l'ordre d'envoi
+    MessageTX reserve[TAILLE_RESERVE];
+    size_t taillesReserve[TAILLE_RESERVE];
+    size_t debutReserve;
+    size_t nbReserve;
+    unsigned long nbPerdus;
+
+    bool envoyer(const MessageTX &message, size_t taille);
+    size_t viderReserve();
 
 public:
     GestionFile();
     ~GestionFile();
 
     void obtenirFileIPC(const int key);
+    void obtenirAnneauPartage(const std::string &nom, bool producteur);
+    void definirNonBloquant(bool actif);
+
     bool ecrireDansLaFileIPC(const std::string &payload);
+    bool ecrireDansLaFileIPC(const char *texte, size_t longueur);
+    size_t reessayerEnvois();
+    size_t envoisEnAttente();
+    unsigned long envoisPerdus();
+
     MessageRX lireDansLaFileIPC(int type);
+    size_t lireLotDansLaFileIPC(int type, MessageRX *messages, size_t capacite, bool attendre);
+
+    // Côté pilote LoRa : dépôt des messages reçus et lecture des messages à émettre
+    void ecrireMessageRX(const MessageRX &message);
+    bool lireMessageTX(MessageTX &message, bool attendre, long type = 2);
 };
 
 #endif // GESTIONFILE_H
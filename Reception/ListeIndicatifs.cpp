@@ -0,0 +1,102 @@
+#include "ListeIndicatifs.h"
+#include <cctype>
+
+ListeIndicatifs::ListeIndicatifs()
+    : table(), nombre(0)
+{
+}
+
+/**
+ * @brief ListeIndicatifs::longueurSansSSID
+ * @return la longueur de l'indicatif sans son SSID ("F4KMN-8" -> 5)
+ */
+size_t ListeIndicatifs::longueurSansSSID(const char *indicatif, size_t longueur)
+{
+    size_t n = 0;
+    while (n < longueur && indicatif[n] != '-')
+        ++n;
+    return n;
+}
+
+/**
+ * @brief ListeIndicatifs::hacher hachage FNV-1a, insensible à la casse
+ */
+uint32_t ListeIndicatifs::hacher(const char *indicatif, size_t longueur)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < longueur; ++i) {
+        h ^= static_cast<uint32_t>(std::toupper(static_cast<unsigned char>(indicatif[i])));
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief ListeIndicatifs::ajouter
+ * @param indicatif un indicatif, dont le SSID éventuel est ignoré
+ * @param longueur la longueur de l'indicatif
+ * @return false si l'indicatif est vide, trop long ou si la liste est pleine
+ */
+bool ListeIndicatifs::ajouter(const char *indicatif, size_t longueur)
+{
+    longueur = longueurSansSSID(indicatif, longueur);
+    if (longueur == 0 || longueur > LONGUEUR_MAX)
+        return false;
+    if (contient(indicatif, longueur))
+        return true;
+    if (nombre >= NOMBRE_MAX)
+        return false;
+
+    size_t i = hacher(indicatif, longueur) & (CAPACITE - 1);
+    while (table[i].longueur != 0)
+        i = (i + 1) & (CAPACITE - 1);
+    for (size_t j = 0; j < longueur; ++j)
+        table[i].texte[j] = static_cast<char>(std::toupper(static_cast<unsigned char>(indicatif[j])));
+    table[i].longueur = static_cast<uint8_t>(longueur);
+    ++nombre;
+    return true;
+}
+
+/**
+ * @brief ListeIndicatifs::ajouterListe
+ * @param liste des indicatifs séparés par des virgules ("F4KMN,F4LTZ")
+ * @return false si l'un des indicatifs n'a pas pu être ajouté
+ */
+bool ListeIndicatifs::ajouterListe(const std::string &liste)
+{
+    bool ok = true;
+    size_t debut = 0;
+    while (debut <= liste.size()) {
+        size_t fin = liste.find(',', debut);
+        if (fin == std::string::npos)
+            fin = liste.size();
+        if (fin > debut)
+            ok = ajouter(liste.data() + debut, fin - debut) && ok;
+        debut = fin + 1;
+    }
+    return ok;
+}
+
+/**
+ * @brief ListeIndicatifs::contient
+ * @param indicatif un indicatif, dont le SSID éventuel est ignoré ("F4LTZ-1" -> "F4LTZ")
+ * @param longueur la longueur de l'indicatif
+ * @return true si l'indicatif fait partie de la liste
+ */
+bool ListeIndicatifs::contient(const char *indicatif, size_t longueur) const
+{
+    longueur = longueurSansSSID(indicatif, longueur);
+    if (longueur == 0 || longueur > LONGUEUR_MAX)
+        return false;
+
+    for (size_t i = hacher(indicatif, longueur) & (CAPACITE - 1); table[i].longueur != 0; i = (i + 1) & (CAPACITE - 1)) {
+        if (table[i].longueur != longueur)
+            continue;
+        size_t j = 0;
+        while (j < longueur && table[i].texte[j] == std::toupper(static_cast<unsigned char>(indicatif[j])))
+            ++j;
+        if (j == longueur)
+            return true;
+    }
+    return false;
+}
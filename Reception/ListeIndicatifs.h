@@ -0,0 +1,43 @@
+/**
+ * ListeIndicatifs.h est la classe qui tient la liste des indicatifs autorisés
+ *
+ * Table de hachage à adressage ouvert de taille fixe : la recherche d'un indicatif
+ * se fait en temps constant et sans allocation.
+ */
+
+#ifndef LISTEINDICATIFS_H
+#define LISTEINDICATIFS_H
+
+#include <cstddef>  // Inclut la bibliothèque standard de C pour size_t
+#include <cstdint>  // Inclut la bibliothèque standard de C pour uint32_t
+#include <string>   // Inclut la bibliothèque standard de C++ pour les chaînes de caractères
+
+class ListeIndicatifs
+{
+public:
+    static const size_t CAPACITE = 64;         // Nombre de cases de la table (puissance de 2)
+    static const size_t NOMBRE_MAX = 48;       // Nombre maximal d'indicatifs (table remplie aux 3/4)
+    static const size_t LONGUEUR_MAX = 6;      // Longueur maximale d'un indicatif AX.25 sans SSID
+
+    ListeIndicatifs();
+
+    bool ajouter(const char *indicatif, size_t longueur);
+    bool ajouterListe(const std::string &liste);
+    bool contient(const char *indicatif, size_t longueur) const;
+    size_t taille() const { return nombre; }
+
+private:
+    struct Case
+    {
+        char texte[LONGUEUR_MAX];
+        uint8_t longueur;  // 0 : case libre
+    };
+
+    static size_t longueurSansSSID(const char *indicatif, size_t longueur);
+    static uint32_t hacher(const char *indicatif, size_t longueur);
+
+    Case table[CAPACITE];
+    size_t nombre;
+};
+
+#endif // LISTEINDICATIFS_H
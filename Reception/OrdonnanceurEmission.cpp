@@ -0,0 +1,258 @@
+#include "OrdonnanceurEmission.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+// Une réponse n'est pas commencée si elle peut encore occuper la radio MARGE_TELEMETRIE avant
+// l'instant attendu de la télémétrie ; passé cet instant de TOLERANCE_TELEMETRIE sans télémétrie,
+// les réponses reprennent.
+static const std::chrono::seconds MARGE_TELEMETRIE(1);
+static const std::chrono::seconds TOLERANCE_TELEMETRIE(5);
+
+// Intervalle des nouveaux essais d'envoi quand la file d'émission est pleine
+static const std::chrono::milliseconds ATTENTE_FILE_PLEINE(50);
+
+/**
+ * @brief dureeAntenne calcule la durée d'émission d'une trame LoRa (note Semtech AN1200.13)
+ * @param lora les paramètres de modulation
+ * @param octets la taille de la charge utile
+ * @return la durée du préambule et de la charge utile
+ */
+std::chrono::microseconds dureeAntenne(const ParametresLoRa &lora, size_t octets)
+{
+    const int sf = lora.facteurEtalement;
+    const double symbole = std::ldexp(1.0, sf) / lora.largeurBande;  // secondes
+    const int optimisationDebitBas = (symbole >= 0.016) ? 1 : 0;
+    const double numerateur = 8.0 * octets - 4.0 * sf + 28 + (lora.crc ? 16 : 0) - (lora.enTeteExplicite ? 0 : 20);
+    const double denominateur = 4.0 * (sf - 2 * optimisationDebitBas);
+    const double symbolesCharge = 8 + std::max(std::ceil(numerateur / denominateur) * (lora.rapportCodage + 4), 0.0);
+    const double duree = (lora.preambule + 4.25 + symbolesCharge) * symbole;
+    return std::chrono::microseconds(static_cast<long long>(std::ceil(duree * 1e6)));
+}
+
+/**
+ * @brief OrdonnanceurEmission::OrdonnanceurEmission
+ * @param fileTX la file d'émission, vers le pilote LoRa
+ * @param lora les paramètres de modulation
+ * @param surcoutTrame les octets que le pilote ajoute à chaque trame (en-tête APRS)
+ * @param cycleUtile la part du temps que la radio peut passer à émettre (0.1 pour 10 %)
+ * @param fenetreCycle la fenêtre du cycle utile : le crédit ne dépasse pas cycleUtile * fenetreCycle
+ * @param periodeTelemetrie la période attendue de la télémétrie
+ */
+OrdonnanceurEmission::OrdonnanceurEmission(GestionFile &fileTX, const ParametresLoRa &lora, size_t surcoutTrame,
+                                           float cycleUtile, std::chrono::seconds fenetreCycle,
+                                           std::chrono::seconds periodeTelemetrie)
+    : fileTX(fileTX),
+      lora(lora),
+      surcoutTrame(surcoutTrame),
+      cycleUtile((cycleUtile > 0.0f && cycleUtile < 1.0f) ? cycleUtile : 1.0f),
+      creditMax(Horloge::duration(static_cast<Horloge::rep>(
+          std::chrono::duration_cast<Horloge::duration>(fenetreCycle).count() * static_cast<double>(this->cycleUtile)))),
+      periodeTelemetrie(periodeTelemetrie),
+      arret(false),
+      files(),
+      cles(),
+      nbCles(0),
+      radioLibre(Horloge::now()),
+      derniereRecharge(radioLibre),
+      credit(creditMax),
+      prochaineTelemetrie(),
+      dureeTelemetrie(Horloge::duration::zero()),
+      totaux()
+{
+}
+
+/**
+ * @brief OrdonnanceurEmission::ajouter met une trame en attente d'émission
+ * @param classe la classe de priorité de la trame
+ * @param texte le texte de la trame, tronqué à TAILLE_TRAME - 1 caractères
+ * @param taille la longueur du texte
+ * @param cle la clé de la requête servie, rendue par emises() une fois la trame émise (0 : aucune)
+ * @return false si la file de la classe est pleine
+ */
+bool OrdonnanceurEmission::ajouter(Classe classe, const char *texte, size_t taille, uint32_t cle)
+{
+    std::lock_guard<std::mutex> lock(mutexFiles);
+    File &file = files[classe];
+    if (file.nombre == CAPACITE) {
+        ++totaux.perdues[classe];
+        return false;
+    }
+    Trame &trame = file.trames[(file.debut + file.nombre) % CAPACITE];
+    trame.taille = std::min(taille, TAILLE_TRAME - 1);
+    std::memcpy(trame.texte, texte, trame.taille);
+    trame.texte[trame.taille] = '\0';
+    trame.cle = cle;
+    ++file.nombre;
+    nouvelleTrame.notify_one();
+    return true;
+}
+
+/**
+ * @brief OrdonnanceurEmission::emises
+ * @param resultat le tableau à remplir avec les clés des trames émises depuis l'appel précédent
+ * @param capacite le nombre de cases du tableau
+ * @return le nombre de clés
+ */
+size_t OrdonnanceurEmission::emises(uint32_t *resultat, size_t capacite)
+{
+    std::lock_guard<std::mutex> lock(mutexFiles);
+    const size_t n = std::min(capacite, nbCles);
+    std::copy(cles, cles + n, resultat);
+    std::copy(cles + n, cles + nbCles, cles);
+    nbCles -= n;
+    return n;
+}
+
+/**
+ * @brief OrdonnanceurEmission::compteurs
+ * @return les trames émises et perdues, et le temps d'antenne total, depuis le lancement
+ */
+OrdonnanceurEmission::Compteurs OrdonnanceurEmission::compteurs()
+{
+    std::lock_guard<std::mutex> lock(mutexFiles);
+    return totaux;
+}
+
+/**
+ * @brief OrdonnanceurEmission::duree
+ * @return la durée d'antenne de la trame, en-tête ajouté par le pilote compris
+ */
+OrdonnanceurEmission::Horloge::duration OrdonnanceurEmission::duree(const Trame &trame) const
+{
+    return dureeAntenne(lora, trame.taille + surcoutTrame);
+}
+
+/**
+ * @brief OrdonnanceurEmission::recharger reconstitue le crédit de temps d'antenne au rythme du cycle utile
+ */
+void OrdonnanceurEmission::recharger(Horloge::time_point maintenant)
+{
+    const Horloge::duration ecoule = maintenant - derniereRecharge;
+    credit += Horloge::duration(static_cast<Horloge::rep>(ecoule.count() * static_cast<double>(cycleUtile)));
+    if (credit > creditMax)
+        credit = creditMax;
+    derniereRecharge = maintenant;
+
+    // Télémétrie attendue mais absente : les réponses reprennent, la suivante reste protégée
+    while (prochaineTelemetrie != Horloge::time_point() && maintenant > prochaineTelemetrie + TOLERANCE_TELEMETRIE)
+        prochaineTelemetrie += periodeTelemetrie;
+}
+
+/**
+ * @brief OrdonnanceurEmission::autorisee
+ * @param classe la classe de la trame
+ * @param trame la trame la plus ancienne de sa classe
+ * @param maintenant l'instant présent
+ * @param essai l'instant où elle pourra l'être, si elle ne peut pas être émise maintenant
+ * @return true si la trame peut être confiée à la radio maintenant
+ */
+bool OrdonnanceurEmission::autorisee(Classe classe, const Trame &trame, Horloge::time_point maintenant,
+                                     Horloge::time_point &essai) const
+{
+    if (maintenant < radioLibre) {
+        essai = radioLibre;
+        return false;
+    }
+    if (classe == CRITIQUE || classe == TELEMETRIE)
+        return true;
+
+    // La radio doit être libre à l'approche de la télémétrie attendue
+    const Horloge::duration d = duree(trame);
+    if (prochaineTelemetrie != Horloge::time_point() &&
+        maintenant + d > prochaineTelemetrie - MARGE_TELEMETRIE &&
+        maintenant < prochaineTelemetrie + TOLERANCE_TELEMETRIE) {
+        essai = prochaineTelemetrie + TOLERANCE_TELEMETRIE;
+        return false;
+    }
+
+    // Crédit laissé par la prochaine télémétrie, et pour le bavardage par la moitié basse du crédit
+    Horloge::duration disponible = credit - dureeTelemetrie;
+    if (classe == BAVARDAGE)
+        disponible -= creditMax / 2;
+    if (disponible < d) {
+        essai = maintenant + Horloge::duration(static_cast<Horloge::rep>((d - disponible).count() / static_cast<double>(cycleUtile)));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief OrdonnanceurEmission::arreter demande au thread d'émission de rendre la main
+ * @brief Les trames encore en attente ne sont pas émises.
+ */
+void OrdonnanceurEmission::arreter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutexFiles);
+        arret = true;
+    }
+    nouvelleTrame.notify_one();
+}
+
+/**
+ * @brief OrdonnanceurEmission::executer boucle du thread d'émission, jusqu'à l'appel d'arreter()
+ * @brief La trame choisie est la plus ancienne de la classe la plus prioritaire qui peut être émise.
+ *        Elle est confiée à la file d'émission hors du verrou : ajouter() ne bloque jamais longtemps.
+ */
+void OrdonnanceurEmission::executer()
+{
+    std::unique_lock<std::mutex> lock(mutexFiles);
+    while (!arret) {
+        const Horloge::time_point maintenant = Horloge::now();
+        recharger(maintenant);
+        const bool envoisEnAttente = fileTX.reessayerEnvois() > 0;
+
+        Horloge::time_point reveil = Horloge::time_point::max();
+        int choisie = NB_CLASSES;
+        for (int c = 0; c < NB_CLASSES && choisie == NB_CLASSES; ++c) {
+            const File &file = files[c];
+            Horloge::time_point essai;
+            if (file.nombre == 0)
+                continue;
+            if (autorisee(static_cast<Classe>(c), file.trames[file.debut], maintenant, essai))
+                choisie = c;
+            else
+                reveil = std::min(reveil, essai);
+        }
+
+        if (choisie != NB_CLASSES) {
+            File &file = files[choisie];
+            const Trame trame = file.trames[file.debut];
+            file.debut = (file.debut + 1) % CAPACITE;
+            --file.nombre;
+
+            const Horloge::duration d = duree(trame);
+            credit -= d;
+            radioLibre = maintenant + d;
+            if (choisie == TELEMETRIE) {
+                prochaineTelemetrie = maintenant + periodeTelemetrie;
+                dureeTelemetrie = d;
+            }
+            ++totaux.emises[choisie];
+            totaux.tempsAntenne += std::chrono::duration_cast<std::chrono::milliseconds>(d);
+            if (trame.cle != 0) {
+                // Clés non lues : la plus ancienne laisse sa place
+                if (nbCles == NB_EMISES) {
+                    std::copy(cles + 1, cles + NB_EMISES, cles);
+                    --nbCles;
+                }
+                cles[nbCles++] = trame.cle;
+            }
+
+            lock.unlock();
+            if (!fileTX.ecrireDansLaFileIPC(trame.texte, trame.taille))
+                std::cerr << "Trame perdue, file d'émission pleine (" << fileTX.envoisPerdus() << " au total)" << std::endl;
+            lock.lock();
+            continue;
+        }
+
+        if (envoisEnAttente)
+            reveil = std::min(reveil, maintenant + std::chrono::duration_cast<Horloge::duration>(ATTENTE_FILE_PLEINE));
+        if (reveil == Horloge::time_point::max())
+            nouvelleTrame.wait(lock);
+        else
+            nouvelleTrame.wait_until(lock, reveil);
+    }
+}
@@ -0,0 +1,116 @@
+/**
+ * OrdonnanceurEmission.h est la classe qui confie les trames à émettre à la radio
+ *
+ * Les trames attendent dans une file par classe de priorité (événements critiques,
+ * télémétrie, réponses aux commandes, bavardage) ; un thread les confie à la file
+ * d'émission une à une, la suivante à la fin de la durée d'antenne de la précédente,
+ * calculée à partir des paramètres LoRa. Un crédit de temps d'antenne, reconstitué au
+ * rythme du cycle utile autorisé, borne l'occupation du canal : critique et télémétrie
+ * passent toujours, les réponses n'utilisent que le crédit qui reste une fois réservée
+ * la prochaine télémétrie, le bavardage que la moitié haute du crédit. Le rythme de la
+ * télémétrie est appris de ses émissions : aucune réponse n'est commencée si elle
+ * risque d'occuper la radio à l'instant attendu de la prochaine.
+ */
+
+#ifndef ORDONNANCEUREMISSION_H
+#define ORDONNANCEUREMISSION_H
+
+#include "GestionFile.h"
+#include <chrono>              // Inclut la bibliothèque standard de C++ pour les durées et instants
+#include <condition_variable>  // Inclut la bibliothèque standard de C++ pour les variables de condition
+#include <cstddef>             // Inclut la bibliothèque standard de C pour size_t
+#include <cstdint>             // Inclut la bibliothèque standard de C pour uint32_t
+#include <mutex>               // Inclut la bibliothèque standard de C++ pour les mutex
+
+// Paramètres de modulation LoRa, pour le calcul des durées d'antenne
+struct ParametresLoRa
+{
+    int facteurEtalement;  // SF, de 6 à 12
+    long largeurBande;     // Hz
+    int rapportCodage;     // 1 à 4 pour 4/5 à 4/8
+    int preambule;         // symboles de préambule
+    bool enTeteExplicite;
+    bool crc;
+};
+
+std::chrono::microseconds dureeAntenne(const ParametresLoRa &lora, size_t octets);
+
+class OrdonnanceurEmission
+{
+public:
+    using Horloge = std::chrono::steady_clock;
+
+    enum Classe
+    {
+        CRITIQUE,    // événements critiques : toujours émis en premier, hors budget
+        TELEMETRIE,  // télémétrie périodique : jamais retardée par les réponses
+        REPONSE,     // réponses aux commandes
+        BAVARDAGE,   // réponses de fantaisie et balises facultatives
+        NB_CLASSES
+    };
+
+    static const size_t CAPACITE = 16;     // Trames en attente par classe
+    static const size_t TAILLE_TRAME = 128; // Taille maximale d'une trame, zéro final compris
+    static const size_t NB_EMISES = 32;    // Clés des réponses émises gardées jusqu'à leur lecture
+
+    // Trames émises et écartées depuis le lancement, par classe
+    struct Compteurs
+    {
+        uint32_t emises[NB_CLASSES];
+        uint32_t perdues[NB_CLASSES];  // file de la classe pleine
+        std::chrono::milliseconds tempsAntenne;
+    };
+
+    OrdonnanceurEmission(GestionFile &fileTX, const ParametresLoRa &lora, size_t surcoutTrame,
+                         float cycleUtile, std::chrono::seconds fenetreCycle, std::chrono::seconds periodeTelemetrie);
+
+    bool ajouter(Classe classe, const char *texte, size_t taille, uint32_t cle = 0);
+    size_t emises(uint32_t *cles, size_t capacite);
+    Compteurs compteurs();
+    void executer();
+    void arreter();
+
+private:
+    struct Trame
+    {
+        char texte[TAILLE_TRAME];
+        size_t taille;
+        uint32_t cle;  // clé de la requête servie, 0 s'il n'y en a pas
+    };
+
+    struct File
+    {
+        Trame trames[CAPACITE];
+        size_t debut;
+        size_t nombre;
+    };
+
+    Horloge::duration duree(const Trame &trame) const;
+    void recharger(Horloge::time_point maintenant);
+    bool autorisee(Classe classe, const Trame &trame, Horloge::time_point maintenant,
+                   Horloge::time_point &essai) const;
+
+    GestionFile &fileTX;
+    const ParametresLoRa lora;
+    const size_t surcoutTrame;  // octets ajoutés par le pilote (en-tête APRS)
+    const float cycleUtile;
+    const Horloge::duration creditMax;
+    const Horloge::duration periodeTelemetrie;
+
+    std::mutex mutexFiles;
+    std::condition_variable nouvelleTrame;
+    bool arret;  // arrêt demandé : executer() rend la main
+    File files[NB_CLASSES];
+    uint32_t cles[NB_EMISES];
+    size_t nbCles;
+
+    // État de la radio, tenu par le thread d'émission
+    Horloge::time_point radioLibre;            // fin de la trame en cours d'émission
+    Horloge::time_point derniereRecharge;
+    Horloge::duration credit;                  // temps d'antenne disponible
+    Horloge::time_point prochaineTelemetrie;   // instant attendu, Horloge::time_point() s'il est inconnu
+    Horloge::duration dureeTelemetrie;         // durée de la dernière télémétrie
+    Compteurs totaux;
+};
+
+#endif // ORDONNANCEUREMISSION_H
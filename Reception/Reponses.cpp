@@ -0,0 +1,402 @@
+#include "Reponses.h"
+#include <cmath>
+#include <cstring>
+#include <ctime>
+
+/**
+ * @brief TamponReponse::vider
+ */
+void TamponReponse::vider()
+{
+    longueur = 0;
+    texte[0] = '\0';
+}
+
+/**
+ * @brief TamponReponse::ajouter ajoute une chaîne, tronquée à la place restante
+ * @param chaine la chaîne, de longueur n
+ * @param n le nombre de caractères à ajouter
+ */
+void TamponReponse::ajouter(const char *chaine, size_t n)
+{
+    if (n > MAX_MESSAGE_LENGTH - longueur)
+        n = MAX_MESSAGE_LENGTH - longueur;
+    std::memcpy(texte + longueur, chaine, n);
+    longueur += n;
+    texte[longueur] = '\0';
+}
+
+/**
+ * @brief TamponReponse::ajouter
+ * @param chaine une chaîne terminée par un zéro
+ */
+void TamponReponse::ajouter(const char *chaine)
+{
+    ajouter(chaine, std::strlen(chaine));
+}
+
+/**
+ * @brief TamponReponse::ajouterCaractere
+ * @param c le caractère
+ * @param n le nombre de répétitions
+ */
+void TamponReponse::ajouterCaractere(char c, size_t n)
+{
+    while (n-- > 0 && longueur < MAX_MESSAGE_LENGTH)
+        texte[longueur++] = c;
+    texte[longueur] = '\0';
+}
+
+/**
+ * @brief TamponReponse::ajouterEntier écrit un entier en décimal
+ * @param valeur l'entier
+ */
+void TamponReponse::ajouterEntier(long valeur)
+{
+    char chiffres[24];
+    size_t n = 0;
+    unsigned long reste = (valeur < 0) ? 0UL - static_cast<unsigned long>(valeur) : static_cast<unsigned long>(valeur);
+    do {
+        chiffres[n++] = static_cast<char>('0' + reste % 10);
+        reste /= 10;
+    } while (reste != 0);
+    if (valeur < 0)
+        chiffres[n++] = '-';
+    while (n > 0 && longueur < MAX_MESSAGE_LENGTH)
+        texte[longueur++] = chiffres[--n];
+    texte[longueur] = '\0';
+}
+
+/**
+ * @brief TamponReponse::ajouterDecimal écrit un réel en virgule fixe, arrondi
+ * @param valeur le réel (au-delà de ±1e9, ou non fini, "?" est écrit)
+ * @param decimales le nombre de décimales, de 0 à 6
+ */
+void TamponReponse::ajouterDecimal(float valeur, int decimales)
+{
+    static const long PUISSANCES[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+    if (!std::isfinite(valeur) || std::fabs(valeur) >= 1e9f) {
+        ajouterCaractere('?');
+        return;
+    }
+    if (decimales < 0)
+        decimales = 0;
+    else if (decimales > 6)
+        decimales = 6;
+
+    const long long echelle = PUISSANCES[decimales];
+    const long long entier = std::llround(static_cast<double>(valeur) * echelle);
+    const unsigned long long absolu = (entier < 0) ? 0ULL - static_cast<unsigned long long>(entier)
+                                                   : static_cast<unsigned long long>(entier);
+    if (entier < 0)
+        ajouterCaractere('-');
+    ajouterEntier(static_cast<long>(absolu / echelle));
+    if (decimales > 0) {
+        ajouterCaractere('.');
+        unsigned long long fraction = absolu % echelle;
+        for (long long p = echelle / 10; p > 0; p /= 10) {
+            ajouterCaractere(static_cast<char>('0' + fraction / p));
+            fraction %= p;
+        }
+    }
+}
+
+/**
+ * @brief Alea::suivant
+ * @return le nombre suivant de la suite xorshift32
+ */
+uint32_t Alea::suivant()
+{
+    etat ^= etat << 13;
+    etat ^= etat >> 17;
+    etat ^= etat << 5;
+    return etat;
+}
+
+// Choix d'un texte au hasard dans une table
+template <size_t N>
+static const char *choisir(const char *const (&textes)[N], Alea &alea)
+{
+    return textes[alea.tirer(N)];
+}
+
+// Gestionnaire de réponse d'un code Q : complète la réponse après son en-tête
+typedef void (*Gestionnaire)(const Contexte &contexte, TamponReponse &reponse);
+
+// QSA : force du signal de la requête et sa tendance (moyenne exponentielle des paquets de la source)
+struct ModeleQSA
+{
+    const char *avantRSSI;
+    const char *avantTendanceRSSI;
+    const char *avantSNR;
+    const char *avantTendanceSNR;
+    const char *avantId;
+    const char *fin;
+};
+
+constexpr ModeleQSA REPONSES_QSA[] = {
+    { "QSA RSSI=", " (moy ", ") SNR=", " (moy ", "){", "" },
+    { "QSA RSSI ", "dBm ~", " SNR ", "dB ~", " id:", "" },
+    { "QSA ", "dBm (moy ", ") ", "dB (moy ", ") #", "" }
+};
+
+static void repondreQSA(const Contexte &contexte, TamponReponse &reponse)
+{
+    StatistiquesLien::Bilan bilan;
+    float rssiTendance = static_cast<float>(contexte.message.RSSI);
+    float snrTendance = contexte.message.SNR;
+    if (contexte.statistiques.bilan(contexte.requete.source.debut, contexte.requete.source.longueur, bilan)) {
+        rssiTendance = bilan.rssiEwma;
+        snrTendance = bilan.snrEwma;
+    }
+
+    const ModeleQSA &modele = REPONSES_QSA[contexte.alea.tirer(sizeof(REPONSES_QSA) / sizeof(REPONSES_QSA[0]))];
+    reponse.ajouter(modele.avantRSSI);
+    reponse.ajouterEntier(contexte.message.RSSI);
+    reponse.ajouter(modele.avantTendanceRSSI);
+    reponse.ajouterDecimal(rssiTendance, 0);
+    reponse.ajouter(modele.avantSNR);
+    reponse.ajouterDecimal(contexte.message.SNR, 1);
+    reponse.ajouter(modele.avantTendanceSNR);
+    reponse.ajouterDecimal(snrTendance, 1);
+    reponse.ajouter(modele.avantId);
+    reponse.ajouterEntier(contexte.idMessage);
+    reponse.ajouter(modele.fin);
+}
+
+// QRK : bilan de liaison de la source sur ses derniers paquets (minimum/moyenne/maximum)
+static void repondreQRK(const Contexte &contexte, TamponReponse &reponse)
+{
+    StatistiquesLien::Bilan bilan;
+    if (!contexte.statistiques.bilan(contexte.requete.source.debut, contexte.requete.source.longueur, bilan)) {
+        reponse.ajouter("QRK Aucun paquet de votre station en memoire.");
+        return;
+    }
+    reponse.ajouter("QRK n");
+    reponse.ajouterEntier(static_cast<long>(bilan.nbPaquets));
+    reponse.ajouter(" RSSI ");
+    reponse.ajouterEntier(bilan.rssiMin);
+    reponse.ajouterCaractere('/');
+    reponse.ajouterDecimal(bilan.rssiMoyen, 0);
+    reponse.ajouterCaractere('/');
+    reponse.ajouterEntier(bilan.rssiMax);
+    reponse.ajouter(" SNR ");
+    reponse.ajouterDecimal(bilan.snrMin, 1);
+    reponse.ajouterCaractere('/');
+    reponse.ajouterDecimal(bilan.snrMoyen, 1);
+    reponse.ajouterCaractere('/');
+    reponse.ajouterDecimal(bilan.snrMax, 1);
+}
+
+// QSQ : y a-t-il un médecin à bord ?
+constexpr const char *REPONSES_QSQ[] = {
+    "QSQ Aucun docteur, ici Ohm soigne tous les circuits.",
+    "QSQ Consultation refusee, seule la technique prevaut.",
+    "QSQ Docteur inutile, juste circuits et transistors."
+};
+
+static void repondreQSQ(const Contexte &contexte, TamponReponse &reponse)
+{
+    reponse.ajouter(choisir(REPONSES_QSQ, contexte.alea));
+}
+
+// QRZ : qui m'appelle ?
+constexpr const char *REPONSES_QRZ[] = {
+    "QRZ Si vous appelez, vous connaissez deja mon indic.",
+    "QRZ Demandez-vous vraiment a qui vous parlez ?",
+    "QRZ Curieux: appeler sans savoir qui vous appellez...",
+    "QRZ Paradoxe resolu si vous savez a qui vous parlez.",
+    "QRZ Test d hypnose, oublieriez-vous mon indicatif ?",
+    "QRZ Vous doutez ? Pourtant vous avez bien appele !",
+    "QRZ La reponse: c est vous qui creez la question.",
+    "QRZ Vous appelez mais vous ignorez encore mon nom ?"
+};
+
+static void repondreQRZ(const Contexte &contexte, TamponReponse &reponse)
+{
+    reponse.ajouter(choisir(REPONSES_QRZ, contexte.alea));
+}
+
+// QRX : quand me rappellerez-vous ?
+constexpr const char *REPONSES_QRX[] = {
+    "QRX Rappeler ? Je reponds plus vite qu un photon.",
+    "QRX Cafe quantique fini, rappel inutile, je suis la.",
+    "QRX Attendez que la vitesse lumiere ralentisse ? Non.",
+    "QRX Automate toujours pret, c est vous qui hesitez.",
+    "QRX File attente inexistante : je reponds sans delai.",
+    "QRX Temps relatif, mais ici je reponds instantanement.",
+    "QRX Resistance serie inutile, reponse deja envoyee !",
+    "QRX Inutile de rappeler, ma reponse precede votre appel."
+};
+
+static void repondreQRX(const Contexte &contexte, TamponReponse &reponse)
+{
+    reponse.ajouter(choisir(REPONSES_QRX, contexte.alea));
+}
+
+// QRT : dois-je cesser d'émettre ?
+constexpr const char *REPONSES_QRT[] = {
+    "QRT Arret impossible, mes ondes sont eternelles.",
+    "QRT Jamais arreter, mes signaux traversent l univers.",
+    "QRT Transmission continue, imperturbable et infinie.",
+    "QRT Arreter ? Mes bits voyagent comme les neutrinos.",
+    "QRT Interrompre la science ? Idee digne d un barbare.",
+    "QRT Vous pouvez couper, mais mes ondes restent libres.",
+    "QRT Impossible d arreter : code en execution infinie.",
+    "QRT Arret refuse, je transmets jusqu a la fin des temps."
+};
+
+static void repondreQRT(const Contexte &contexte, TamponReponse &reponse)
+{
+    reponse.ajouter(choisir(REPONSES_QRT, contexte.alea));
+}
+
+// QTR : heure locale
+constexpr const char *REPONSES_QTR[] = {
+    "QTR  Heure locale : ",
+    "QTR  Temps d ondes : ",
+    "QTR  Instantane : "
+};
+
+static void repondreQTR(const Contexte &contexte, TamponReponse &reponse)
+{
+    std::time_t maintenant = std::time(nullptr);
+    std::tm heureLocale;
+    localtime_r(&maintenant, &heureLocale);
+    char heure[16];
+    const size_t n = std::strftime(heure, sizeof(heure), "%H:%M:%S", &heureLocale);
+    reponse.ajouter(choisir(REPONSES_QTR, contexte.alea));
+    reponse.ajouter(heure, n);
+}
+
+// QSL : accusé de réception
+constexpr const char *REPONSES_QSL[] = {
+    "QSL  Message reçu, signal clair et net.",
+    "QSL  Accuse de reception : vos ondes sont parfaitement captees.",
+    "QSL  Communication validee, le spectre est en parfait etat."
+};
+
+static void repondreQSL(const Contexte &contexte, TamponReponse &reponse)
+{
+    reponse.ajouter(choisir(REPONSES_QSL, contexte.alea));
+}
+
+// Table des codes Q gérés : ajouter un code revient à ajouter un gestionnaire et une ligne
+struct Commande
+{
+    uint32_t codeQ;
+    Gestionnaire gestionnaire;
+    bool fantaisie;  // réponse humoristique, émise après les réponses utiles
+};
+
+constexpr Commande COMMANDES[] = {
+    { cleCodeQ("QSA"), repondreQSA, false },
+    { cleCodeQ("QRK"), repondreQRK, false },
+    { cleCodeQ("QSQ"), repondreQSQ, true },
+    { cleCodeQ("QRZ"), repondreQRZ, true },
+    { cleCodeQ("QRX"), repondreQRX, true },
+    { cleCodeQ("QRT"), repondreQRT, true },
+    { cleCodeQ("QTR"), repondreQTR, false },
+    { cleCodeQ("QSL"), repondreQSL, false }
+};
+
+// Recherche de la commande d'un code Q, nullptr si le code n'est pas géré
+static const Commande *trouverCommande(uint32_t codeQ)
+{
+    for (const Commande &commande : COMMANDES) {
+        if (commande.codeQ == codeQ)
+            return &commande;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Indique si la réponse à un code Q est de fantaisie (QSQ, QRZ, QRX, QRT) plutôt qu'utile.
+ * @param codeQ la clé du code Q
+ * @return true pour une réponse de fantaisie
+ */
+bool reponseDeFantaisie(uint32_t codeQ)
+{
+    const Commande *commande = trouverCommande(codeQ);
+    return commande != nullptr && commande->fantaisie;
+}
+
+/**
+ * @brief Indique si une requête appelle une réponse : elle vient d'un indicatif autorisé,
+ *        s'adresse à la nacelle et porte un code Q géré.
+ * @param requete les champs de la trame reçue
+ * @param indicatifNacelle l'indicatif auquel la requête doit s'adresser
+ * @param autorises les indicatifs sources autorisés
+ * @return true si la requête appelle une réponse
+ */
+bool appelleReponse(const Requete &requete, const char *indicatifNacelle, const ListeIndicatifs &autorises)
+{
+    return requete.destinataire.egal(indicatifNacelle) &&
+           autorises.contient(requete.source.debut, requete.source.longueur) &&
+           trouverCommande(requete.codeQ) != nullptr;
+}
+
+/**
+ * @brief Construit la réponse à une requête reçue.
+ * @param requete les champs de la trame reçue
+ * @param message la trame reçue (texte, RSSI et SNR)
+ * @param indicatifNacelle l'indicatif auquel la requête doit s'adresser
+ * @param autorises les indicatifs sources autorisés
+ * @param statistiques les statistiques de liaison, où la trame a déjà été enregistrée
+ * @param idMessage le numéro de la réponse
+ * @param alea le générateur qui choisit parmi les textes de réponse
+ * @param reponse la réponse construite, tronquée à MAX_MESSAGE_LENGTH caractères
+ * @return true si la trame appelle une réponse
+ */
+bool construireReponse(const Requete &requete, const MessageRX &message, const char *indicatifNacelle,
+                       const ListeIndicatifs &autorises, const StatistiquesLien &statistiques,
+                       int idMessage, Alea &alea, TamponReponse &reponse)
+{
+    if (!appelleReponse(requete, indicatifNacelle, autorises))
+        return false;
+    const Gestionnaire gestionnaire = trouverCommande(requete.codeQ)->gestionnaire;
+
+    // En-tête de la réponse : indicatif source sur exactement 9 caractères
+    const size_t longueurSource = (requete.source.longueur < 9) ? requete.source.longueur : 9;
+    reponse.vider();
+    reponse.ajouterCaractere(':');
+    reponse.ajouter(requete.source.debut, longueurSource);
+    reponse.ajouterCaractere(' ', 9 - longueurSource);
+    reponse.ajouterCaractere(':');
+    gestionnaire(Contexte{ requete, message, statistiques, idMessage, alea }, reponse);
+    return true;
+}
+
+/**
+ * @brief Construit la balise de qualité de liaison (statut APRS).
+ * @param statistiques les statistiques de liaison
+ * @param balise la balise, de la forme ">LQ F4LTZ-1 -99/6.1 n12 F4KMN-2 -110/-3.0 n4" :
+ *        pour chaque station, de la plus récemment entendue à la plus ancienne, moyennes
+ *        exponentielles du RSSI et du SNR et nombre de paquets, tant qu'elles tiennent entières
+ * @return false si aucune station n'a été entendue
+ */
+bool construireBalise(const StatistiquesLien &statistiques, TamponReponse &balise)
+{
+    StatistiquesLien::Bilan bilans[6];
+    const size_t nb = statistiques.plusRecentes(bilans, sizeof(bilans) / sizeof(bilans[0]));
+    if (nb == 0)
+        return false;
+
+    balise.vider();
+    balise.ajouter(">LQ");
+    for (size_t i = 0; i < nb; ++i) {
+        TamponReponse station;
+        station.ajouterCaractere(' ');
+        station.ajouter(bilans[i].source);
+        station.ajouterCaractere(' ');
+        station.ajouterDecimal(bilans[i].rssiEwma, 0);
+        station.ajouterCaractere('/');
+        station.ajouterDecimal(bilans[i].snrEwma, 1);
+        station.ajouter(" n");
+        station.ajouterEntier(static_cast<long>(bilans[i].nbPaquets));
+        if (station.taille() > balise.reste())
+            break;
+        balise.ajouter(station.c_str(), station.taille());
+    }
+    return true;
+}
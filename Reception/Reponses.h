@@ -0,0 +1,74 @@
+/**
+ * Reponses.h construit les réponses de la nacelle aux codes Q
+ *
+ * Aucune allocation : les textes des réponses sont des tables constantes et la réponse
+ * est formatée dans un tampon de taille fixe.
+ */
+
+#ifndef REPONSES_H
+#define REPONSES_H
+
+#include "GestionFile.h"
+#include "ListeIndicatifs.h"
+#include "Requete.h"
+#include "StatistiquesLien.h"
+#include <cstddef>  // Inclut la bibliothèque standard de C pour size_t
+#include <cstdint>  // Inclut la bibliothèque standard de C pour uint32_t
+
+const size_t MAX_MESSAGE_LENGTH = 63;  // Longueur maximale d'une réponse
+
+// Texte d'une réponse, tronqué à MAX_MESSAGE_LENGTH caractères
+class TamponReponse
+{
+public:
+    static const size_t CAPACITE = 64;  // MAX_MESSAGE_LENGTH caractères et le zéro final
+
+    TamponReponse() : longueur(0) { texte[0] = '\0'; }
+
+    void vider();
+    void ajouter(const char *chaine);
+    void ajouter(const char *chaine, size_t n);
+    void ajouterCaractere(char c, size_t n = 1);
+    void ajouterEntier(long valeur);
+    void ajouterDecimal(float valeur, int decimales);
+
+    const char *c_str() const { return texte; }
+    size_t taille() const { return longueur; }
+    size_t reste() const { return MAX_MESSAGE_LENGTH - longueur; }
+
+private:
+    char texte[CAPACITE];
+    size_t longueur;
+};
+
+// Générateur pseudo-aléatoire xorshift32, pour varier les réponses
+class Alea
+{
+public:
+    explicit Alea(uint32_t graine) : etat(graine != 0 ? graine : 0x9E3779B9u) {}
+
+    uint32_t suivant();
+    size_t tirer(size_t n) { return suivant() % n; }
+
+private:
+    uint32_t etat;
+};
+
+// Données accessibles aux gestionnaires de réponse
+struct Contexte
+{
+    const Requete &requete;
+    const MessageRX &message;
+    const StatistiquesLien &statistiques;
+    int idMessage;
+    Alea &alea;
+};
+
+bool appelleReponse(const Requete &requete, const char *indicatifNacelle, const ListeIndicatifs &autorises);
+bool construireReponse(const Requete &requete, const MessageRX &message, const char *indicatifNacelle,
+                       const ListeIndicatifs &autorises, const StatistiquesLien &statistiques,
+                       int idMessage, Alea &alea, TamponReponse &reponse);
+bool reponseDeFantaisie(uint32_t codeQ);
+bool construireBalise(const StatistiquesLien &statistiques, TamponReponse &balise);
+
+#endif // REPONSES_H
@@ -0,0 +1,90 @@
+#include "Requete.h"
+#include <cstring>
+
+/**
+ * @brief Champ::egal
+ * @param texte une chaîne terminée par un zéro
+ * @return true si le champ contient exactement cette chaîne
+ */
+bool Champ::egal(const char *texte) const
+{
+    return std::strlen(texte) == longueur && std::memcmp(debut, texte, longueur) == 0;
+}
+
+static bool estAlphanumerique(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+static bool estMajuscule(char c)
+{
+    return c >= 'A' && c <= 'Z';
+}
+
+/**
+ * @brief analyserTrame découpe la trame en une seule passe
+ * @param texte le texte de la trame, de la forme "<..SOURCE>DEST,CHEMIN::DESTINATAIRE:message{id"
+ * @param longueur la longueur du texte
+ * @param requete les champs trouvés, qui désignent des portions de texte
+ * @return true si la trame contient une source et un message APRS
+ *
+ * La source est lue entre '<' et '>' (les octets d'en-tête LoRa non alphanumériques
+ * qui suivent '<' sont ignorés), le destinataire entre "::" et le ':' suivant. Le code Q
+ * retenu est le premier 'Q' suivi de deux majuscules et d'un '?' dans le texte du message.
+ */
+bool analyserTrame(const char *texte, size_t longueur, Requete &requete)
+{
+    requete = Requete();
+    size_t i = 0;
+
+    // Indicatif source
+    while (i < longueur && texte[i] != '<')
+        ++i;
+    ++i;
+    while (i < longueur && texte[i] != '>' && !estAlphanumerique(texte[i]))
+        ++i;
+    size_t debut = i;
+    while (i < longueur && texte[i] != '>')
+        ++i;
+    if (i >= longueur || i == debut)
+        return false;
+    requete.source.debut = texte + debut;
+    requete.source.longueur = i - debut;
+
+    // Destinataire, après le chemin
+    while (i + 1 < longueur && !(texte[i] == ':' && texte[i + 1] == ':'))
+        ++i;
+    i += 2;
+    debut = i;
+    while (i < longueur && texte[i] != ':')
+        ++i;
+    if (i >= longueur)
+        return false;
+    size_t fin = i;
+    while (fin > debut && texte[fin - 1] == ' ')
+        --fin;
+    requete.destinataire.debut = texte + debut;
+    requete.destinataire.longueur = fin - debut;
+
+    // Message et code Q
+    debut = ++i;
+    while (i < longueur && texte[i] != '{') {
+        if (requete.codeQ == 0 && texte[i] == 'Q' && i + 3 < longueur &&
+            estMajuscule(texte[i + 1]) && estMajuscule(texte[i + 2]) && texte[i + 3] == '?') {
+            requete.codeQ = cleCodeQ(texte + i);
+        }
+        ++i;
+    }
+    requete.message.debut = texte + debut;
+    requete.message.longueur = i - debut;
+
+    // Identifiant, jusqu'à un éventuel accusé "}xx"
+    if (i < longueur) {
+        debut = ++i;
+        while (i < longueur && texte[i] != '}')
+            ++i;
+        requete.identifiant.debut = texte + debut;
+        requete.identifiant.longueur = i - debut;
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+/**
+ * Requete.h découpe une trame APRS reçue en ses champs utiles à la nacelle
+ *
+ * La trame est parcourue une seule fois ; les champs désignent des portions du texte
+ * reçu, sans copie.
+ */
+
+#ifndef REQUETE_H
+#define REQUETE_H
+
+#include <cstddef>  // Inclut la bibliothèque standard de C pour size_t
+#include <cstdint>  // Inclut la bibliothèque standard de C pour uint32_t
+
+// Portion du texte de la trame
+struct Champ
+{
+    const char *debut = nullptr;
+    size_t longueur = 0;
+
+    bool vide() const { return longueur == 0; }
+    bool egal(const char *texte) const;
+};
+
+// Clé entière d'un code Q ("QSA" -> 'Q' << 16 | 'S' << 8 | 'A')
+constexpr uint32_t cleCodeQ(const char *code)
+{
+    return (static_cast<uint32_t>(static_cast<unsigned char>(code[0])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(code[1])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(code[2]));
+}
+
+// Champs d'une requête reçue
+struct Requete
+{
+    Champ source;        // indicatif source, avec son éventuel SSID
+    Champ destinataire;  // destinataire du message APRS, sans les espaces de bourrage
+    Champ message;       // texte du message APRS, sans son identifiant
+    Champ identifiant;   // identifiant du message APRS (après '{'), vide s'il est absent
+    uint32_t codeQ = 0;  // clé du premier code Q suivi de '?' dans le message, 0 s'il n'y en a pas
+};
+
+bool analyserTrame(const char *texte, size_t longueur, Requete &requete);
+
+#endif // REQUETE_H
@@ -0,0 +1,177 @@
+#include "StatistiquesLien.h"
+#include <cmath>
+#include <cstring>
+
+// Poids d'un nouveau paquet dans les moyennes exponentielles
+static const float ALPHA_EWMA = 0.125f;
+
+StatistiquesLien::StatistiquesLien()
+    : table()
+{
+}
+
+/**
+ * @brief StatistiquesLien::hacher hachage FNV-1a de l'indicatif
+ */
+uint32_t StatistiquesLien::hacher(const char *source, size_t longueur)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < longueur; ++i) {
+        h ^= static_cast<unsigned char>(source[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief StatistiquesLien::trouver
+ * @return la case de la source, nullptr si la source est inconnue
+ */
+const StatistiquesLien::Case *StatistiquesLien::trouver(const char *source, size_t longueur) const
+{
+    if (longueur == 0 || longueur > LONGUEUR_MAX)
+        return nullptr;
+    const size_t debut = hacher(source, longueur);
+    for (size_t k = 0; k < NB_CANDIDATES; ++k) {
+        const Case &c = table[(debut + k) & (NB_SOURCES - 1)];
+        if (c.longueur == longueur && std::memcmp(c.source, source, longueur) == 0)
+            return &c;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief StatistiquesLien::enregistrer prend en compte un paquet reçu
+ * @param source l'indicatif de la source, avec son SSID
+ * @param longueur la longueur de l'indicatif
+ * @param rssi le RSSI du paquet (dBm)
+ * @param snr le SNR du paquet (dB)
+ * @param instant l'instant de réception (secondes)
+ */
+void StatistiquesLien::enregistrer(const char *source, size_t longueur, int rssi, float snr, uint32_t instant)
+{
+    if (longueur == 0 || longueur > LONGUEUR_MAX || !std::isfinite(snr))
+        return;
+    std::lock_guard<std::mutex> lock(mutexTable);
+
+    // Case de la source, sinon case libre, sinon case la moins récemment entendue
+    const size_t debut = hacher(source, longueur);
+    Case *choisie = nullptr;
+    for (size_t k = 0; k < NB_CANDIDATES; ++k) {
+        Case &c = table[(debut + k) & (NB_SOURCES - 1)];
+        if (c.longueur == longueur && std::memcmp(c.source, source, longueur) == 0) {
+            choisie = &c;
+            break;
+        }
+        if (choisie == nullptr || (choisie->longueur != 0 && (c.longueur == 0 || c.dernierPaquet < choisie->dernierPaquet)))
+            choisie = &c;
+    }
+    Case &c = *choisie;
+    if (c.longueur != longueur || std::memcmp(c.source, source, longueur) != 0) {
+        c = Case();
+        std::memcpy(c.source, source, longueur);
+        c.longueur = static_cast<uint8_t>(longueur);
+    }
+
+    const int16_t r = static_cast<int16_t>(rssi < -32768 ? -32768 : (rssi > 32767 ? 32767 : rssi));
+    const float snrBorne = snr < -3000.0f ? -3000.0f : (snr > 3000.0f ? 3000.0f : snr);
+    const int16_t s = static_cast<int16_t>(std::lround(snrBorne * 10.0f));
+    if (c.nbEchantillons == FENETRE) {
+        c.sommeRssi -= c.rssi[c.prochain];
+        c.sommeSnr -= c.snr[c.prochain];
+    } else {
+        ++c.nbEchantillons;
+    }
+    c.rssi[c.prochain] = r;
+    c.snr[c.prochain] = s;
+    c.sommeRssi += r;
+    c.sommeSnr += s;
+    c.prochain = static_cast<uint8_t>((c.prochain + 1) % FENETRE);
+
+    if (c.nbPaquets == 0) {
+        c.rssiEwma = r;
+        c.snrEwma = s / 10.0f;
+    } else {
+        c.rssiEwma += ALPHA_EWMA * (r - c.rssiEwma);
+        c.snrEwma += ALPHA_EWMA * (s / 10.0f - c.snrEwma);
+    }
+    ++c.nbPaquets;
+    c.dernierPaquet = instant;
+}
+
+/**
+ * @brief StatistiquesLien::remplir calcule le bilan d'une case (fenêtre de FENETRE paquets au plus)
+ */
+void StatistiquesLien::remplir(const Case &c, Bilan &resultat)
+{
+    std::memcpy(resultat.source, c.source, c.longueur);
+    resultat.source[c.longueur] = '\0';
+    resultat.nbPaquets = c.nbPaquets;
+    resultat.dernierPaquet = c.dernierPaquet;
+    resultat.nbEchantillons = c.nbEchantillons;
+
+    const size_t dernier = (c.prochain + FENETRE - 1) % FENETRE;
+    int rssiMin = c.rssi[dernier], rssiMax = c.rssi[dernier];
+    int snrMin = c.snr[dernier], snrMax = c.snr[dernier];
+    for (size_t i = 0; i < c.nbEchantillons; ++i) {
+        if (c.rssi[i] < rssiMin) rssiMin = c.rssi[i];
+        if (c.rssi[i] > rssiMax) rssiMax = c.rssi[i];
+        if (c.snr[i] < snrMin) snrMin = c.snr[i];
+        if (c.snr[i] > snrMax) snrMax = c.snr[i];
+    }
+    resultat.rssiDernier = c.rssi[dernier];
+    resultat.rssiMin = rssiMin;
+    resultat.rssiMax = rssiMax;
+    resultat.rssiMoyen = static_cast<float>(c.sommeRssi) / c.nbEchantillons;
+    resultat.rssiEwma = c.rssiEwma;
+    resultat.snrDernier = c.snr[dernier] / 10.0f;
+    resultat.snrMin = snrMin / 10.0f;
+    resultat.snrMax = snrMax / 10.0f;
+    resultat.snrMoyen = static_cast<float>(c.sommeSnr) / c.nbEchantillons / 10.0f;
+    resultat.snrEwma = c.snrEwma;
+}
+
+/**
+ * @brief StatistiquesLien::bilan
+ * @param source l'indicatif de la source, avec son SSID
+ * @param longueur la longueur de l'indicatif
+ * @param resultat les statistiques de la source
+ * @return false si la source n'a jamais été entendue (ou a été remplacée)
+ */
+bool StatistiquesLien::bilan(const char *source, size_t longueur, Bilan &resultat) const
+{
+    std::lock_guard<std::mutex> lock(mutexTable);
+    const Case *c = trouver(source, longueur);
+    if (c == nullptr)
+        return false;
+    remplir(*c, resultat);
+    return true;
+}
+
+/**
+ * @brief StatistiquesLien::plusRecentes
+ * @param resultats le tableau à remplir
+ * @param capacite le nombre de cases du tableau
+ * @return le nombre de sources, les plus récemment entendues en premier
+ */
+size_t StatistiquesLien::plusRecentes(Bilan *resultats, size_t capacite) const
+{
+    std::lock_guard<std::mutex> lock(mutexTable);
+    const Case *choisies[NB_SOURCES];
+    size_t nb = 0;
+    for (const Case &c : table) {
+        if (c.longueur == 0)
+            continue;
+        size_t i = nb < capacite ? nb++ : capacite;
+        while (i > 0 && choisies[i - 1]->dernierPaquet < c.dernierPaquet) {
+            if (i < capacite)
+                choisies[i] = choisies[i - 1];
+            --i;
+        }
+        if (i < capacite)
+            choisies[i] = &c;
+    }
+    for (size_t i = 0; i < nb; ++i)
+        remplir(*choisies[i], resultats[i]);
+    return nb;
+}
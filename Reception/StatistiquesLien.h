@@ -0,0 +1,70 @@
+/**
+ * StatistiquesLien.h est la classe qui tient les statistiques de liaison par station source
+ *
+ * Table de taille fixe, sans allocation : pour chaque source, une fenêtre glissante des
+ * derniers RSSI et SNR (minimum, maximum, moyenne), leurs moyennes exponentielles, le
+ * nombre de paquets et l'instant du dernier paquet. Enregistrer un paquet coûte un temps
+ * constant ; une source nouvelle remplace, si besoin, la moins récemment entendue de
+ * ses cases candidates.
+ */
+
+#ifndef STATISTIQUESLIEN_H
+#define STATISTIQUESLIEN_H
+
+#include <cstddef>  // Inclut la bibliothèque standard de C pour size_t
+#include <cstdint>  // Inclut la bibliothèque standard de C pour uint32_t
+#include <mutex>    // Inclut la bibliothèque standard de C++ pour les mutex
+
+class StatistiquesLien
+{
+public:
+    static const size_t NB_SOURCES = 32;      // Nombre de cases de la table (puissance de 2)
+    static const size_t NB_CANDIDATES = 4;    // Cases examinées pour une source
+    static const size_t FENETRE = 16;         // Nombre de paquets de la fenêtre glissante
+    static const size_t LONGUEUR_MAX = 9;     // Longueur maximale d'un indicatif avec SSID
+
+    // Statistiques d'une source
+    struct Bilan
+    {
+        char source[LONGUEUR_MAX + 1];
+        uint32_t nbPaquets;      // Paquets reçus depuis la première réception
+        uint32_t dernierPaquet;  // Instant du dernier paquet (secondes)
+        size_t nbEchantillons;   // Paquets dans la fenêtre glissante
+        int rssiDernier, rssiMin, rssiMax;
+        float rssiMoyen, rssiEwma;
+        float snrDernier, snrMin, snrMax;
+        float snrMoyen, snrEwma;
+    };
+
+    StatistiquesLien();
+
+    void enregistrer(const char *source, size_t longueur, int rssi, float snr, uint32_t instant);
+    bool bilan(const char *source, size_t longueur, Bilan &resultat) const;
+    size_t plusRecentes(Bilan *resultats, size_t capacite) const;
+
+private:
+    struct Case
+    {
+        char source[LONGUEUR_MAX];
+        uint8_t longueur;         // 0 : case libre
+        uint32_t nbPaquets;
+        uint32_t dernierPaquet;
+        int16_t rssi[FENETRE];
+        int16_t snr[FENETRE];     // SNR en dixièmes de dB
+        uint8_t prochain;         // Case de la fenêtre à remplacer
+        uint8_t nbEchantillons;
+        int32_t sommeRssi;
+        int32_t sommeSnr;
+        float rssiEwma;
+        float snrEwma;
+    };
+
+    static uint32_t hacher(const char *source, size_t longueur);
+    const Case *trouver(const char *source, size_t longueur) const;
+    static void remplir(const Case &c, Bilan &resultat);
+
+    mutable std::mutex mutexTable;
+    Case table[NB_SOURCES];
+};
+
+#endif // STATISTIQUESLIEN_H
@@ -0,0 +1,122 @@
+#include "TelemetrieAPRS.h"
+#include <cmath>
+
+// Valeur maximale sur deux caractères base91 (91 * 91 - 1)
+static const uint32_t MAX_BASE91_2 = 8280;
+
+static const double METRES_PAR_PIED = 0.3048;
+
+// Symbole APRS de la nacelle : ballon ('O', table primaire)
+static const char TABLE_SYMBOLE = '/';
+static const char CODE_SYMBOLE = 'O';
+
+// Octet de type de compression : position GPS courante (bit 5), phrase GGA, donc altitude dans
+// "cs" (bits 3-4 = 10), origine logicielle (bits 0-2 = 010)
+static const char TYPE_COMPRESSION = static_cast<char>(33 + 0x32);
+
+/**
+ * @brief encoderBase91 écrit une valeur sur n caractères base91, poids fort en premier
+ */
+static void encoderBase91(char *sortie, uint32_t valeur, size_t n)
+{
+    for (size_t i = n; i > 0; --i) {
+        sortie[i - 1] = static_cast<char>(33 + valeur % 91);
+        valeur /= 91;
+    }
+}
+
+/**
+ * @brief borner arrondit une valeur à l'entier le plus proche, borné à [0, maximum]
+ */
+static uint32_t borner(double valeur, uint32_t maximum)
+{
+    if (!std::isfinite(valeur) || valeur <= 0.0)
+        return 0;
+    if (valeur >= maximum)
+        return maximum;
+    return static_cast<uint32_t>(std::lround(valeur));
+}
+
+/**
+ * @brief encoderPositionCompressee écrit une position compressée "/YYYYXXXX$csT" avec son altitude
+ * @param sortie le tampon, d'au moins TAILLE_POSITION_COMPRESSEE caractères (sans zéro final)
+ * @param latitude la latitude (degrés)
+ * @param longitude la longitude (degrés)
+ * @param altitude l'altitude (mètres), au moins 1 pied
+ * @param table la table de symboles
+ * @param symbole le code du symbole
+ * @return le nombre de caractères écrits
+ */
+size_t encoderPositionCompressee(char *sortie, double latitude, double longitude, double altitude,
+                                 char table, char symbole)
+{
+    sortie[0] = table;
+    encoderBase91(sortie + 1, borner(380926.0 * (90.0 - latitude), 380926u * 180u), 4);
+    encoderBase91(sortie + 5, borner(190463.0 * (180.0 + longitude), 190463u * 360u), 4);
+    sortie[9] = symbole;
+
+    // Altitude en pieds = 1.002 ^ cs
+    const double pieds = altitude / METRES_PAR_PIED;
+    const uint32_t cs = (pieds > 1.0) ? borner(std::log(pieds) / std::log(1.002), MAX_BASE91_2) : 0;
+    encoderBase91(sortie + 10, cs, 2);
+    sortie[12] = TYPE_COMPRESSION;
+    return TAILLE_POSITION_COMPRESSEE;
+}
+
+/**
+ * @brief encoderTelemetrieCompressee écrit l'extension de télémétrie compressée "|ss11...dd|"
+ * @param sortie le tampon, d'au moins 4 + 2 * (nbVoies + 1) caractères (sans zéro final)
+ * @param sequence le numéro de séquence, modulo 8281
+ * @param voies les valeurs des voies analogiques, bornées à 8280
+ * @param nbVoies le nombre de voies, de 1 à 5
+ * @param bits les huit bits numériques, ou -1 pour ne pas les transmettre (alors 5 voies au plus)
+ * @return le nombre de caractères écrits
+ */
+size_t encoderTelemetrieCompressee(char *sortie, uint32_t sequence, const uint32_t *voies, size_t nbVoies,
+                                   int bits)
+{
+    if (nbVoies > 5)
+        nbVoies = 5;
+    size_t n = 0;
+    sortie[n++] = '|';
+    encoderBase91(sortie + n, sequence % (MAX_BASE91_2 + 1), 2);
+    n += 2;
+    for (size_t i = 0; i < nbVoies; ++i, n += 2)
+        encoderBase91(sortie + n, voies[i] > MAX_BASE91_2 ? MAX_BASE91_2 : voies[i], 2);
+    if (bits >= 0) {
+        encoderBase91(sortie + n, static_cast<uint32_t>(bits & 0xFF), 2);
+        n += 2;
+    }
+    sortie[n++] = '|';
+    return n;
+}
+
+/**
+ * @brief construireTrameTelemetrie construit la trame de télémétrie de la nacelle
+ * @param mesures les mesures des capteurs
+ * @param sequence le numéro de séquence de la trame
+ * @param trame le tampon de la trame, terminée par un zéro
+ * @param capacite la taille du tampon, au moins TAILLE_TRAME_TELEMETRIE + 1
+ * @return la longueur de la trame, 0 si le tampon est trop petit
+ */
+size_t construireTrameTelemetrie(const MesuresNacelle &mesures, uint32_t sequence, char *trame, size_t capacite)
+{
+    if (capacite < TAILLE_TRAME_TELEMETRIE + 1)
+        return 0;
+
+    const uint32_t voies[5] = {
+        borner((mesures.temperature + 80.0) * 50.0, MAX_BASE91_2),
+        borner(mesures.pression * 7.5, MAX_BASE91_2),
+        borner((mesures.acceleration[0] + 16.0) * 256.0, MAX_BASE91_2),
+        borner((mesures.acceleration[1] + 16.0) * 256.0, MAX_BASE91_2),
+        borner((mesures.acceleration[2] + 16.0) * 256.0, MAX_BASE91_2)
+    };
+
+    size_t n = 0;
+    trame[n++] = '!';
+    n += encoderPositionCompressee(trame + n, mesures.latitude, mesures.longitude, mesures.altitude,
+                                   TABLE_SYMBOLE, CODE_SYMBOLE);
+    n += encoderTelemetrieCompressee(trame + n, sequence, voies, 5, static_cast<int>(borner(mesures.humidite, 100)));
+    trame[n] = '\0';
+    return n;
+}
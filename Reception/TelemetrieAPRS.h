@@ -0,0 +1,45 @@
+/**
+ * TelemetrieAPRS.h construit la trame de télémétrie de la nacelle en APRS compressé
+ *
+ * Position compressée en base91 (13 caractères, altitude comprise) et extension de
+ * télémétrie compressée "|ss1122334455dd|" : séquence, cinq voies analogiques de 0 à
+ * 8280 et huit bits numériques, deux caractères base91 chacun. La trame complète tient
+ * en 30 caractères, contre une quarantaine pour la position et les champs météo ASCII
+ * ("t078h31b10148"), et transporte en plus les accélérations.
+ *
+ * Voies de la nacelle (à garder identiques au décodeur de ServeurBallon, aprsparser.cpp) :
+ *   a1 température  (v / 50 - 80 °C)
+ *   a2 pression     (v / 7.5 hPa)
+ *   a3 à a5 accélérations x, y, z  (v / 256 - 16 g)
+ *   bits numériques : humidité relative (0 à 100 %)
+ */
+
+#ifndef TELEMETRIEAPRS_H
+#define TELEMETRIEAPRS_H
+
+#include <cstddef>  // Inclut la bibliothèque standard de C pour size_t
+#include <cstdint>  // Inclut la bibliothèque standard de C pour uint32_t
+
+// Mesures déposées par le programme des capteurs dans la file de la nacelle
+struct MesuresNacelle
+{
+    double latitude;     // degrés, positive au nord
+    double longitude;    // degrés, positive à l'est
+    float altitude;      // mètres
+    float temperature;   // °C
+    float pression;      // hPa
+    float humidite;      // %
+    float acceleration[3];  // g, axes x, y, z
+};
+
+const size_t TAILLE_POSITION_COMPRESSEE = 13;
+const size_t TAILLE_TELEMETRIE_COMPRESSEE = 16;
+const size_t TAILLE_TRAME_TELEMETRIE = 1 + TAILLE_POSITION_COMPRESSEE + TAILLE_TELEMETRIE_COMPRESSEE;
+
+size_t encoderPositionCompressee(char *sortie, double latitude, double longitude, double altitude,
+                                 char table, char symbole);
+size_t encoderTelemetrieCompressee(char *sortie, uint32_t sequence, const uint32_t *voies, size_t nbVoies,
+                                   int bits);
+size_t construireTrameTelemetrie(const MesuresNacelle &mesures, uint32_t sequence, char *trame, size_t capacite);
+
+#endif // TELEMETRIEAPRS_H
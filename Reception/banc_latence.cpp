@@ -0,0 +1,86 @@
+/**
+ * banc_latence.cpp mesure, sur l'hôte, la latence des réponses du programme reception
+ *
+ * Le banc joue le rôle du pilote LoRa : il dépose des rafales de trames dans la file de
+ * réception (clé 5678), dont une partie seulement s'adresse à la nacelle, puis relève
+ * dans la file d'émission (clé 5679) l'instant de chaque réponse. Les réponses arrivant
+ * dans l'ordre des requêtes, la i-ème réponse correspond à la i-ème requête valide.
+ *
+ * Utilisation : lancer ./reception, puis ./banc_latence [rafales] [trames par rafale] [pas]
+ * (une trame sur "pas" est une requête valide, les autres visent d'autres stations).
+ * Avec -m en premier argument, les anneaux en mémoire partagée remplacent les files
+ * (lancer alors ./reception -m).
+ */
+
+#include "GestionFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using Horloge = std::chrono::steady_clock;
+
+int main(int argc, char *argv[])
+{
+    const bool memoirePartagee = (argc > 1 && std::strcmp(argv[1], "-m") == 0);
+    if (memoirePartagee) {
+        --argc;
+        ++argv;
+    }
+    const int rafales = (argc > 1) ? std::atoi(argv[1]) : 10;
+    const int tramesParRafale = (argc > 2) ? std::atoi(argv[2]) : 8;
+    const int pas = (argc > 3) ? std::atoi(argv[3]) : 4;
+
+    GestionFile fileRX;
+    GestionFile fileTX;
+    try {
+        if (memoirePartagee) {
+            fileRX.obtenirAnneauPartage("/ballon_rx", true);
+            fileTX.obtenirAnneauPartage("/ballon_tx", false);
+        } else {
+            fileRX.obtenirFileIPC(5678);
+            fileTX.obtenirFileIPC(5679);
+        }
+
+        // Réponses d'une mesure précédente
+        MessageTX reponse;
+        while (fileTX.lireMessageTX(reponse, false)) {
+        }
+
+        std::vector<double> latences;
+        for (int r = 0; r < rafales; ++r) {
+            std::vector<Horloge::time_point> envois;
+            for (int i = 0; i < tramesParRafale; ++i) {
+                MessageRX message{};
+                message.type = 2;
+                message.RSSI = -100 - i;
+                message.SNR = 7.5f;
+                const bool valide = (i % pas) == 0;
+                std::snprintf(message.text, sizeof(message.text), "<\xff\x01%s>APLRG1,WIDE1-1::%-9s:QSL?{%d",
+                              valide ? "F4LTZ-1" : "F4ABC-7", valide ? "F4KMN-8" : "F4XYZ-9", r * tramesParRafale + i);
+                if (valide)
+                    envois.push_back(Horloge::now());
+                fileRX.ecrireMessageRX(message);
+            }
+            for (const Horloge::time_point &envoi : envois) {
+                fileTX.lireMessageTX(reponse, true);
+                latences.push_back(std::chrono::duration<double, std::milli>(Horloge::now() - envoi).count());
+            }
+        }
+
+        std::sort(latences.begin(), latences.end());
+        auto centile = [&latences](double p) {
+            return latences[std::min(latences.size() - 1, static_cast<size_t>(p * latences.size()))];
+        };
+        std::printf("%zu réponses : min %.1f ms, médiane %.1f ms, p90 %.1f ms, p99 %.1f ms, max %.1f ms\n",
+                    latences.size(), latences.front(), centile(0.5), centile(0.9), centile(0.99), latences.back());
+    }
+    catch (const std::exception &e) {
+        std::cerr << "Exception attrapée: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
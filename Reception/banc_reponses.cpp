@@ -0,0 +1,105 @@
+/**
+ * banc_reponses.cpp mesure, sur l'hôte, le coût de construction des réponses
+ *
+ * Les opérateurs new et delete globaux sont remplacés par des versions qui comptent les
+ * allocations : le banc vérifie que l'analyse d'une trame, son enregistrement dans les
+ * statistiques de liaison et la construction de sa réponse n'allouent rien, et mesure
+ * leur durée moyenne.
+ *
+ * Utilisation : ./banc_reponses [nombre de requêtes]
+ */
+
+#include "Reponses.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+static unsigned long nbAllocations = 0;
+
+void *operator new(size_t taille)
+{
+    ++nbAllocations;
+    if (void *p = std::malloc(taille ? taille : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+// Trames jouées en boucle : tous les codes Q gérés, et des trames sans réponse
+static const char *const TRAMES[] = {
+    "<\xff\x01" "F4LTZ-1>APLRG1,WIDE1-1::F4KMN-8  :QSA?{1",
+    "<\xff\x01" "F4LTZ-1>APLRG1,WIDE1-1::F4KMN-8  :QRK?{11",
+    "<\xff\x01" "F4KMN-2>APLRG1,WIDE1-1::F4KMN-8  :QSQ?{2",
+    "<\xff\x01" "F4LTZ>APLRG1::F4KMN-8  :QRZ?",
+    "<\xff\x01" "F4KMN-9>APLRG1,WIDE1-1::F4KMN-8  :QRX?{4",
+    "<\xff\x01" "F4LTZ-1>APLRG1,WIDE1-1::F4KMN-8  :QRT?{5",
+    "<\xff\x01" "F4LTZ-1>APLRG1,WIDE1-1::F4KMN-8  :QTR?{6",
+    "<\xff\x01" "F4KMN-1>APLRG1,WIDE1-1::F4KMN-8  :QSL?{7",
+    "<\xff\x01" "F4ABC-7>APLRG1,WIDE1-1::F4XYZ-9  :QSL?{8",
+    "<\xff\x01" "F4ABC-7>APLRG1,WIDE1-1:!4903.50N/07201.75W-Test",
+    "<\xff\x01" "F4LTZ-1>APLRG1,WIDE1-1::F4KMN-8  :Bonjour{10"
+};
+
+int main(int argc, char *argv[])
+{
+    const long nbRequetes = (argc > 1) ? std::atol(argv[1]) : 1000000;
+    const size_t nbTrames = sizeof(TRAMES) / sizeof(TRAMES[0]);
+
+    MessageRX messages[nbTrames];
+    for (size_t i = 0; i < nbTrames; ++i) {
+        messages[i] = MessageRX();
+        messages[i].type = 2;
+        messages[i].RSSI = -97;
+        messages[i].SNR = 8.25f;
+        std::strncpy(messages[i].text, TRAMES[i], sizeof(messages[i].text) - 1);
+    }
+    ListeIndicatifs autorises;
+    autorises.ajouterListe("F4KMN,F4LTZ");
+    StatistiquesLien statistiques;
+    Alea alea(12345);
+    TamponReponse reponse;
+
+    // Analyse, enregistrement dans les statistiques et construction de la réponse d'une trame
+    auto traiter = [&](const MessageRX &message, int idMessage, uint32_t instant) {
+        Requete requete;
+        if (!analyserTrame(message.text, strnlen(message.text, sizeof(message.text)), requete))
+            return false;
+        statistiques.enregistrer(requete.source.debut, requete.source.longueur, message.RSSI, message.SNR, instant);
+        return construireReponse(requete, message, "F4KMN-8", autorises, statistiques, idMessage, alea, reponse);
+    };
+
+    for (size_t i = 0; i < nbTrames; ++i) {
+        messages[i].RSSI = -97 - static_cast<int>(i % 5);
+        if (traiter(messages[i], 1, static_cast<uint32_t>(i)))
+            std::printf("%-2zu %s\n", i, reponse.c_str());
+        else
+            std::printf("%-2zu (pas de reponse)\n", i);
+    }
+    if (construireBalise(statistiques, reponse))
+        std::printf("B  %s\n", reponse.c_str());
+
+    const unsigned long avant = nbAllocations;
+    long nbReponses = 0;
+    const auto debut = std::chrono::steady_clock::now();
+    for (long i = 0; i < nbRequetes; ++i) {
+        if (traiter(messages[i % nbTrames], static_cast<int>(i), static_cast<uint32_t>(i)))
+            ++nbReponses;
+    }
+    const double duree = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - debut).count();
+    const unsigned long allocations = nbAllocations - avant;
+
+    std::printf("%ld requetes, %ld reponses : %.0f ns par requete, %lu allocation(s) (%.2f par requete)\n",
+                nbRequetes, nbReponses, duree / nbRequetes, allocations, static_cast<double>(allocations) / nbRequetes);
+    return allocations == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
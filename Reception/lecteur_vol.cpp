@@ -0,0 +1,69 @@
+/**
+ * lecteur_vol.cpp convertit, sur l'hôte, les segments de l'enregistreur de vol en CSV
+ *
+ * Chaque bloc est vérifié (marque et CRC32) avant d'être converti. Les blocs jamais écrits
+ * du segment préalloué (tout à zéro) sont ignorés sans bruit ; un bloc abîmé, typiquement
+ * celui qui était en cours d'écriture lors d'une coupure, est signalé sur la sortie
+ * d'erreur puis sauté : les autres blocs restent lisibles.
+ *
+ * Utilisation : ./lecteur_vol carte/vol/vol_*.bin > vol.csv
+ */
+
+#include "EnregistreurVol.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+
+// Indique si le bloc n'a jamais été écrit
+static bool blocVierge(const BlocVol &bloc)
+{
+    const unsigned char *octets = reinterpret_cast<const unsigned char *>(&bloc);
+    for (size_t i = 0; i < sizeof(bloc); ++i) {
+        if (octets[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage : %s segment.bin...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    static BlocVol bloc;
+    unsigned long nbEnregistrements = 0;
+    unsigned long nbAbimes = 0;
+    std::printf("numero,instant_ms,latitude,longitude,altitude,temperature,pression,humidite,acc_x,acc_y,acc_z\n");
+    for (int f = 1; f < argc; ++f) {
+        std::FILE *segment = std::fopen(argv[f], "rb");
+        if (segment == nullptr) {
+            std::perror(argv[f]);
+            ++nbAbimes;
+            continue;
+        }
+        for (unsigned long indice = 0; std::fread(&bloc, sizeof(bloc), 1, segment) == 1; ++indice) {
+            if (blocVierge(bloc))
+                continue;
+            const EnteteBlocVol &entete = bloc.entete;
+            if (entete.magique != MAGIQUE_BLOC_VOL || entete.version != VERSION_BLOC_VOL ||
+                entete.nbEnregistrements > ENREGISTREMENTS_PAR_BLOC || entete.crc != crc32Bloc(bloc)) {
+                std::fprintf(stderr, "%s : bloc %lu abime, ignore\n", argv[f], indice);
+                ++nbAbimes;
+                continue;
+            }
+            for (size_t i = 0; i < entete.nbEnregistrements; ++i) {
+                const EnregistrementVol &e = bloc.enregistrements[i];
+                const MesuresNacelle &m = e.mesures;
+                std::printf("%" PRIu32 ",%" PRId64 ",%.6f,%.6f,%.1f,%.2f,%.2f,%.1f,%.3f,%.3f,%.3f\n",
+                            e.numero, e.instant, m.latitude, m.longitude, m.altitude, m.temperature,
+                            m.pression, m.humidite, m.acceleration[0], m.acceleration[1], m.acceleration[2]);
+            }
+            nbEnregistrements += entete.nbEnregistrements;
+        }
+        std::fclose(segment);
+    }
+    std::fprintf(stderr, "%lu enregistrements, %lu blocs ou fichiers abimes\n", nbEnregistrements, nbAbimes);
+    return (nbAbimes == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,221 +1,319 @@
+#include "EnregistreurVol.h"
+#include "FiltreRequetes.h"
 #include "GestionFile.h"
+#include "ListeIndicatifs.h"
+#include "OrdonnanceurEmission.h"
+#include "Reponses.h"
+#include "Requete.h"
+#include "StatistiquesLien.h"
+#include "TelemetrieAPRS.h"
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <iostream>
-#include <sstream>
+#include <mutex>
 #include <stdexcept>
 #include <thread>
-#include <cstring>
-#include <cctype>
 #include <ctime>
-#include <vector>
 #include <cstdlib>
+#include <cstring>
+#include <unistd.h>
 
-const size_t MAX_MESSAGE_LENGTH = 63;
+// Nombre maximal de trames lues d'un coup dans la file de réception
+const size_t TAILLE_LOT = 16;
 
-// Fonction utilitaire pour supprimer les espaces en fin de chaîne
-static void rtrim(std::string &s) {
-    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) {
-        s.pop_back();
-    }
-}
+// Modulation du module LoRa (SF9, BW 125 kHz, CR 4/5, préambule de 8 symboles, en-tête explicite, CRC)
+// et octets que le pilote ajoute à chaque trame ("<\xff\x01F4KMN-8>APLRG1,WIDE1-1:")
+const ParametresLoRa LORA = { 9, 125000, 1, 8, true, true };
+const size_t SURCOUT_TRAME = 26;
 
-// Enumération pour identifier les codes Q gérés
-enum class QCode {
-    NONE,
-    QSA,
-    QSQ,
-    QRZ,
-    QRX,
-    QRT,
-    QTR,
-    QSL
-};
+// Cycle utile par défaut (option -c, en %), mesuré sur FENETRE_CYCLE, et période attendue de
+// la télémétrie (option -t, en secondes)
+const int CYCLE_UTILE = 10;
+const std::chrono::seconds FENETRE_CYCLE(600);
+const int PERIODE_TELEMETRIE = 120;
 
-// Fonction de détection du code Q dans la trame
-QCode parseQCode(const std::string &txt) {
-    if (txt.find("QSA?") != std::string::npos)
-        return QCode::QSA;
-    if (txt.find("QSQ?") != std::string::npos)
-        return QCode::QSQ;
-    if (txt.find("QRZ?") != std::string::npos)
-        return QCode::QRZ;
-    if (txt.find("QRX?") != std::string::npos)
-        return QCode::QRX;
-    if (txt.find("QRT?") != std::string::npos)
-        return QCode::QRT;
-    if (txt.find("QTR?") != std::string::npos)
-        return QCode::QTR;
-    if (txt.find("QSL?") != std::string::npos)
-        return QCode::QSL;
-    return QCode::NONE;
-}
+// File où les autres programmes de la nacelle déposent leurs trames : événements critiques
+// (type 1), télémétrie déjà formatée (type 3) et mesures des capteurs (type 4, MesuresNacelle),
+// que la réception encode en télémétrie APRS compressée
+const int CLE_FILE_NACELLE = 5680;
+const long TYPE_CRITIQUE = 1;
+const long TYPE_TELEMETRIE = 3;
+const long TYPE_MESURES = 4;
+
+// Répertoire par défaut de l'enregistreur de vol sur la carte SD (option -e) ; toutes les mesures
+// des capteurs y sont enregistrées, une seule par période de télémétrie part par radio
+const char *const REPERTOIRE_VOL = "vol";
+const std::chrono::seconds TOLERANCE_PERIODE(1);
+
+// Anti-inondation : chaque indicatif dispose d'une rafale de RAFALE_REQUETES requêtes, reconstituée
+// au rythme de REQUETES_PAR_MINUTE ; une requête répétée (même identifiant APRS) pendant
+// FENETRE_DOUBLONS après sa réponse n'en reçoit pas d'autre.
+const float REQUETES_PAR_MINUTE = 2.0f;
+const float RAFALE_REQUETES = 4.0f;
+const std::chrono::milliseconds FENETRE_DOUBLONS(120000);
+
+// Noms des décisions du filtre, pour le journal
+const char *const DECISIONS_FILTRE[] = { "acceptee", "fusionnee avec une reponse en attente", "doublon", "debit depasse" };
+
+// Période par défaut de la balise de qualité de liaison (option -b, 0 la désactive)
+const int PERIODE_BALISE = 600;
+
+// Indicatif de la nacelle et indicatifs autorisés par défaut (options -i et -a)
+const char *const INDICATIF_NACELLE = "F4KMN-8";
+const char *const INDICATIFS_AUTORISES = "F4KMN,F4LTZ";
+
+// Clés des files de messages et noms des anneaux en mémoire partagée qui les remplacent (option -m)
+const int CLE_FILE_RX = 5678;
+const int CLE_FILE_TX = 5679;
+const char *const ANNEAU_RX = "/ballon_rx";
+const char *const ANNEAU_TX = "/ballon_tx";
 
-int main() {
+// Action exécutée à la sortie d'une portée, même sur exception : les threads de main sont arrêtés
+// et attendus avant la destruction des objets qu'ils utilisent
+class ALaSortie
+{
+public:
+    explicit ALaSortie(std::function<void()> action) : action(action) {}
+    ~ALaSortie() { action(); }
+
+private:
+    std::function<void()> action;
+};
+
+int main(int argc, char *argv[]) {
     try {
-        // Initialisation des files IPC
+        // Configuration : indicatif de la nacelle et indicatifs sources autorisés
+        std::string indicatifNacelle = INDICATIF_NACELLE;
+        std::string listeAutorises = INDICATIFS_AUTORISES;
+        bool memoirePartagee = false;
+        int periodeBalise = PERIODE_BALISE;
+        int cycleUtile = CYCLE_UTILE;
+        int periodeTelemetrie = PERIODE_TELEMETRIE;
+        std::string repertoireVol = REPERTOIRE_VOL;
+        int option;
+        while ((option = getopt(argc, argv, "i:a:b:c:t:e:m")) != -1) {
+            switch (option) {
+            case 'i':
+                indicatifNacelle = optarg;
+                break;
+            case 'a':
+                listeAutorises = optarg;
+                break;
+            case 'b':
+                periodeBalise = std::atoi(optarg);
+                break;
+            case 'c':
+                cycleUtile = std::atoi(optarg);
+                break;
+            case 't':
+                periodeTelemetrie = std::atoi(optarg);
+                break;
+            case 'e':
+                repertoireVol = optarg;
+                break;
+            case 'm':
+                memoirePartagee = true;
+                break;
+            default:
+                std::cerr << "Usage : " << argv[0] << " [-i indicatif de la nacelle] [-a indicatifs autorises, separes par des virgules] [-b periode de la balise de liaison en secondes (0 : aucune)] [-c cycle utile en %] [-t periode de la telemetrie en secondes] [-e repertoire de l'enregistreur de vol] [-m (memoire partagee)]" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        ListeIndicatifs autorises;
+        if (!autorises.ajouterListe(listeAutorises))
+            throw std::runtime_error("Liste d'indicatifs autorises invalide.");
+        if (cycleUtile <= 0 || cycleUtile > 100 || periodeTelemetrie <= 0)
+            throw std::runtime_error("Cycle utile ou periode de la telemetrie invalide.");
+
+        // Initialisation des files IPC, ou des anneaux en mémoire partagée
         GestionFile fileRX;
         GestionFile fileTX;
-        fileRX.obtenirFileIPC(5678);
-        fileTX.obtenirFileIPC(5679);
-
-        // Seed du générateur aléatoire
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
+        if (memoirePartagee) {
+            fileRX.obtenirAnneauPartage(ANNEAU_RX, false);
+            fileTX.obtenirAnneauPartage(ANNEAU_TX, true);
+        } else {
+            fileRX.obtenirFileIPC(CLE_FILE_RX);
+            fileTX.obtenirFileIPC(CLE_FILE_TX);
+        }
+        fileTX.definirNonBloquant(true);
+        GestionFile fileNacelle;
+        fileNacelle.obtenirFileIPC(CLE_FILE_NACELLE);
 
-        MessageRX message;
-        int idMessage = 1;
+        // Ordonnanceur : seul son thread écrit dans la file d'émission
+        OrdonnanceurEmission ordonnanceur(fileTX, LORA, SURCOUT_TRAME, cycleUtile / 100.0f, FENETRE_CYCLE,
+                                          std::chrono::seconds(periodeTelemetrie));
+        EnregistreurVol enregistreur;
+        StatistiquesLien statistiques;
 
-        while (true) {
-            message = fileRX.lireDansLaFileIPC(2);
-            std::string txt(message.text);
-            std::cout << "Trame reçue: " << txt << std::endl;
-
-            // Extraction de l'indicatif source (entre '<' et '>')
-            std::string sourceCallsign;
-            size_t posStart = txt.find('<');
-            size_t posEnd = (posStart != std::string::npos) ? txt.find('>', posStart + 1) : std::string::npos;
-            if (posStart != std::string::npos && posEnd != std::string::npos && posEnd > posStart) {
-                sourceCallsign = txt.substr(posStart + 1, posEnd - posStart - 1);
-                while (!sourceCallsign.empty() && !std::isalnum(static_cast<unsigned char>(sourceCallsign[0])))
-                    sourceCallsign.erase(sourceCallsign.begin());
+        // Threads de la réception, prévenus par arret puis attendus à la sortie de main
+        std::mutex mutexArret;
+        std::condition_variable signalArret;
+        std::atomic<bool> arret(false);
+        std::thread emission;
+        std::thread ecriture;
+        std::thread nacelle;
+        std::thread balise;
+        ALaSortie arretThreads([&]() {
+            {
+                std::lock_guard<std::mutex> lock(mutexArret);
+                arret = true;
+            }
+            signalArret.notify_all();
+            if (nacelle.joinable()) {
+                // Message vide qui réveille la lecture bloquante de la file de la nacelle
+                fileNacelle.ecrireDansLaFileIPC("", 0);
+                nacelle.join();
             }
+            if (balise.joinable())
+                balise.join();
+            enregistreur.arreter();
+            if (ecriture.joinable())
+                ecriture.join();
+            ordonnanceur.arreter();
+            if (emission.joinable())
+                emission.join();
+        });
 
-            // Extraction de l'indicatif destination (entre "::" et le prochain ':')
-            std::string destCallsign;
-            size_t posDoubleColon = txt.find("::");
-            size_t posMsg = (posDoubleColon != std::string::npos) ? txt.find(":", posDoubleColon + 2) : std::string::npos;
-            if (posDoubleColon != std::string::npos && posMsg != std::string::npos && posMsg > posDoubleColon) {
-                destCallsign = txt.substr(posDoubleColon + 2, posMsg - posDoubleColon - 2);
-                rtrim(destCallsign);
+        emission = std::thread([&ordonnanceur]() {
+            try {
+                ordonnanceur.executer();
+            }
+            catch (const std::exception &e) {
+                std::cerr << "Exception attrapée (émission): " << e.what() << std::endl;
+                std::exit(EXIT_FAILURE);
             }
+        });
 
-            // Vérification de l'indicatif source (doit commencer par "F4KMN" ou "F4LTZ")
-            bool sourceOK = false;
-            if (!sourceCallsign.empty()) {
-                const std::string prefix1 = "F4KMN";
-                const std::string prefix2 = "F4LTZ";
-                if (sourceCallsign.size() >= prefix1.size() &&
-                    (sourceCallsign.compare(0, prefix1.size(), prefix1) == 0 ||
-                     sourceCallsign.compare(0, prefix2.size(), prefix2) == 0)) {
-                    sourceOK = true;
+        // Enregistreur de vol : une carte absente ou pleine n'empêche pas la liaison radio
+        bool enregistrement = false;
+        try {
+            enregistreur.ouvrir(repertoireVol);
+            enregistrement = true;
+            ecriture = std::thread([&enregistreur]() {
+                enregistreur.executer();
+            });
+        }
+        catch (const std::exception &e) {
+            std::cerr << "Enregistreur de vol desactive: " << e.what() << std::endl;
+        }
+
+        // Trames des autres programmes de la nacelle, événements critiques d'abord
+        nacelle = std::thread([&fileNacelle, &ordonnanceur, &enregistreur, &arret, enregistrement, periodeTelemetrie]() {
+            try {
+                MessageTX message;
+                char trame[TAILLE_TRAME_TELEMETRIE + 1];
+                uint32_t sequence = 0;
+                const auto periode = std::chrono::seconds(periodeTelemetrie) - TOLERANCE_PERIODE;
+                auto derniereTelemetrie = std::chrono::steady_clock::time_point();
+                while (fileNacelle.lireMessageTX(message, true, -TYPE_MESURES) && !arret) {
+                    // Message vide : réveil de l'arrêt, ou resté dans la file depuis un arrêt précédent
+                    if (message.type != TYPE_MESURES && message.text[0] == '\0')
+                        continue;
+                    bool ajoutee = true;
+                    if (message.type == TYPE_MESURES) {
+                        MesuresNacelle mesures;
+                        std::memcpy(&mesures, message.text, sizeof(mesures));
+                        if (enregistrement)
+                            enregistreur.enregistrer(mesures);
+                        const auto maintenant = std::chrono::steady_clock::now();
+                        if (derniereTelemetrie == std::chrono::steady_clock::time_point() ||
+                            maintenant - derniereTelemetrie >= periode) {
+                            derniereTelemetrie = maintenant;
+                            const size_t taille = construireTrameTelemetrie(mesures, sequence++, trame, sizeof(trame));
+                            ajoutee = ordonnanceur.ajouter(OrdonnanceurEmission::TELEMETRIE, trame, taille);
+                        }
+                    } else {
+                        const OrdonnanceurEmission::Classe classe =
+                            (message.type == TYPE_CRITIQUE) ? OrdonnanceurEmission::CRITIQUE : OrdonnanceurEmission::TELEMETRIE;
+                        ajoutee = ordonnanceur.ajouter(classe, message.text, std::strlen(message.text));
+                    }
+                    if (!ajoutee)
+                        std::cerr << "Trame de la nacelle perdue, file de l'ordonnanceur pleine" << std::endl;
                 }
             }
+            catch (const std::exception &e) {
+                std::cerr << "Exception attrapée (file de la nacelle): " << e.what() << std::endl;
+                std::exit(EXIT_FAILURE);
+            }
+        });
 
-            // Vérification de l'indicatif destination (doit être "F4KMN-8")
-            bool destOK = (destCallsign == "F4KMN-8");
-
-            // Identification du code Q présent dans la trame
-            QCode code = parseQCode(txt);
-
-            // Si le message est valide, construire et envoyer la réponse
-            if (code != QCode::NONE && sourceOK && destOK) {
-                // Ajustement de l'indicatif source sur exactement 9 caractères
-                if (sourceCallsign.size() < 9)
-                    sourceCallsign.append(9 - sourceCallsign.size(), ' ');
-                else if (sourceCallsign.size() > 9)
-                    sourceCallsign.resize(9);
-
-                std::ostringstream out;
-                out << ":" << sourceCallsign << ":";
-
-                switch (code) {
-                case QCode::QSA: {
-                    std::vector<std::string> responses = {
-                        "QSA  RSSI=" + std::to_string(message.RSSI) + "dBm SNR=" + std::to_string(message.SNR) + "dB{" + std::to_string(idMessage),
-                        "QSA  Mesures: " + std::to_string(message.RSSI) + " dBm, " + std::to_string(message.SNR) + " dB (msg " + std::to_string(idMessage) + ")",
-                        "QSA  Indicateurs releves: RSSI=" + std::to_string(message.RSSI) + "dBm, SNR=" + std::to_string(message.SNR) + "dB | id:" + std::to_string(idMessage)
-                    };
-                    out << responses[std::rand() % responses.size()];
-                    break;
-                }
-                case QCode::QSQ: {
-                    std::vector<std::string> responses = {
-                        "QSQ Aucun docteur, ici Ohm soigne tous les circuits.",
-                        "QSQ Consultation refusee, seule la technique prevaut.",
-                        "QSQ Docteur inutile, juste circuits et transistors."
-                    };
-                    out << responses[std::rand() % responses.size()];
-                    break;
-                }
-                case QCode::QRZ: {
-                    std::vector<std::string> responses = {
-                        "QRZ Si vous appelez, vous connaissez deja mon indic.",
-                        "QRZ Demandez-vous vraiment a qui vous parlez ?",
-                        "QRZ Curieux: appeler sans savoir qui vous appellez...",
-                        "QRZ Paradoxe resolu si vous savez a qui vous parlez.",
-                        "QRZ Test d hypnose, oublieriez-vous mon indicatif ?",
-                        "QRZ Vous doutez ? Pourtant vous avez bien appele !",
-                        "QRZ La reponse: c est vous qui creez la question.",
-                        "QRZ Vous appelez mais vous ignorez encore mon nom ?"
-                    };
-                    out << responses[std::rand() % responses.size()];
-                    break;
-                }
-                case QCode::QRX: {
-                    std::vector<std::string> responses = {
-                        "QRX Rappeler ? Je reponds plus vite qu un photon.",
-                        "QRX Cafe quantique fini, rappel inutile, je suis la.",
-                        "QRX Attendez que la vitesse lumiere ralentisse ? Non.",
-                        "QRX Automate toujours pret, c est vous qui hesitez.",
-                        "QRX File attente inexistante : je reponds sans delai.",
-                        "QRX Temps relatif, mais ici je reponds instantanement.",
-                        "QRX Resistance serie inutile, reponse deja envoyee !",
-                        "QRX Inutile de rappeler, ma reponse precede votre appel."
-                    };
-                    out << responses[std::rand() % responses.size()];
-                    break;
-                }
-                case QCode::QRT: {
-                    std::vector<std::string> responses = {
-                        "QRT Arret impossible, mes ondes sont eternelles.",
-                        "QRT Jamais arreter, mes signaux traversent l univers.",
-                        "QRT Transmission continue, imperturbable et infinie.",
-                        "QRT Arreter ? Mes bits voyagent comme les neutrinos.",
-                        "QRT Interrompre la science ? Idee digne d un barbare.",
-                        "QRT Vous pouvez couper, mais mes ondes restent libres.",
-                        "QRT Impossible d arreter : code en execution infinie.",
-                        "QRT Arret refuse, je transmets jusqu a la fin des temps."
-                    };
-                    out << responses[std::rand() % responses.size()];
-                    break;
-                }
-                case QCode::QTR: {
-                    auto now = std::chrono::system_clock::now();
-                    std::time_t now_time = std::chrono::system_clock::to_time_t(now);
-                    std::tm local_tm = *std::localtime(&now_time);
-                    char buffer[64];
-                    std::strftime(buffer, sizeof(buffer), "%H:%M:%S", &local_tm);
-                    std::vector<std::string> responses = {
-                        std::string("QTR  Heure locale : ") + buffer,
-                        std::string("QTR  Temps d ondes : ") + buffer,
-                        std::string("QTR  Instantane : ") + buffer
-                    };
-                    out << responses[std::rand() % responses.size()];
-                    break;
-                }
-                case QCode::QSL: {
-                    std::vector<std::string> responses = {
-                        "QSL  Message reçu, signal clair et net.",
-                        "QSL  Accuse de reception : vos ondes sont parfaitement captees.",
-                        "QSL  Communication validee, le spectre est en parfait etat."
-                    };
-                    out << responses[std::rand() % responses.size()];
-                    break;
-                }
-                default:
-                    break;
+        // Balise périodique qui diffuse les statistiques de liaison par station
+        const auto demarrage = std::chrono::steady_clock::now();
+        if (periodeBalise > 0) {
+            balise = std::thread([&statistiques, &ordonnanceur, &mutexArret, &signalArret, &arret, periodeBalise]() {
+                TamponReponse trame;
+                std::unique_lock<std::mutex> lock(mutexArret);
+                while (!signalArret.wait_for(lock, std::chrono::seconds(periodeBalise), [&arret]() { return arret.load(); })) {
+                    lock.unlock();
+                    if (construireBalise(statistiques, trame))
+                        ordonnanceur.ajouter(OrdonnanceurEmission::BAVARDAGE, trame.c_str(), trame.taille());
+                    lock.lock();
                 }
+            });
+        }
 
-                std::string response = out.str();
-                if (response.size() > MAX_MESSAGE_LENGTH) {
-                    response = response.substr(0, MAX_MESSAGE_LENGTH);
-                }
+        // Graine du générateur aléatoire
+        Alea alea(static_cast<uint32_t>(std::time(nullptr)) ^ (static_cast<uint32_t>(getpid()) << 16));
+
+        FiltreRequetes filtre(REQUETES_PAR_MINUTE, RAFALE_REQUETES, static_cast<uint32_t>(FENETRE_DOUBLONS.count()));
+        auto millisecondes = [demarrage]() {
+            return static_cast<uint32_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - demarrage).count());
+        };
+
+        MessageRX lot[TAILLE_LOT];
+        TamponReponse reponse;
+        uint32_t cles[OrdonnanceurEmission::NB_EMISES];
+        int idMessage = 1;
+
+        while (true) {
+            // Attente bloquante de la première trame, puis lecture de celles déjà en file
+            const size_t nbTrames = fileRX.lireLotDansLaFileIPC(2, lot, TAILLE_LOT, true);
+            const uint32_t instant = millisecondes();
 
-                fileTX.ecrireDansLaFileIPC(response);
-                ++idMessage;
+            // Réponses émises depuis le lot précédent : leurs doublons ne sont plus fusionnés mais écartés
+            size_t nbEmises;
+            while ((nbEmises = ordonnanceur.emises(cles, OrdonnanceurEmission::NB_EMISES)) > 0) {
+                for (size_t i = 0; i < nbEmises; ++i)
+                    filtre.reponseEmise(cles[i], instant);
             }
 
-            // Pause de 1000 ms avant de traiter la trame suivante
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+            // Traitement du lot : les réponses attendent leur tour dans l'ordonnanceur
+            for (size_t i = 0; i < nbTrames; ++i) {
+                std::cout << "Trame reçue: " << lot[i].text << std::endl;
+                Requete requete;
+                if (!analyserTrame(lot[i].text, strnlen(lot[i].text, sizeof(lot[i].text)), requete))
+                    continue;
+                statistiques.enregistrer(requete.source.debut, requete.source.longueur, lot[i].RSSI, lot[i].SNR, instant / 1000);
+                if (!appelleReponse(requete, indicatifNacelle.c_str(), autorises))
+                    continue;
+
+                // Doublons et sources trop bavardes ne coûtent aucun temps d'antenne
+                uint32_t cle;
+                const FiltreRequetes::Decision decision = filtre.filtrer(requete, instant, cle);
+                if (decision != FiltreRequetes::ACCEPTEE) {
+                    const FiltreRequetes::Compteurs &compteurs = filtre.compteurs();
+                    std::cout << "Requête écartée (" << DECISIONS_FILTRE[decision] << ") ; écartées depuis le lancement : "
+                              << compteurs.fusionnees << " fusionnées, " << compteurs.doublons << " doublons, "
+                              << compteurs.limitees << " au-delà du débit" << std::endl;
+                    continue;
+                }
+                if (!construireReponse(requete, lot[i], indicatifNacelle.c_str(), autorises, statistiques,
+                                       idMessage, alea, reponse)) {
+                    filtre.reponsePerdue(requete, cle, instant);
+                    continue;
+                }
+                const OrdonnanceurEmission::Classe classe =
+                    reponseDeFantaisie(requete.codeQ) ? OrdonnanceurEmission::BAVARDAGE : OrdonnanceurEmission::REPONSE;
+                if (ordonnanceur.ajouter(classe, reponse.c_str(), reponse.taille(), cle)) {
+                    ++idMessage;
+                } else {
+                    std::cerr << "Réponse perdue, file de l'ordonnanceur pleine" << std::endl;
+                    filtre.reponsePerdue(requete, cle, instant);
+                }
+            }
         }
     }
     catch (const std::exception &e) {
@@ -1,4 +1,4 @@
-QT       += core gui widgets websockets serialport sql
+QT       += core gui widgets network websockets serialport sql concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -10,20 +10,49 @@ CONFIG += c++17
 
 SOURCES += \
     aprsisclient.cpp \
+    aprsparser.cpp \
     ax25converter.cpp \
+    callsigntable.cpp \
+    configuration.cpp \
+    databasewriter.cpp \
+    flightstateengine.cpp \
+    frame.cpp \
+    framedecoding.cpp \
+    frametablemodel.cpp \
     kisshandler.cpp \
+    kisstcpserver.cpp \
+    landingpredictor.cpp \
     main.cpp \
     interface.cpp \
     mysqlmanager.cpp \
-    serialportmanager.cpp
+    serialportmanager.cpp \
+    sqlitestorage.cpp \
+    stationstate.cpp \
+    storagewriter.cpp \
+    tracer.cpp
 
 HEADERS += \
     aprsisclient.h \
+    aprsparser.h \
     ax25converter.h \
+    callsigntable.h \
+    configuration.h \
+    databasewriter.h \
+    flightstateengine.h \
+    frame.h \
+    framedecoding.h \
+    frametablemodel.h \
     interface.h \
     kisshandler.h \
+    kisstcpserver.h \
+    landingpredictor.h \
     mysqlmanager.h \
-    serialportmanager.h
+    serialportmanager.h \
+    sqlitestorage.h \
+    stationstate.h \
+    storagebackend.h \
+    storagewriter.h \
+    tracer.h
 
 FORMS += \
     interface.ui
@@ -1,4 +1,5 @@
 #include "aprsisclient.h"
+#include "frame.h"
 #include <QDebug>
 
 /**
@@ -12,35 +13,47 @@
 APRSISClient::APRSISClient(QObject *parent)
     : QObject(parent),
     mIGateCall("F4LTZ"),
-    mIGatePass("9090")
+    mIGatePass("9090"),
+    m_port(0),
+    m_reconnectDelay(MIN_RECONNECT_DELAY)
 {
     // Connecter les signaux du socket aux slots appropriés
     connect(&m_socket, &QTcpSocket::connected, this, &APRSISClient::onConnected);
     connect(&m_socket, &QTcpSocket::readyRead, this, &APRSISClient::onReadyRead);
     connect(&m_socket, &QTcpSocket::disconnected, this, &APRSISClient::onDisconnected);
+    connect(&m_socket, &QAbstractSocket::errorOccurred, this, &APRSISClient::onSocketError);
+
+    m_reconnectTimer.setSingleShot(true);
+    connect(&m_reconnectTimer, &QTimer::timeout, this, &APRSISClient::onReconnectTimeout);
 }
 
 /**
  * @brief Établit une connexion avec le serveur APRS-IS.
  *
  * Tente d'ouvrir une connexion TCP vers le serveur spécifié par l'adresse @p host et le port @p port.
+ * Le serveur est mémorisé pour les reconnexions automatiques.
  *
  * @param host Adresse du serveur APRS-IS.
  * @param port Port de connexion.
  */
 void APRSISClient::connectToServer(const QString &host, int port)
 {
+    m_host = host;
+    m_port = port;
+    m_socket.abort();
+    m_reconnectTimer.stop();
     m_socket.connectToHost(host, port);
 }
 
 /**
  * @brief Slot appelé lorsque la connexion au serveur est établie.
  *
- * Une fois connecté, ce slot émet le signal @c connected et envoie la ligne de login
- * pour authentifier l'utilisateur auprès du serveur APRS-IS.
+ * Une fois connecté, ce slot réinitialise le délai de reconnexion, émet le signal @c connected
+ * et envoie la ligne de login pour authentifier l'utilisateur auprès du serveur APRS-IS.
  */
 void APRSISClient::onConnected()
 {
+    m_reconnectDelay = MIN_RECONNECT_DELAY;
     emit connected();
     // Compose la ligne de login APRS-IS
     QString loginLine = QString("user %1 pass %2 vers QtIGATE 0.1\n")
@@ -63,11 +76,55 @@ void APRSISClient::onReadyRead()
 /**
  * @brief Slot appelé lors de la déconnexion du serveur APRS-IS.
  *
- * Émet le signal @c disconnected pour notifier que la connexion a été interrompue.
+ * Émet le signal @c disconnected pour notifier que la connexion a été interrompue,
+ * puis programme une reconnexion.
  */
 void APRSISClient::onDisconnected()
 {
     emit disconnected();
+    scheduleReconnect();
+}
+
+/**
+ * @brief Slot appelé en cas d'erreur sur le socket.
+ *
+ * Émet le signal @c errorOccurred avec la description de l'erreur et, si le socket n'est plus
+ * connecté (connexion refusée, hôte introuvable...), programme une reconnexion.
+ *
+ * @param error Code d'erreur retourné par QTcpSocket.
+ */
+void APRSISClient::onSocketError(QAbstractSocket::SocketError error)
+{
+    Q_UNUSED(error);
+    emit errorOccurred(m_socket.errorString());
+    if (m_socket.state() == QAbstractSocket::UnconnectedState)
+        scheduleReconnect();
+}
+
+/**
+ * @brief Slot appelé à l'échéance du délai de reconnexion.
+ *
+ * Relance la connexion vers le dernier serveur demandé.
+ */
+void APRSISClient::onReconnectTimeout()
+{
+    if (m_socket.state() == QAbstractSocket::UnconnectedState)
+        m_socket.connectToHost(m_host, m_port);
+}
+
+/**
+ * @brief Programme une tentative de reconnexion avec un délai croissant.
+ *
+ * Le délai double à chaque échec, dans la limite de MAX_RECONNECT_DELAY. Une seule tentative
+ * est programmée à la fois.
+ */
+void APRSISClient::scheduleReconnect()
+{
+    if (m_host.isEmpty() || m_reconnectTimer.isActive())
+        return;
+    m_reconnectTimer.start(m_reconnectDelay);
+    emit reconnecting(m_reconnectDelay);
+    m_reconnectDelay = qMin(m_reconnectDelay * 2, MAX_RECONNECT_DELAY);
 }
 
 /**
@@ -86,3 +143,22 @@ void APRSISClient::sendLine(const QString &line)
         emit errorOccurred("APRS-IS socket non connecté.");
     }
 }
+
+/**
+ * @brief Relaie une trame reçue vers le serveur APRS-IS.
+ *
+ * Le texte TNC2 et la fin de ligne sont écrits directement dans le tampon du socket.
+ * Si le socket n'est pas connecté, émet le signal @c errorOccurred.
+ *
+ * @param frame La trame à relayer.
+ */
+void APRSISClient::sendFrame(const Frame &frame)
+{
+    if (m_socket.state() == QAbstractSocket::ConnectedState) {
+        std::string_view line = frame.tnc2();
+        m_socket.write(line.data(), static_cast<qint64>(line.size()));
+        m_socket.write("\r\n", 2);
+    } else {
+        emit errorOccurred("APRS-IS socket non connecté.");
+    }
+}
@@ -14,17 +14,24 @@
 
 #include <QObject>
 #include <QTcpSocket>
+#include <QTimer>
+
+class Frame;
 
 /**
  * @brief Client pour la communication avec un serveur APRS-IS.
  *
  * La classe APRSISClient établit une connexion TCP avec un serveur APRS-IS, envoie
  * des lignes de trame (par exemple pour l'authentification ou l'envoi de messages)
- * et traite la réception des messages.
+ * et traite la réception des messages. En cas de perte de connexion ou d'échec, une nouvelle
+ * tentative est programmée avec un délai croissant (de MIN_RECONNECT_DELAY à MAX_RECONNECT_DELAY).
  */
 class APRSISClient : public QObject {
     Q_OBJECT
 public:
+    static constexpr int MIN_RECONNECT_DELAY = 1000;  ///< Délai initial avant reconnexion (ms).
+    static constexpr int MAX_RECONNECT_DELAY = 60000; ///< Délai maximal avant reconnexion (ms).
+
     /**
      * @brief Constructeur de la classe APRSISClient.
      * @param parent Pointeur vers l'objet parent (par défaut nullptr).
@@ -33,6 +40,9 @@ public:
 
     /**
      * @brief Établit une connexion avec le serveur APRS-IS.
+     *
+     * Le serveur est mémorisé pour les reconnexions automatiques.
+     *
      * @param host Adresse du serveur.
      * @param port Port de connexion.
      */
@@ -44,6 +54,15 @@ public:
      */
     void sendLine(const QString &line);
 
+    /**
+     * @brief Relaie une trame reçue vers le serveur APRS-IS.
+     *
+     * Le texte TNC2 de la trame est écrit directement sur le socket, sans conversion.
+     *
+     * @param frame La trame à relayer.
+     */
+    void sendFrame(const Frame &frame);
+
 signals:
     /**
      * @brief Signal émis lors de l'établissement de la connexion avec le serveur.
@@ -67,6 +86,12 @@ signals:
      */
     void errorOccurred(const QString &error);
 
+    /**
+     * @brief Signal émis lorsqu'une reconnexion est programmée.
+     * @param delay Délai avant la prochaine tentative (ms).
+     */
+    void reconnecting(int delay);
+
 private slots:
     /**
      * @brief Slot appelé lorsque la connexion au serveur est établie.
@@ -89,10 +114,33 @@ private slots:
      */
     void onDisconnected();
 
+    /**
+     * @brief Slot appelé en cas d'erreur sur le socket.
+     *
+     * Émet le signal @c errorOccurred et programme une reconnexion si le socket n'est plus connecté.
+     *
+     * @param error Code d'erreur retourné par QTcpSocket.
+     */
+    void onSocketError(QAbstractSocket::SocketError error);
+
+    /**
+     * @brief Slot appelé à l'échéance du délai de reconnexion.
+     */
+    void onReconnectTimeout();
+
 private:
+    /**
+     * @brief Programme une tentative de reconnexion avec un délai croissant.
+     */
+    void scheduleReconnect();
+
     QTcpSocket m_socket;      ///< Socket TCP utilisé pour la communication avec le serveur APRS-IS.
     QString mIGateCall;       ///< Call sign utilisé pour la connexion (identifiant APRS-IS).
     QString mIGatePass;       ///< Mot de passe associé au call sign pour la connexion APRS-IS.
+    QString m_host;           ///< Adresse du serveur APRS-IS.
+    int m_port;               ///< Port du serveur APRS-IS.
+    QTimer m_reconnectTimer;  ///< Minuteur de reconnexion.
+    int m_reconnectDelay;     ///< Délai de la prochaine reconnexion (ms).
 };
 
 #endif // APRSISCLIENT_H
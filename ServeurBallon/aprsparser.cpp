@@ -0,0 +1,713 @@
+#include "aprsparser.h"
+
+#include <array>
+#include <cmath>
+
+/**
+ * @file aprsparser.cpp
+ * @brief Implémentation de la classe APRSParser.
+ *
+ * Chaque identifiant de type de donnée APRS est associé à une fonction de décodage dans une table
+ * construite à la compilation. Les fonctions de décodage travaillent directement sur des vues
+ * du tampon d'origine, sans aucune allocation.
+ */
+
+namespace {
+
+constexpr double KNOTS_TO_KMH = 1.852;  ///< Conversion nœuds -> km/h.
+constexpr double FEET_TO_M    = 0.3048; ///< Conversion pieds -> mètres.
+
+/**
+ * @brief Profil de télémétrie de la nacelle (Reception/TelemetrieAPRS.h) : valeur = brut * échelle + décalage.
+ *
+ * a1 température (°C), a2 pression (hPa), a3 à a5 accélérations x, y, z (g) ; les bits numériques
+ * portent l'humidité relative (%).
+ */
+constexpr double BALLOON_TEMPERATURE_SCALE  = 1.0 / 50.0;
+constexpr double BALLOON_TEMPERATURE_OFFSET = -80.0;
+constexpr double BALLOON_PRESSURE_SCALE     = 1.0 / 7.5;
+constexpr double BALLOON_ACCEL_SCALE        = 1.0 / 256.0;
+constexpr double BALLOON_ACCEL_OFFSET       = -16.0;
+
+/**
+ * @brief Indicatifs de la nacelle (APRSParser::setBalloonCallsigns()).
+ */
+std::vector<std::string> &balloonCallsigns()
+{
+    static std::vector<std::string> callsigns{APRSParser::DEFAULT_BALLOON_CALLSIGN};
+    return callsigns;
+}
+
+using Decoder = bool (*)(std::string_view destination, std::string_view info, APRSPacket &packet);
+
+/**
+ * @brief Indique si un caractère est un chiffre décimal.
+ */
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief Convertit une suite de chiffres en entier.
+ *
+ * Les espaces (ambiguïté de position APRS) sont traités comme des zéros si @p allowSpaces est vrai.
+ * Au-delà de MAX_UINT_DIGITS chiffres la valeur ne tiendrait plus dans un int : la suite,
+ * reçue par radio, est refusée.
+ *
+ * @return bool @c false si un caractère n'est pas un chiffre ou si la suite est trop longue.
+ */
+bool parseUInt(std::string_view s, int &value, bool allowSpaces = false)
+{
+    constexpr std::size_t MAX_UINT_DIGITS = 9;
+    if (s.empty() || s.size() > MAX_UINT_DIGITS)
+        return false;
+    int v = 0;
+    for (char c : s) {
+        if (isDigit(c))
+            v = v * 10 + (c - '0');
+        else if (allowSpaces && c == ' ')
+            v = v * 10;
+        else
+            return false;
+    }
+    value = v;
+    return true;
+}
+
+/**
+ * @brief Convertit une valeur décimale signée ("-12.5", "078", "3.").
+ */
+bool parseDecimal(std::string_view s, double &value)
+{
+    std::size_t i = 0;
+    bool negative = false;
+    if (i < s.size() && (s[i] == '-' || s[i] == '+')) {
+        negative = (s[i] == '-');
+        ++i;
+    }
+    double v = 0.0;
+    bool digits = false;
+    for (; i < s.size() && isDigit(s[i]); ++i) {
+        v = v * 10.0 + (s[i] - '0');
+        digits = true;
+    }
+    if (i < s.size() && s[i] == '.') {
+        double scale = 0.1;
+        for (++i; i < s.size() && isDigit(s[i]); ++i) {
+            v += (s[i] - '0') * scale;
+            scale *= 0.1;
+            digits = true;
+        }
+    }
+    if (!digits || i != s.size())
+        return false;
+    value = negative ? -v : v;
+    return true;
+}
+
+/**
+ * @brief Décode une valeur base91 sur @p s.size() caractères.
+ */
+bool parseBase91(std::string_view s, long &value)
+{
+    long v = 0;
+    for (char c : s) {
+        if (c < '!' || c > '{')
+            return false;
+        v = v * 91 + (c - 33);
+    }
+    value = v;
+    return true;
+}
+
+/**
+ * @brief Recherche une altitude "/A=NNNNNN" (pieds) dans un commentaire.
+ */
+void parseAltitudeComment(std::string_view comment, APRSPosition &position)
+{
+    std::size_t pos = comment.find("/A=");
+    if (pos == std::string_view::npos || pos + 9 > comment.size())
+        return;
+    std::string_view digits = comment.substr(pos + 3, 6);
+    bool negative = (digits[0] == '-');
+    int feet = 0;
+    if (!parseUInt(negative ? digits.substr(1) : digits, feet))
+        return;
+    position.altitude = (negative ? -feet : feet) * FEET_TO_M;
+    position.hasAltitude = true;
+}
+
+/**
+ * @brief Extrait les champs météo tNNN (°F), hNN (%) et bNNNNN (dixièmes de hPa).
+ *
+ * Les autres champs météo (c, s, g, r, p, P, L, l) sont reconnus pour être sautés.
+ */
+void parseWeatherFields(std::string_view s, APRSWeather &weather)
+{
+    std::size_t i = 0;
+    while (i < s.size()) {
+        char field = s[i];
+        int width;
+        switch (field) {
+        case 'c': case 's': case 'g': case 't':
+        case 'r': case 'p': case 'P': case 'L': case 'l':
+            width = 3; break;
+        case 'h': width = 2; break;
+        case 'b': width = 5; break;
+        default:  return;
+        }
+        if (i + 1 + width > s.size())
+            return;
+        std::string_view digits = s.substr(i + 1, width);
+        int value = 0;
+        bool negative = (digits[0] == '-');
+        bool ok = parseUInt(negative ? digits.substr(1) : digits, value);
+        if (negative)
+            value = -value;
+        if (ok) {
+            if (field == 't') {
+                weather.temperature = (value - 32) * 5.0 / 9.0;
+                weather.hasTemperature = true;
+            } else if (field == 'h') {
+                weather.humidity = (value == 0) ? 100 : value;
+                weather.hasHumidity = true;
+            } else if (field == 'b') {
+                weather.pressure = value / 10.0;
+                weather.hasPressure = true;
+            }
+        }
+        i += 1 + width;
+    }
+}
+
+/**
+ * @brief Extrait du commentaire l'extension de télémétrie compressée "|ss11...dd|".
+ *
+ * Entre les deux barres : séquence puis une à cinq voies analogiques, et les bits numériques
+ * si les cinq voies sont présentes, chacun sur deux caractères base91. L'extension est retirée
+ * du commentaire quand elle l'ouvre ou le termine.
+ */
+void parseCompressedTelemetry(std::string_view &comment, APRSTelemetry &telemetry)
+{
+    std::size_t open = comment.find('|');
+    if (open == std::string_view::npos)
+        return;
+    std::size_t close = comment.find('|', open + 1);
+    if (close == std::string_view::npos)
+        return;
+    std::string_view body = comment.substr(open + 1, close - open - 1);
+    if (body.size() < 4 || body.size() > 14 || body.size() % 2 != 0)
+        return;
+
+    long values[7];
+    const std::size_t count = body.size() / 2;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!parseBase91(body.substr(2 * i, 2), values[i]))
+            return;
+    }
+    telemetry.sequence = static_cast<int>(values[0]);
+    telemetry.analogCount = static_cast<int>(count - 1 > APRSTelemetry::MAX_ANALOG ? APRSTelemetry::MAX_ANALOG : count - 1);
+    for (int i = 0; i < telemetry.analogCount; ++i)
+        telemetry.analog[i] = values[1 + i];
+    if (count == 7) {
+        telemetry.digital = static_cast<std::uint8_t>(values[6]);
+        telemetry.hasDigital = true;
+    }
+    telemetry.compressed = true;
+
+    // Le reste du commentaire, de part et d'autre de l'extension
+    if (open == 0)
+        comment.remove_prefix(close + 1);
+    else if (close + 1 == comment.size())
+        comment = comment.substr(0, open);
+}
+
+/**
+ * @brief Applique le profil de la nacelle à la télémétrie compressée d'une de ses positions.
+ *
+ * Le profil est choisi par l'indicatif source et non par le symbole : "/O" est le symbole de tout
+ * ballon APRS, dont les voies brutes ne sont pas des températures ni des pressions.
+ */
+void applyBalloonProfile(APRSPacket &packet)
+{
+    const APRSTelemetry &telemetry = packet.telemetry;
+    if (!APRSParser::isBalloon(packet.source)
+        || !telemetry.compressed || telemetry.analogCount != APRSTelemetry::MAX_ANALOG || !telemetry.hasDigital)
+        return;
+
+    APRSWeather &weather = packet.weather;
+    weather.temperature = telemetry.analog[0] * BALLOON_TEMPERATURE_SCALE + BALLOON_TEMPERATURE_OFFSET;
+    weather.pressure = telemetry.analog[1] * BALLOON_PRESSURE_SCALE;
+    weather.humidity = telemetry.digital;
+    weather.hasTemperature = weather.hasPressure = weather.hasHumidity = true;
+
+    APRSAcceleration &acceleration = packet.acceleration;
+    acceleration.x = telemetry.analog[2] * BALLOON_ACCEL_SCALE + BALLOON_ACCEL_OFFSET;
+    acceleration.y = telemetry.analog[3] * BALLOON_ACCEL_SCALE + BALLOON_ACCEL_OFFSET;
+    acceleration.z = telemetry.analog[4] * BALLOON_ACCEL_SCALE + BALLOON_ACCEL_OFFSET;
+    acceleration.hasAcceleration = true;
+}
+
+/**
+ * @brief Décode le commentaire d'une position (extension cap/vitesse, altitude, météo, télémétrie compressée).
+ */
+void parsePositionComment(std::string_view comment, APRSPacket &packet)
+{
+    APRSPosition &position = packet.position;
+    // Extension de données "CSE/SPD" (ou "_CSE/SPD" pour une station météo)
+    if (comment.size() >= 7 && comment[3] == '/') {
+        int course = 0;
+        int speed = 0;
+        if (parseUInt(comment.substr(0, 3), course) && parseUInt(comment.substr(4, 3), speed)) {
+            if (!position.hasCourseSpeed && position.symbolCode != '_') {
+                position.course = course;
+                position.speed = speed * KNOTS_TO_KMH;
+                position.hasCourseSpeed = true;
+            }
+            comment.remove_prefix(7);
+        }
+    }
+    parseCompressedTelemetry(comment, packet.telemetry);
+    if (position.symbolCode == '_')
+        parseWeatherFields(comment, packet.weather);
+    parseAltitudeComment(comment, position);
+    applyBalloonProfile(packet);
+    packet.comment = comment;
+}
+
+/**
+ * @brief Décode une position non compressée "DDMM.mmN/DDDMM.mmW$" (19 caractères).
+ */
+bool decodeUncompressed(std::string_view s, APRSPacket &packet)
+{
+    if (s.size() < 19 || s[4] != '.' || s[14] != '.')
+        return false;
+    int latDeg, latMin, latHun, lonDeg, lonMin, lonHun;
+    if (!parseUInt(s.substr(0, 2), latDeg, true) || !parseUInt(s.substr(2, 2), latMin, true)
+        || !parseUInt(s.substr(5, 2), latHun, true) || !parseUInt(s.substr(9, 3), lonDeg, true)
+        || !parseUInt(s.substr(12, 2), lonMin, true) || !parseUInt(s.substr(15, 2), lonHun, true))
+        return false;
+
+    char ns = s[7];
+    char ew = s[17];
+    if ((ns != 'N' && ns != 'S') || (ew != 'E' && ew != 'W'))
+        return false;
+
+    APRSPosition &position = packet.position;
+    position.latitude  = latDeg + (latMin + latHun / 100.0) / 60.0;
+    position.longitude = lonDeg + (lonMin + lonHun / 100.0) / 60.0;
+    if (ns == 'S')
+        position.latitude = -position.latitude;
+    if (ew == 'W')
+        position.longitude = -position.longitude;
+    position.symbolTable = s[8];
+    position.symbolCode  = s[18];
+    position.compressed  = false;
+
+    parsePositionComment(s.substr(19), packet);
+    return true;
+}
+
+/**
+ * @brief Décode une position compressée base91 "/YYYYXXXX$csT" (13 caractères).
+ */
+bool decodeCompressed(std::string_view s, APRSPacket &packet)
+{
+    if (s.size() < 13)
+        return false;
+    long y, x;
+    if (!parseBase91(s.substr(1, 4), y) || !parseBase91(s.substr(5, 4), x))
+        return false;
+
+    APRSPosition &position = packet.position;
+    position.symbolTable = s[0];
+    position.latitude    = 90.0 - y / 380926.0;
+    position.longitude   = -180.0 + x / 190463.0;
+    position.symbolCode  = s[9];
+    position.compressed  = true;
+
+    char c = s[10];
+    char sp = s[11];
+    char t = s[12];
+    if (c != ' ' && t >= '!' && t <= '{') {
+        int cs = c - 33;
+        int ss = sp - 33;
+        if (((t - 33) >> 3 & 0x03) == 0x02) {
+            // Source GGA : "cs" porte l'altitude (1.002^cs pieds)
+            position.altitude = std::pow(1.002, cs * 91 + ss) * FEET_TO_M;
+            position.hasAltitude = true;
+        } else if (cs >= 0 && cs <= 89) {
+            position.course = cs * 4;
+            position.speed = (std::pow(1.08, ss) - 1.0) * KNOTS_TO_KMH;
+            position.hasCourseSpeed = true;
+        }
+    }
+
+    parsePositionComment(s.substr(13), packet);
+    return true;
+}
+
+/**
+ * @brief Décode une position compressée ou non selon son premier caractère.
+ */
+bool decodePositionBody(std::string_view s, APRSPacket &packet)
+{
+    if (s.empty())
+        return false;
+    packet.type = APRSPacketType::Position;
+    if (isDigit(s[0]) || s[0] == ' ')
+        return decodeUncompressed(s, packet);
+    return decodeCompressed(s, packet);
+}
+
+/**
+ * @brief '!' et '=' : position sans horodatage.
+ */
+bool decodePosition(std::string_view, std::string_view info, APRSPacket &packet)
+{
+    return decodePositionBody(info.substr(1), packet);
+}
+
+/**
+ * @brief '/' et '@' : position avec horodatage de 7 caractères.
+ */
+bool decodeTimestampedPosition(std::string_view, std::string_view info, APRSPacket &packet)
+{
+    if (info.size() < 8)
+        return false;
+    packet.timestamp = info.substr(1, 7);
+    return decodePositionBody(info.substr(8), packet);
+}
+
+/**
+ * @brief Valeur d'un chiffre de latitude Mic-E codé dans l'indicatif destination.
+ */
+int miceDigit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'J')
+        return c - 'A';
+    if (c >= 'P' && c <= 'Y')
+        return c - 'P';
+    if (c == 'K' || c == 'L' || c == 'Z')
+        return 0;
+    return -1;
+}
+
+/**
+ * @brief '`' et '\'' (ainsi que 0x1C/0x1D) : position Mic-E.
+ */
+bool decodeMicE(std::string_view destination, std::string_view info, APRSPacket &packet)
+{
+    std::size_t dash = destination.find('-');
+    if (dash != std::string_view::npos)
+        destination = destination.substr(0, dash);
+    if (destination.size() < 6 || info.size() < 9)
+        return false;
+
+    int digits[6];
+    for (int i = 0; i < 6; ++i) {
+        digits[i] = miceDigit(destination[i]);
+        if (digits[i] < 0)
+            return false;
+    }
+    auto flag = [&destination](int i) { return destination[i] >= 'P' && destination[i] <= 'Z'; };
+
+    APRSPosition &position = packet.position;
+    position.latitude = digits[0] * 10 + digits[1]
+                        + (digits[2] * 10 + digits[3] + (digits[4] * 10 + digits[5]) / 100.0) / 60.0;
+    if (!flag(3))
+        position.latitude = -position.latitude;
+
+    int d = info[1] - 28;
+    if (flag(4))
+        d += 100;
+    if (d >= 180 && d <= 189)
+        d -= 80;
+    else if (d >= 190 && d <= 199)
+        d -= 190;
+    int m = info[2] - 28;
+    if (m >= 60)
+        m -= 60;
+    int h = info[3] - 28;
+    if (d < 0 || d > 179 || m < 0 || h < 0 || h > 99)
+        return false;
+    position.longitude = d + (m + h / 100.0) / 60.0;
+    if (flag(5))
+        position.longitude = -position.longitude;
+
+    int sp = info[4] - 28;
+    int dc = info[5] - 28;
+    int se = info[6] - 28;
+    int speed = sp * 10 + dc / 10;
+    int course = (dc % 10) * 100 + se;
+    if (speed >= 800)
+        speed -= 800;
+    if (course >= 400)
+        course -= 400;
+    position.speed = speed * KNOTS_TO_KMH;
+    position.course = course;
+    position.hasCourseSpeed = true;
+    position.symbolCode  = info[7];
+    position.symbolTable = info[8];
+    position.compressed  = false;
+
+    // Altitude Mic-E : trois caractères base91 suivis de '}' (mètres, décalage de 10 km)
+    std::string_view comment = info.substr(9);
+    std::size_t brace = comment.find('}');
+    if (brace != std::string_view::npos && brace >= 3 && brace <= 4) {
+        long alt;
+        if (parseBase91(comment.substr(brace - 3, 3), alt)) {
+            position.altitude = alt - 10000;
+            position.hasAltitude = true;
+            comment.remove_prefix(brace + 1);
+        }
+    }
+    packet.type = APRSPacketType::MicE;
+    packet.comment = comment;
+    return true;
+}
+
+/**
+ * @brief ':' : message adressé ":ADRESSE :texte{id".
+ */
+bool decodeMessage(std::string_view, std::string_view info, APRSPacket &packet)
+{
+    if (info.size() < 11 || info[10] != ':')
+        return false;
+
+    APRSMessage &message = packet.message;
+    std::string_view addressee = info.substr(1, 9);
+    while (!addressee.empty() && addressee.back() == ' ')
+        addressee.remove_suffix(1);
+    message.addressee = addressee;
+
+    std::string_view text = info.substr(11);
+    std::size_t brace = text.rfind('{');
+    if (brace != std::string_view::npos) {
+        std::string_view id = text.substr(brace + 1);
+        std::size_t close = id.find('}');
+        if (close != std::string_view::npos)
+            id = id.substr(0, close);
+        message.id = id;
+        text = text.substr(0, brace);
+    }
+    message.text = text;
+    message.isAck = text.substr(0, 3) == "ack";
+    message.isRej = text.substr(0, 3) == "rej";
+    if ((message.isAck || message.isRej) && message.id.empty())
+        message.id = text.substr(3);
+
+    packet.type = APRSPacketType::Message;
+    return true;
+}
+
+/**
+ * @brief 'T' : télémétrie "T#sss,a1,a2,a3,a4,a5,bbbbbbbb".
+ *
+ * Le numéro de séquence a au plus trois chiffres (spécification APRS) ; sinon il est inconnu (-1).
+ */
+bool decodeTelemetry(std::string_view, std::string_view info, APRSPacket &packet)
+{
+    if (info.size() < 3 || info[1] != '#')
+        return false;
+
+    APRSTelemetry &telemetry = packet.telemetry;
+    std::string_view rest = info.substr(2);
+    int field = 0;
+    while (!rest.empty() && field <= APRSTelemetry::MAX_ANALOG + 1) {
+        std::size_t comma = rest.find(',');
+        std::string_view token = rest.substr(0, comma);
+        if (field == 0) {
+            int seq;
+            telemetry.sequence = (token.size() <= 3 && parseUInt(token, seq)) ? seq : -1;
+        } else if (field <= APRSTelemetry::MAX_ANALOG) {
+            double value;
+            if (!parseDecimal(token, value))
+                return false;
+            telemetry.analog[telemetry.analogCount++] = value;
+        } else {
+            std::uint8_t bits = 0;
+            std::size_t n = 0;
+            for (; n < token.size() && n < 8 && (token[n] == '0' || token[n] == '1'); ++n)
+                bits = static_cast<std::uint8_t>((bits << 1) | (token[n] - '0'));
+            if (n == 8) {
+                telemetry.digital = bits;
+                telemetry.hasDigital = true;
+                packet.comment = token.substr(8);
+            }
+        }
+        ++field;
+        if (comma == std::string_view::npos)
+            break;
+        rest.remove_prefix(comma + 1);
+    }
+    if (telemetry.analogCount == 0)
+        return false;
+    packet.type = APRSPacketType::Telemetry;
+    return true;
+}
+
+/**
+ * @brief '>' : statut, horodatage "DDHHMMz" optionnel.
+ */
+bool decodeStatus(std::string_view, std::string_view info, APRSPacket &packet)
+{
+    std::string_view text = info.substr(1);
+    if (text.size() >= 7 && text[6] == 'z') {
+        int ts;
+        if (parseUInt(text.substr(0, 6), ts)) {
+            packet.timestamp = text.substr(0, 7);
+            text.remove_prefix(7);
+        }
+    }
+    packet.comment = text;
+    packet.type = APRSPacketType::Status;
+    return true;
+}
+
+/**
+ * @brief '_' : rapport météo sans position "MMDDHHMMc...s...t...".
+ */
+bool decodeWeather(std::string_view, std::string_view info, APRSPacket &packet)
+{
+    if (info.size() < 9)
+        return false;
+    packet.timestamp = info.substr(1, 8);
+    parseWeatherFields(info.substr(9), packet.weather);
+    packet.type = APRSPacketType::Weather;
+    return true;
+}
+
+/**
+ * @brief Construit la table d'aiguillage indexée par l'identifiant de type de donnée.
+ */
+constexpr std::array<Decoder, 256> makeDecoderTable()
+{
+    std::array<Decoder, 256> table{};
+    table['!'] = decodePosition;
+    table['='] = decodePosition;
+    table['/'] = decodeTimestampedPosition;
+    table['@'] = decodeTimestampedPosition;
+    table['`'] = decodeMicE;
+    table['\''] = decodeMicE;
+    table[0x1C] = decodeMicE;
+    table[0x1D] = decodeMicE;
+    table[':'] = decodeMessage;
+    table['T'] = decodeTelemetry;
+    table['>'] = decodeStatus;
+    table['_'] = decodeWeather;
+    return table;
+}
+
+constexpr std::array<Decoder, 256> DECODERS = makeDecoderTable();
+
+} // namespace
+
+/**
+ * @brief Définit les indicatifs de la nacelle.
+ * @param callsigns Les indicatifs, SSID compris.
+ */
+void APRSParser::setBalloonCallsigns(const std::vector<std::string> &callsigns)
+{
+    balloonCallsigns() = callsigns;
+}
+
+/**
+ * @brief Indique si un indicatif est celui de la nacelle.
+ * @param callsign L'indicatif source.
+ * @return bool @c true s'il figure dans la liste.
+ */
+bool APRSParser::isBalloon(std::string_view callsign)
+{
+    for (const std::string &balloon : balloonCallsigns()) {
+        if (callsign == balloon)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Analyse une trame au format TNC2.
+ *
+ * Découpe l'en-tête en source, destination et chemin, puis délègue l'analyse du champ
+ * d'information à parseInfo. Aucune donnée n'est recopiée.
+ *
+ * @param tnc2 La trame TNC2 complète.
+ * @param packet Le paquet à remplir.
+ * @return bool @c true si la trame a été décodée, @c false sinon.
+ */
+bool APRSParser::parseTNC2(std::string_view tnc2, APRSPacket &packet)
+{
+    packet = APRSPacket();
+
+    std::size_t posGT = tnc2.find('>');
+    std::size_t posColon = tnc2.find(':');
+    if (posGT == std::string_view::npos || posColon == std::string_view::npos || posColon < posGT)
+        return false;
+
+    packet.source = tnc2.substr(0, posGT);
+    std::string_view header = tnc2.substr(posGT + 1, posColon - posGT - 1);
+    std::size_t comma = header.find(',');
+    packet.destination = header.substr(0, comma);
+    if (comma != std::string_view::npos)
+        packet.path = header.substr(comma + 1);
+
+    return parseInfo(packet.destination, tnc2.substr(posColon + 1), packet);
+}
+
+/**
+ * @brief Analyse un champ d'information APRS.
+ *
+ * Sélectionne la fonction de décodage dans la table à partir du premier octet. Les champs du
+ * paquet propres au type sont remis à zéro avant le décodage.
+ *
+ * @param destination L'indicatif destination (utilisé pour Mic-E).
+ * @param info Le champ d'information.
+ * @param packet Le paquet à remplir.
+ * @return bool @c true si le paquet a été décodé, @c false sinon.
+ */
+bool APRSParser::parseInfo(std::string_view destination, std::string_view info, APRSPacket &packet)
+{
+    packet.type = APRSPacketType::Unknown;
+    packet.info = info;
+    packet.timestamp = std::string_view();
+    packet.comment = std::string_view();
+    packet.position = APRSPosition();
+    packet.weather = APRSWeather();
+    packet.telemetry = APRSTelemetry();
+    packet.acceleration = APRSAcceleration();
+    packet.message = APRSMessage();
+
+    if (info.empty())
+        return false;
+    packet.dataType = info[0];
+
+    Decoder decoder = DECODERS[static_cast<unsigned char>(info[0])];
+    if (!decoder || !decoder(destination, info, packet)) {
+        packet.type = APRSPacketType::Unknown;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Retourne le nom lisible d'un type de paquet.
+ *
+ * @param type Le type de paquet.
+ * @return const char* Le nom du type.
+ */
+const char *APRSParser::typeName(APRSPacketType type)
+{
+    switch (type) {
+    case APRSPacketType::Position:  return "position";
+    case APRSPacketType::MicE:      return "mic-e";
+    case APRSPacketType::Message:   return "message";
+    case APRSPacketType::Telemetry: return "telemetrie";
+    case APRSPacketType::Status:    return "statut";
+    case APRSPacketType::Weather:   return "meteo";
+    default:                        return "inconnu";
+    }
+}
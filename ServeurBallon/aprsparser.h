@@ -0,0 +1,180 @@
+#ifndef APRSPARSER_H
+#define APRSPARSER_H
+
+/**
+ * @file aprsparser.h
+ * @brief Déclaration de la classe APRSParser et des structures de paquets APRS décodés.
+ *
+ * Ce fichier définit un analyseur du champ d'information APRS qui ne recopie aucune donnée :
+ * les champs texte du paquet décodé sont des vues (std::string_view) sur le tampon d'origine.
+ * L'aiguillage se fait sur l'identifiant de type de donnée (premier octet) via une table de 256 entrées.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Type de paquet APRS reconnu par l'analyseur.
+ */
+enum class APRSPacketType : std::uint8_t {
+    Unknown,    ///< Identifiant de type non géré ou trame invalide.
+    Position,   ///< Position non compressée ou compressée (base91), avec ou sans horodatage.
+    MicE,       ///< Position au format Mic-E (encodée en partie dans l'indicatif destination).
+    Message,    ///< Message APRS adressé (":ADRESSE :texte{id").
+    Telemetry,  ///< Trame de télémétrie "T#".
+    Status,     ///< Trame de statut ('>').
+    Weather     ///< Rapport météo sans position ('_').
+};
+
+/**
+ * @brief Position décodée (degrés décimaux, mètres, km/h).
+ */
+struct APRSPosition {
+    double latitude = 0.0;      ///< Latitude en degrés (positive au nord).
+    double longitude = 0.0;     ///< Longitude en degrés (positive à l'est).
+    double altitude = 0.0;      ///< Altitude en mètres (valide si hasAltitude).
+    double speed = 0.0;         ///< Vitesse en km/h (valide si hasCourseSpeed).
+    int course = 0;             ///< Cap en degrés (valide si hasCourseSpeed).
+    char symbolTable = 0;       ///< Table de symboles APRS.
+    char symbolCode = 0;        ///< Code de symbole APRS.
+    bool hasAltitude = false;   ///< Indique si une altitude a été trouvée.
+    bool hasCourseSpeed = false;///< Indique si le cap et la vitesse sont présents.
+    bool compressed = false;    ///< Indique si la position était compressée en base91.
+};
+
+/**
+ * @brief Mesures météo extraites des champs "tNNN", "hNN", "bNNNNN" (format APRS météo).
+ */
+struct APRSWeather {
+    double temperature = 0.0;       ///< Température en degrés Celsius.
+    double pressure = 0.0;          ///< Pression en hPa.
+    int humidity = 0;               ///< Humidité relative en %.
+    bool hasTemperature = false;    ///< Indique si la température est présente.
+    bool hasPressure = false;       ///< Indique si la pression est présente.
+    bool hasHumidity = false;       ///< Indique si l'humidité est présente.
+};
+
+/**
+ * @brief Télémétrie : trame "T#sss,a1,a2,a3,a4,a5,bbbbbbbb" ou extension compressée "|ss1122334455dd|"
+ *        du commentaire d'une position (base91, deux caractères par valeur).
+ */
+struct APRSTelemetry {
+    static constexpr int MAX_ANALOG = 5;    ///< Nombre maximal de voies analogiques.
+
+    int sequence = -1;              ///< Numéro de séquence (-1 si "MIC" ou absent).
+    double analog[MAX_ANALOG] = {}; ///< Valeurs analogiques brutes.
+    int analogCount = 0;            ///< Nombre de voies analogiques présentes.
+    std::uint8_t digital = 0;       ///< Bits numériques (bit 7 = premier caractère).
+    bool hasDigital = false;        ///< Indique si les bits numériques sont présents.
+    bool compressed = false;        ///< Indique si la télémétrie était compressée en base91.
+};
+
+/**
+ * @brief Accélérations de la nacelle en g, décodées de sa télémétrie compressée.
+ */
+struct APRSAcceleration {
+    double x = 0.0;                 ///< Axe x.
+    double y = 0.0;                 ///< Axe y.
+    double z = 0.0;                 ///< Axe z.
+    bool hasAcceleration = false;   ///< Indique si les accélérations sont présentes.
+};
+
+/**
+ * @brief Message APRS adressé.
+ */
+struct APRSMessage {
+    std::string_view addressee; ///< Destinataire du message (sans les espaces de remplissage).
+    std::string_view text;      ///< Texte du message, sans l'identifiant.
+    std::string_view id;        ///< Identifiant du message (après '{'), vide si absent.
+    bool isAck = false;         ///< Indique un accusé de réception ("ack").
+    bool isRej = false;         ///< Indique un rejet ("rej").
+};
+
+/**
+ * @brief Paquet APRS décodé.
+ *
+ * Structure étiquetée par @c type : seuls les champs correspondant au type sont significatifs.
+ * Les vues texte pointent dans le tampon analysé et ne sont valides que tant que celui-ci existe.
+ */
+struct APRSPacket {
+    APRSPacketType type = APRSPacketType::Unknown; ///< Type du paquet.
+    char dataType = 0;                  ///< Identifiant de type de donnée (premier octet du champ d'information).
+    std::string_view source;            ///< Indicatif source (si analysé depuis une trame TNC2).
+    std::string_view destination;       ///< Indicatif destination.
+    std::string_view path;              ///< Chemin de digipeaters (sans la destination).
+    std::string_view info;              ///< Champ d'information complet.
+    std::string_view timestamp;         ///< Horodatage brut (7 ou 8 caractères), vide si absent.
+    std::string_view comment;           ///< Commentaire ou texte libre restant.
+    APRSPosition position;              ///< Position (types Position et MicE).
+    APRSWeather weather;                ///< Mesures météo (symbole '_' ou type Weather).
+    APRSTelemetry telemetry;            ///< Télémétrie (type Telemetry, ou compressée dans une position).
+    APRSAcceleration acceleration;      ///< Accélérations (télémétrie compressée de la nacelle).
+    APRSMessage message;                ///< Message (type Message).
+};
+
+/**
+ * @brief Analyseur du champ d'information APRS.
+ *
+ * La classe APRSParser décode sans allocation les positions (non compressées, compressées base91,
+ * Mic-E), les messages avec identifiant, la télémétrie "T#" et compressée, le statut et les champs
+ * météo. La télémétrie compressée d'une position émise par la nacelle (setBalloonCallsigns()) avec
+ * cinq voies et des bits numériques suit son profil : température, pression et humidité sont rendues
+ * dans les champs météo, les accélérations dans @c acceleration. Celle des autres stations, même au
+ * symbole ballon ("/O"), reste brute (voies analogiques et bits).
+ * Elle ne dépend pas de Qt afin de pouvoir être utilisée dans les outils et bancs d'essai.
+ */
+class APRSParser {
+public:
+    static constexpr const char *DEFAULT_BALLOON_CALLSIGN = "F4KMN-8"; ///< Indicatif de la nacelle par défaut (Reception).
+
+    /**
+     * @brief Définit les indicatifs de la nacelle, dont la télémétrie compressée suit son profil.
+     *
+     * À appeler au lancement, avant tout décodage : la liste n'est pas protégée contre les accès
+     * concurrents des threads de décodage.
+     *
+     * @param callsigns Les indicatifs, SSID compris ("F4KMN-8").
+     */
+    static void setBalloonCallsigns(const std::vector<std::string> &callsigns);
+
+    /**
+     * @brief Indique si un indicatif est celui de la nacelle.
+     * @param callsign L'indicatif source, SSID compris.
+     * @return bool @c true s'il figure dans la liste de setBalloonCallsigns().
+     */
+    static bool isBalloon(std::string_view callsign);
+
+    /**
+     * @brief Analyse une trame au format TNC2 ("SRC>DEST,PATH:info").
+     *
+     * @param tnc2 La trame TNC2 complète.
+     * @param packet Le paquet à remplir (réinitialisé au préalable).
+     * @return bool @c true si l'en-tête est valide et que le type de donnée est reconnu, @c false sinon.
+     */
+    static bool parseTNC2(std::string_view tnc2, APRSPacket &packet);
+
+    /**
+     * @brief Analyse un champ d'information APRS.
+     *
+     * L'indicatif destination est nécessaire au décodage Mic-E.
+     *
+     * @param destination L'indicatif destination (avec ou sans SSID).
+     * @param info Le champ d'information, identifiant de type inclus.
+     * @param packet Le paquet à remplir (les champs d'en-tête déjà renseignés sont conservés).
+     * @return bool @c true si le type de donnée est reconnu et décodé, @c false sinon.
+     */
+    static bool parseInfo(std::string_view destination, std::string_view info, APRSPacket &packet);
+
+    /**
+     * @brief Retourne le nom lisible d'un type de paquet.
+     * @param type Le type de paquet.
+     * @return const char* Le nom du type ("position", "mic-e", ...).
+     */
+    static const char *typeName(APRSPacketType type);
+};
+
+#endif // APRSPARSER_H
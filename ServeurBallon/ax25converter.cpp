@@ -143,14 +143,45 @@ QString AX25Converter::decodeAX25Address(const QByteArray &addr7)
     if (addr7.size() < 7)
         return QString();
 
-    QByteArray callsign(6, ' ');
+    char text[MAX_ADDRESS_LENGTH];
+    int length = decodeAX25Address(addr7.constData(), text);
+    return QString::fromLatin1(text, length);
+}
+
+/**
+ * @brief Décode une adresse AX.25 sur 7 octets dans un tampon fourni.
+ *
+ * Les espaces de bourrage de l'indicatif sont supprimés et le SSID est ajouté s'il est non nul.
+ *
+ * @param addr7 Pointeur vers les 7 octets de l'adresse AX.25.
+ * @param out Tampon de sortie d'au moins MAX_ADDRESS_LENGTH caractères.
+ * @return int Le nombre de caractères écrits.
+ */
+int AX25Converter::decodeAX25Address(const char *addr7, char *out)
+{
+    int length = 0;
     for (int i = 0; i < 6; ++i) {
-        unsigned char c = static_cast<unsigned char>(addr7.at(i));
-        c >>= 1;
-        callsign[i] = static_cast<char>(c);
+        char c = static_cast<char>(static_cast<unsigned char>(addr7[i]) >> 1);
+        if (c != ' ')
+            length = i + 1;
+        out[i] = c;
+    }
+    // Suppression des espaces de tête éventuels, comme QString::trimmed()
+    int start = 0;
+    while (start < length && out[start] == ' ')
+        ++start;
+    if (start > 0) {
+        for (int i = start; i < length; ++i)
+            out[i - start] = out[i];
+        length -= start;
+    }
+
+    unsigned int rawSsid = (static_cast<unsigned char>(addr7[6]) >> 1) & 0x0F;
+    if (rawSsid != 0) {
+        out[length++] = '-';
+        if (rawSsid >= 10)
+            out[length++] = '1';
+        out[length++] = static_cast<char>('0' + rawSsid % 10);
     }
-    QString cs = QString::fromLatin1(callsign).trimmed();
-    unsigned char ssidByte = static_cast<unsigned char>(addr7.at(6));
-    unsigned int rawSsid = (ssidByte >> 1) & 0x0F;
-    return (rawSsid == 0) ? cs : QString("%1-%2").arg(cs).arg(rawSsid);
+    return length;
 }
@@ -25,6 +25,8 @@
 class AX25Converter : public QObject {
     Q_OBJECT
 public:
+    static constexpr int MAX_ADDRESS_LENGTH = 9; ///< Longueur maximale d'une adresse décodée ("CALL-SSID").
+
     /**
      * @brief Constructeur de la classe AX25Converter.
      * @param parent Pointeur vers l'objet parent (par défaut nullptr).
@@ -75,6 +77,17 @@ public:
      * @return QString L'adresse décodée sous forme de chaîne.
      */
     static QString decodeAX25Address(const QByteArray &addr7);
+
+    /**
+     * @brief Décode une adresse AX.25 sur 7 octets dans un tampon fourni.
+     *
+     * Variante sans allocation de decodeAX25Address, utilisée lors de la construction des trames.
+     *
+     * @param addr7 Pointeur vers les 7 octets de l'adresse AX.25.
+     * @param out Tampon de sortie d'au moins MAX_ADDRESS_LENGTH caractères (non terminé par '\0').
+     * @return int Le nombre de caractères écrits.
+     */
+    static int decodeAX25Address(const char *addr7, char *out);
 };
 
 #endif // AX25CONVERTER_H
@@ -0,0 +1,117 @@
+#include "callsigntable.h"
+
+/**
+ * @file callsigntable.cpp
+ * @brief Implémentation de la classe CallsignTable.
+ *
+ * Ce fichier contient la recherche et l'ajout des indicatifs dans la table d'internement.
+ */
+
+/**
+ * @brief Constructeur de la table : l'identifiant 0 est réservé à l'indicatif vide.
+ */
+CallsignTable::CallsignTable()
+{
+    m_names.append(QString());
+}
+
+/**
+ * @brief Retourne l'instance unique de la table.
+ *
+ * @return CallsignTable& La table partagée.
+ */
+CallsignTable &CallsignTable::instance()
+{
+    static CallsignTable table;
+    return table;
+}
+
+/**
+ * @brief Compacte un indicatif court sur 64 bits.
+ *
+ * Chaque caractère occupe 7 bits ; les caractères étant non nuls, deux indicatifs différents
+ * donnent toujours deux clés différentes.
+ *
+ * @param callsign L'indicatif.
+ * @param key La clé calculée.
+ * @return bool @c true si l'indicatif a pu être compacté, @c false sinon.
+ */
+bool CallsignTable::packKey(std::string_view callsign, quint64 &key)
+{
+    if (callsign.size() > 9)
+        return false;
+    key = 0;
+    for (char c : callsign) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (u == 0 || u > 0x7F)
+            return false;
+        key = (key << 7) | u;
+    }
+    return true;
+}
+
+/**
+ * @brief Retourne l'identifiant d'un indicatif, en l'ajoutant à la table si nécessaire.
+ *
+ * La recherche se fait sous verrou en lecture ; le verrou en écriture n'est pris que pour
+ * un indicatif encore inconnu.
+ *
+ * @param callsign L'indicatif.
+ * @return CallsignId L'identifiant de l'indicatif, ou NONE si la chaîne est vide.
+ */
+CallsignId CallsignTable::intern(std::string_view callsign)
+{
+    if (callsign.empty())
+        return NONE;
+
+    CallsignTable &table = instance();
+    quint64 key = 0;
+    bool packed = packKey(callsign, key);
+    QByteArray longKey;
+    if (!packed)
+        longKey = QByteArray(callsign.data(), static_cast<int>(callsign.size()));
+
+    {
+        QReadLocker locker(&table.m_lock);
+        CallsignId id = packed ? table.m_shortIds.value(key, NONE) : table.m_longIds.value(longKey, NONE);
+        if (id != NONE)
+            return id;
+    }
+
+    QWriteLocker locker(&table.m_lock);
+    CallsignId id = packed ? table.m_shortIds.value(key, NONE) : table.m_longIds.value(longKey, NONE);
+    if (id == NONE) {
+        id = static_cast<CallsignId>(table.m_names.size());
+        table.m_names.append(QString::fromLatin1(callsign.data(), static_cast<int>(callsign.size())));
+        if (packed)
+            table.m_shortIds.insert(key, id);
+        else
+            table.m_longIds.insert(longKey, id);
+    }
+    return id;
+}
+
+/**
+ * @brief Retourne le nom d'un indicatif interné.
+ *
+ * @param id L'identifiant de l'indicatif.
+ * @return QString Le nom de l'indicatif (chaîne partagée), ou une chaîne vide si l'identifiant est inconnu.
+ */
+QString CallsignTable::name(CallsignId id)
+{
+    CallsignTable &table = instance();
+    QReadLocker locker(&table.m_lock);
+    return table.m_names.value(static_cast<int>(id));
+}
+
+/**
+ * @brief Retourne le nombre d'indicatifs internés.
+ *
+ * @return int Le nombre d'indicatifs (l'indicatif vide n'est pas compté).
+ */
+int CallsignTable::size()
+{
+    CallsignTable &table = instance();
+    QReadLocker locker(&table.m_lock);
+    return table.m_names.size() - 1;
+}
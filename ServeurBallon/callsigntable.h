@@ -0,0 +1,84 @@
+#ifndef CALLSIGNTABLE_H
+#define CALLSIGNTABLE_H
+
+/**
+ * @file callsigntable.h
+ * @brief Déclaration de la classe CallsignTable.
+ *
+ * Ce fichier définit la table d'internement des indicatifs : chaque indicatif rencontré reçoit
+ * un identifiant numérique compact, stable pendant toute l'exécution, et son nom n'est stocké
+ * qu'une seule fois.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+#include <string_view>
+
+/**
+ * @brief Identifiant numérique d'un indicatif interné (0 : aucun indicatif).
+ */
+using CallsignId = quint32;
+
+/**
+ * @brief Table d'internement des indicatifs.
+ *
+ * Les indicatifs usuels (9 caractères ASCII au plus, SSID compris) sont compactés sur 64 bits :
+ * la recherche d'un indicatif déjà connu ne fait aucune allocation. Les indicatifs plus longs
+ * passent par une table secondaire. La table est partagée par tous les threads.
+ */
+class CallsignTable {
+public:
+    static constexpr CallsignId NONE = 0; ///< Identifiant réservé à l'indicatif vide.
+
+    /**
+     * @brief Retourne l'identifiant d'un indicatif, en l'ajoutant à la table si nécessaire.
+     *
+     * @param callsign L'indicatif (par exemple "F4KMN-11").
+     * @return CallsignId L'identifiant de l'indicatif, ou NONE si la chaîne est vide.
+     */
+    static CallsignId intern(std::string_view callsign);
+
+    /**
+     * @brief Retourne le nom d'un indicatif interné.
+     *
+     * La chaîne retournée est partagée (pas de copie des caractères).
+     *
+     * @param id L'identifiant de l'indicatif.
+     * @return QString Le nom de l'indicatif, ou une chaîne vide si l'identifiant est inconnu.
+     */
+    static QString name(CallsignId id);
+
+    /**
+     * @brief Retourne le nombre d'indicatifs internés.
+     */
+    static int size();
+
+private:
+    CallsignTable();
+
+    /**
+     * @brief Retourne l'instance unique de la table.
+     */
+    static CallsignTable &instance();
+
+    /**
+     * @brief Compacte un indicatif court sur 64 bits (7 bits par caractère).
+     *
+     * @param callsign L'indicatif.
+     * @param key La clé calculée.
+     * @return bool @c false si l'indicatif est trop long ou contient un caractère non ASCII.
+     */
+    static bool packKey(std::string_view callsign, quint64 &key);
+
+    QReadWriteLock m_lock;                  ///< Verrou protégeant la table.
+    QHash<quint64, CallsignId> m_shortIds;  ///< Identifiants des indicatifs compactés.
+    QHash<QByteArray, CallsignId> m_longIds; ///< Identifiants des indicatifs longs.
+    QVector<QString> m_names;               ///< Noms des indicatifs, indexés par identifiant.
+};
+
+#endif // CALLSIGNTABLE_H
@@ -0,0 +1,80 @@
+#include "configuration.h"
+
+#include <QCommandLineParser>
+
+/**
+ * @file configuration.cpp
+ * @brief Implémentation de la lecture de la configuration depuis la ligne de commande.
+ */
+
+/**
+ * @brief Construit la configuration à partir des arguments de la ligne de commande.
+ *
+ * Les options absentes conservent leur valeur par défaut. L'option --help affiche l'aide et
+ * termine l'application.
+ *
+ * @param arguments Les arguments de l'application.
+ * @return Configuration La configuration résultante.
+ */
+Configuration Configuration::fromArguments(const QStringList &arguments)
+{
+    Configuration config;
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Station sol du ballon : passerelle LoRa / APRS-IS");
+    parser.addHelpOption();
+
+    QCommandLineOption aprsHostOption("aprs-host", "Serveur APRS-IS.", "hote", config.aprsHost);
+    QCommandLineOption aprsPortOption("aprs-port", "Port du serveur APRS-IS.", "port",
+                                      QString::number(config.aprsPort));
+    QCommandLineOption serialPortOption("port", "Port série du module LoRa, ouvert dès le lancement.", "port");
+    parser.addOption(aprsHostOption);
+    parser.addOption(aprsPortOption);
+    QCommandLineOption sqliteOption("sqlite", "Fichier de la base SQLite locale.", "fichier", config.sqlitePath);
+    QCommandLineOption noSqliteOption("no-sqlite", "Désactive la base SQLite locale.");
+    QCommandLineOption noMysqlOption("no-mysql", "Désactive la base MySQL distante.");
+    QCommandLineOption kissPortOption("kiss-port", "Port du serveur KISS sur TCP partageant le modem (0 : désactivé, "
+                                      "8001 comme Direwolf).", "port", QString::number(config.kissPort));
+    QCommandLineOption kissBindOption("kiss-bind", "Adresse d'écoute du serveur KISS. Tout client peut faire émettre "
+                                      "la radio : 0.0.0.0 ne l'expose au réseau que sur un réseau de confiance.",
+                                      "adresse", config.kissBind);
+    QCommandLineOption traceOption("trace", "Active le traçage des étapes de réception, écrit dans ce fichier "
+                                   "(format Chrome / Perfetto) à la fermeture ou sur Ctrl+Maj+T.", "fichier");
+    QCommandLineOption balloonOption("balloon", "Indicatifs de la nacelle, séparés par des virgules : seule leur "
+                                     "télémétrie suit le profil de la nacelle et alimente le suivi du vol.",
+                                     "indicatifs", config.balloonCallsigns);
+    QCommandLineOption historyOption("history", "Nombre de trames conservées dans la table de l'interface "
+                                     "(environ 1 Ko de mémoire par trame).", "trames",
+                                     QString::number(config.frameHistory));
+    parser.addOption(serialPortOption);
+    parser.addOption(sqliteOption);
+    parser.addOption(noSqliteOption);
+    parser.addOption(noMysqlOption);
+    parser.addOption(kissPortOption);
+    parser.addOption(kissBindOption);
+    parser.addOption(traceOption);
+    parser.addOption(balloonOption);
+    parser.addOption(historyOption);
+
+    parser.process(arguments);
+
+    config.aprsHost = parser.value(aprsHostOption);
+    bool ok = false;
+    int port = parser.value(aprsPortOption).toInt(&ok);
+    if (ok && port > 0 && port < 65536)
+        config.aprsPort = port;
+    config.serialPort = parser.value(serialPortOption);
+    config.sqlitePath = parser.isSet(noSqliteOption) ? QString() : parser.value(sqliteOption);
+    config.mysqlEnabled = !parser.isSet(noMysqlOption);
+    int kissPort = parser.value(kissPortOption).toInt(&ok);
+    if (ok && kissPort >= 0 && kissPort < 65536)
+        config.kissPort = kissPort;
+    config.kissBind = parser.value(kissBindOption);
+    config.tracePath = parser.value(traceOption);
+    config.balloonCallsigns = parser.value(balloonOption);
+    int history = parser.value(historyOption).toInt(&ok);
+    if (ok && history > 0)
+        config.frameHistory = history;
+
+    return config;
+}
@@ -0,0 +1,41 @@
+#ifndef CONFIGURATION_H
+#define CONFIGURATION_H
+
+/**
+ * @file configuration.h
+ * @brief Déclaration de la structure Configuration.
+ *
+ * Ce fichier définit les paramètres de lancement de ServeurBallon, lus depuis la ligne de commande.
+ * Les valeurs par défaut correspondent au fonctionnement nominal de la station sol.
+ */
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Paramètres de lancement de la station sol.
+ */
+struct Configuration {
+    QString aprsHost = "france.aprs2.net";  ///< Serveur APRS-IS.
+    int aprsPort = 14580;                   ///< Port du serveur APRS-IS.
+    QString serialPort;                     ///< Port série ouvert dès le lancement (vide : choix manuel).
+    QString sqlitePath = "Ballon2025.sqlite"; ///< Base SQLite locale (vide : désactivée).
+    bool mysqlEnabled = true;               ///< Écriture vers la base MySQL distante.
+    int kissPort = 0;                       ///< Port du serveur KISS sur TCP (0 : désactivé).
+    QString kissBind = "127.0.0.1";         ///< Adresse d'écoute du serveur KISS (locale par défaut).
+    QString tracePath;                      ///< Fichier de trace des étapes de réception (vide : traçage désactivé).
+    QString balloonCallsigns = "F4KMN-8";   ///< Indicatifs de la nacelle, séparés par des virgules.
+    int frameHistory = 100000;              ///< Trames conservées dans la table de l'interface (environ 1 Ko chacune).
+
+    /**
+     * @brief Construit la configuration à partir des arguments de la ligne de commande.
+     *
+     * Options reconnues : --aprs-host, --aprs-port, --port, --sqlite, --no-sqlite, --no-mysql, --kiss-port, --kiss-bind, --trace, --balloon, --history (et --help).
+     *
+     * @param arguments Les arguments de l'application (QCoreApplication::arguments()).
+     * @return Configuration La configuration résultante.
+     */
+    static Configuration fromArguments(const QStringList &arguments);
+};
+
+#endif // CONFIGURATION_H
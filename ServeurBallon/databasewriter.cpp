@@ -0,0 +1,130 @@
+#include "databasewriter.h"
+#include "mysqlmanager.h"
+#include "sqlitestorage.h"
+
+#include <utility>
+
+/**
+ * @file databasewriter.cpp
+ * @brief Implémentation de la classe DatabaseWriter.
+ *
+ * Ce fichier contient la création d'un écrivain et d'un thread par support de stockage,
+ * la diffusion des écritures vers ces écrivains et leur arrêt ordonné.
+ */
+
+/**
+ * @brief Constructeur de la classe DatabaseWriter.
+ *
+ * Les supports ne sont créés qu'au démarrage (voir start()).
+ *
+ * @param config Paramètres de lancement.
+ * @param parent Pointeur vers l'objet parent (par défaut nullptr).
+ */
+DatabaseWriter::DatabaseWriter(const Configuration &config, QObject *parent)
+    : QObject(parent),
+    m_config(config)
+{
+}
+
+/**
+ * @brief Destructeur de la classe DatabaseWriter.
+ *
+ * L'arrêt de chaque écrivain est demandé par une connexion bloquante : il est traité après
+ * les écritures déjà transmises, qui sont donc écrites avant la fermeture du support.
+ */
+DatabaseWriter::~DatabaseWriter()
+{
+    for (auto &sink : m_sinks) {
+        QMetaObject::invokeMethod(sink->writer, "stop", Qt::BlockingQueuedConnection);
+        sink->thread.quit();
+        sink->thread.wait();
+        delete sink->writer;
+    }
+}
+
+/**
+ * @brief Retourne le nom d'un état de santé.
+ *
+ * @param state L'état.
+ * @return QString Le nom de l'état.
+ */
+QString DatabaseWriter::stateName(DatabaseState state)
+{
+    switch (state) {
+    case DatabaseState::Connecting:  return QStringLiteral("connexion en cours");
+    case DatabaseState::Connected:   return QStringLiteral("connectée");
+    case DatabaseState::Unavailable: return QStringLiteral("indisponible");
+    }
+    return QString();
+}
+
+/**
+ * @brief Crée l'écrivain et le thread de chaque support configuré, puis les démarre.
+ *
+ * Chaque support a son thread : la base SQLite locale reste écrite pendant que la connexion MySQL
+ * attend un serveur injoignable.
+ */
+void DatabaseWriter::start()
+{
+    if (!m_sinks.empty())
+        return;
+    if (!m_config.sqlitePath.isEmpty()) {
+        const QString path = m_config.sqlitePath;
+        addSink([path]() -> StorageBackend * { return new SQLiteStorage(path); });
+    }
+    if (m_config.mysqlEnabled)
+        addSink([]() -> StorageBackend * { return new MySQLManager; });
+}
+
+/**
+ * @brief Crée l'écrivain d'un support dans un nouveau thread et le démarre.
+ *
+ * @param factory Fonction créant le support, appelée dans le thread de l'écrivain.
+ */
+void DatabaseWriter::addSink(StorageWriter::BackendFactory factory)
+{
+    auto sink = std::make_unique<Sink>();
+    sink->writer = new StorageWriter(std::move(factory));
+    sink->writer->moveToThread(&sink->thread);
+    connect(&sink->thread, &QThread::started, sink->writer, &StorageWriter::start);
+    connect(sink->writer, &StorageWriter::stateChanged, this, &DatabaseWriter::stateChanged);
+    connect(sink->writer, &StorageWriter::logMessage, this, &DatabaseWriter::logMessage);
+    sink->thread.start();
+    m_sinks.push_back(std::move(sink));
+}
+
+/**
+ * @brief Met une trame en attente d'écriture sur chaque support.
+ *
+ * La trame est partagée entre les files des supports, sans copie.
+ *
+ * @param frame La trame à enregistrer.
+ */
+void DatabaseWriter::storeFrame(const FramePtr &frame)
+{
+    for (auto &sink : m_sinks)
+        QMetaObject::invokeMethod(sink->writer, "storeFrame", Qt::QueuedConnection, Q_ARG(FramePtr, frame));
+}
+
+/**
+ * @brief Met un événement de vol en attente d'écriture sur chaque support.
+ *
+ * @param event L'événement à enregistrer.
+ */
+void DatabaseWriter::storeFlightEvent(const FlightEvent &event)
+{
+    for (auto &sink : m_sinks)
+        QMetaObject::invokeMethod(sink->writer, "storeFlightEvent", Qt::QueuedConnection, Q_ARG(FlightEvent, event));
+}
+
+/**
+ * @brief Met une prédiction d'atterrissage en attente d'écriture sur chaque support.
+ *
+ * @param prediction La prédiction à enregistrer.
+ */
+void DatabaseWriter::storeLandingPrediction(const LandingPrediction &prediction)
+{
+    for (auto &sink : m_sinks)
+        QMetaObject::invokeMethod(sink->writer, "storeLandingPrediction", Qt::QueuedConnection,
+                                  Q_ARG(LandingPrediction, prediction));
+}
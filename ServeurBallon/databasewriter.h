@@ -0,0 +1,112 @@
+#ifndef DATABASEWRITER_H
+#define DATABASEWRITER_H
+
+/**
+ * @file databasewriter.h
+ * @brief Déclaration de la classe DatabaseWriter.
+ *
+ * Ce fichier définit l'écrivain de base de données qui diffuse les écritures vers un ou plusieurs
+ * supports de stockage (SQLite local, MySQL distant). Chaque support est écrit par son propre
+ * StorageWriter, dans son propre thread : une connexion lente ou perdue ne bloque ni l'interface
+ * ni les autres supports.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QThread>
+
+#include <memory>
+#include <vector>
+
+#include "configuration.h"
+#include "storagewriter.h"
+
+/**
+ * @brief Écrivain asynchrone diffusant les écritures vers plusieurs supports de stockage.
+ *
+ * L'objet vit dans le thread de l'interface : ses slots ne font que transmettre chaque trame,
+ * événement de vol ou prédiction, en file d'attente, à l'écrivain de chaque support. Les états
+ * des supports et leurs messages sont relayés par les signaux stateChanged et logMessage.
+ */
+class DatabaseWriter : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * @brief Constructeur de la classe DatabaseWriter.
+     * @param config Paramètres de lancement (supports de stockage à utiliser).
+     * @param parent Pointeur vers l'objet parent (par défaut nullptr).
+     */
+    explicit DatabaseWriter(const Configuration &config, QObject *parent = nullptr);
+
+    /**
+     * @brief Destructeur : chaque support écrit ses éléments en attente et se ferme, puis son thread s'arrête.
+     */
+    ~DatabaseWriter();
+
+    /**
+     * @brief Retourne le nom d'un état de santé.
+     * @param state L'état.
+     * @return QString Le nom de l'état, pour l'affichage.
+     */
+    static QString stateName(DatabaseState state);
+
+public slots:
+    /**
+     * @brief Crée l'écrivain et le thread de chaque support configuré, puis les démarre.
+     */
+    void start();
+
+    /**
+     * @brief Met une trame en attente d'écriture sur chaque support.
+     * @param frame La trame à enregistrer.
+     */
+    void storeFrame(const FramePtr &frame);
+
+    /**
+     * @brief Met un événement de vol en attente d'écriture sur chaque support.
+     * @param event L'événement à enregistrer.
+     */
+    void storeFlightEvent(const FlightEvent &event);
+
+    /**
+     * @brief Met une prédiction d'atterrissage en attente d'écriture sur chaque support.
+     * @param prediction La prédiction à enregistrer.
+     */
+    void storeLandingPrediction(const LandingPrediction &prediction);
+
+signals:
+    /**
+     * @brief Signal émis à chaque changement d'état d'un support.
+     * @param backend Nom du support ("SQLite", "MySQL").
+     * @param state Le nouvel état.
+     * @param pending Nombre de trames en attente pour ce support.
+     */
+    void stateChanged(const QString &backend, DatabaseState state, int pending);
+
+    /**
+     * @brief Signal pour la journalisation des messages (erreurs, reprise après indisponibilité).
+     * @param msg Le message à journaliser.
+     */
+    void logMessage(const QString &msg);
+
+private:
+    /**
+     * @brief Écrivain d'un support et son thread.
+     */
+    struct Sink {
+        QThread thread;                  ///< Thread dédié au support.
+        StorageWriter *writer = nullptr; ///< Écrivain du support (dans thread).
+    };
+
+    /**
+     * @brief Crée l'écrivain d'un support dans un nouveau thread et le démarre.
+     * @param factory Fonction créant le support, appelée dans ce thread.
+     */
+    void addSink(StorageWriter::BackendFactory factory);
+
+    Configuration m_config;                       ///< Paramètres de lancement.
+    std::vector<std::unique_ptr<Sink>> m_sinks;   ///< Supports de stockage (diffusion).
+};
+
+#endif // DATABASEWRITER_H
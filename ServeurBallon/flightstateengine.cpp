@@ -0,0 +1,281 @@
+#include "flightstateengine.h"
+
+#include <cmath>
+
+/**
+ * @file flightstateengine.cpp
+ * @brief Implémentation de la classe FlightStateEngine.
+ *
+ * Ce fichier contient la machine à états de détection des phases de vol. Chaque échantillon
+ * (altitude GPS ou altitude barométrique) met à jour la vitesse verticale lissée, les extrema
+ * d'altitude et la fenêtre d'immobilité, puis fait éventuellement évoluer la phase de vol.
+ */
+
+/**
+ * @brief Constructeur de la classe FlightStateEngine.
+ *
+ * @param parent Pointeur vers l'objet parent (par défaut nullptr).
+ */
+FlightStateEngine::FlightStateEngine(QObject *parent)
+    : QObject(parent)
+{ }
+
+/**
+ * @brief Traite une trame reçue.
+ *
+ * Extrait l'altitude des positions et la pression des champs météo du paquet APRS décodé,
+ * puis alimente le moteur. Seules les trames de la nacelle (APRSParser::isBalloon()) sont retenues :
+ * les voitures de poursuite et les autres stations ne produisent ni phase ni événement de vol.
+ * L'indicatif est repris de la table d'internement, sans copie.
+ *
+ * @param frame La trame reçue.
+ */
+void FlightStateEngine::processFrame(const Frame &frame)
+{
+    const APRSPacket *packet = frame.packet();
+    if (!packet || frame.source() == CallsignTable::NONE || !APRSParser::isBalloon(packet->source))
+        return;
+
+    QString callsign = frame.sourceName();
+    bool isPosition = (packet->type == APRSPacketType::Position || packet->type == APRSPacketType::MicE);
+    if (isPosition && packet->position.hasAltitude)
+        addPosition(callsign, frame.timestamp(), packet->position.latitude,
+                    packet->position.longitude, packet->position.altitude);
+    if (packet->weather.hasPressure)
+        addPressure(callsign, frame.timestamp(), packet->weather.pressure);
+}
+
+/**
+ * @brief Ajoute une position (altitude GPS) pour un indicatif.
+ *
+ * @param callsign Indicatif de la station.
+ * @param timestamp Horodatage (ms depuis l'époque Unix).
+ * @param latitude Latitude en degrés.
+ * @param longitude Longitude en degrés.
+ * @param altitude Altitude en mètres.
+ */
+void FlightStateEngine::addPosition(const QString &callsign, qint64 timestamp,
+                                    double latitude, double longitude, double altitude)
+{
+    State &state = m_states[callsign];
+    state.latitude = latitude;
+    state.longitude = longitude;
+    state.hasPosition = true;
+    update(callsign, GpsSource, timestamp, altitude);
+}
+
+/**
+ * @brief Ajoute une mesure de pression pour un indicatif.
+ *
+ * @param callsign Indicatif de la station.
+ * @param timestamp Horodatage (ms depuis l'époque Unix).
+ * @param pressure Pression en hPa.
+ */
+void FlightStateEngine::addPressure(const QString &callsign, qint64 timestamp, double pressure)
+{
+    if (pressure <= 0.0)
+        return;
+    update(callsign, PressureSource, timestamp, pressureToAltitude(pressure));
+}
+
+/**
+ * @brief Retourne la phase de vol courante d'un indicatif.
+ *
+ * @param callsign Indicatif de la station.
+ * @return FlightPhase La phase courante.
+ */
+FlightPhase FlightStateEngine::phase(const QString &callsign) const
+{
+    auto it = m_states.constFind(callsign);
+    return (it != m_states.constEnd()) ? it->phase : FlightPhase::Ground;
+}
+
+/**
+ * @brief Retourne le nom d'un type d'événement.
+ *
+ * @param type Le type d'événement.
+ * @return QString Le nom de l'événement.
+ */
+QString FlightStateEngine::eventName(FlightEventType type)
+{
+    switch (type) {
+    case FlightEventType::Ascent:  return QStringLiteral("ascent");
+    case FlightEventType::Burst:   return QStringLiteral("burst");
+    case FlightEventType::Descent: return QStringLiteral("descent");
+    case FlightEventType::Landed:  return QStringLiteral("landed");
+    }
+    return QString();
+}
+
+/**
+ * @brief Convertit une pression en altitude selon l'atmosphère standard (ISA).
+ *
+ * @param pressure Pression en hPa.
+ * @return double Altitude en mètres.
+ */
+double FlightStateEngine::pressureToAltitude(double pressure)
+{
+    return 44330.77 * (1.0 - std::pow(pressure / 1013.25, 0.190263));
+}
+
+/**
+ * @brief Met à jour l'état d'un indicatif avec un échantillon d'altitude.
+ *
+ * La vitesse verticale instantanée est lissée par une moyenne exponentielle dont le coefficient
+ * dépend de l'intervalle entre deux échantillons d'une même source. Les échantillons aberrants
+ * (vitesse supérieure à MAX_RATE) sont ignorés. Après un atterrissage, une nouvelle montée
+ * (vitesse et gain d'altitude de décollage) ramène la station au sol puis en montée : un même
+ * indicatif peut ainsi enchaîner plusieurs vols.
+ *
+ * @param callsign Indicatif de la station.
+ * @param source Source de l'altitude.
+ * @param timestamp Horodatage (ms).
+ * @param altitude Altitude en mètres.
+ */
+void FlightStateEngine::update(const QString &callsign, Source source, qint64 timestamp, double altitude)
+{
+    State &state = m_states[callsign];
+
+    if (state.hasLast[source]) {
+        qint64 dtMs = timestamp - state.lastTime[source];
+        if (dtMs <= 0)
+            return;
+        double dt = dtMs / 1000.0;
+        double rate = (altitude - state.lastAltitude[source]) / dt;
+        if (std::fabs(rate) > MAX_RATE)
+            return;
+        double alpha = 1.0 - std::exp(-dt / RATE_TIME_CONSTANT);
+        state.verticalRate = state.hasRate ? state.verticalRate + alpha * (rate - state.verticalRate) : rate;
+        state.hasRate = true;
+    } else {
+        state.minAltitude[source] = altitude;
+        state.maxAltitude[source] = altitude;
+        state.maxTime[source] = timestamp;
+    }
+    state.hasLast[source] = true;
+    state.lastTime[source] = timestamp;
+    state.lastAltitude[source] = altitude;
+
+    if (altitude < state.minAltitude[source])
+        state.minAltitude[source] = altitude;
+    if (altitude > state.maxAltitude[source]) {
+        state.maxAltitude[source] = altitude;
+        state.maxTime[source] = timestamp;
+    }
+
+    if (!state.hasRate)
+        return;
+
+    state.descentCount = (state.verticalRate < DESCENT_RATE) ? state.descentCount + 1 : 0;
+
+    switch (state.phase) {
+    case FlightPhase::Landed:
+        // Nouveau lâcher : les extrema ont été réinitialisés à l'atterrissage
+        if (state.verticalRate <= ASCENT_RATE
+            || altitude - state.minAltitude[source] <= ASCENT_GAIN)
+            break;
+        state.phase = FlightPhase::Ground;
+        state.hasAnchor = false;
+        [[fallthrough]];
+    case FlightPhase::Ground:
+        if (state.verticalRate > ASCENT_RATE
+            && altitude - state.minAltitude[source] > ASCENT_GAIN) {
+            state.phase = FlightPhase::Ascent;
+            emitEvent(callsign, state, FlightEventType::Ascent, timestamp, altitude);
+        } else if (state.descentCount >= DESCENT_CONFIRM) {
+            // Station démarrée en cours de descente
+            state.phase = FlightPhase::Descent;
+            emitEvent(callsign, state, FlightEventType::Descent, timestamp, altitude);
+        }
+        break;
+    case FlightPhase::Ascent:
+        if (state.maxAltitude[source] - altitude > BURST_DROP && state.verticalRate < BURST_RATE) {
+            state.phase = FlightPhase::Burst;
+            state.descentCount = 1;
+            emitEvent(callsign, state, FlightEventType::Burst,
+                      state.maxTime[source], state.maxAltitude[source]);
+        } else if (state.descentCount >= DESCENT_CONFIRM) {
+            state.phase = FlightPhase::Descent;
+            emitEvent(callsign, state, FlightEventType::Descent, timestamp, altitude);
+        }
+        break;
+    case FlightPhase::Burst:
+        if (state.descentCount >= DESCENT_CONFIRM) {
+            state.phase = FlightPhase::Descent;
+            emitEvent(callsign, state, FlightEventType::Descent, timestamp, altitude);
+        }
+        break;
+    case FlightPhase::Descent:
+        break;
+    }
+
+    // L'immobilité n'est évaluée que sur les positions GPS, après le début de la descente
+    if (source == GpsSource
+        && (state.phase == FlightPhase::Burst || state.phase == FlightPhase::Descent))
+        updateStationarity(callsign, state, timestamp, altitude);
+}
+
+/**
+ * @brief Met à jour la fenêtre d'immobilité et détecte l'atterrissage.
+ *
+ * La fenêtre est ancrée sur une position de référence : tant que les positions suivantes restent
+ * dans les tolérances verticale et horizontale, l'ancre est conservée. Au-delà de LANDED_WINDOW,
+ * l'atterrissage est signalé avec l'horodatage de l'ancre, et les extrema d'altitude repartent de la
+ * dernière altitude de chaque source pour détecter un éventuel nouveau décollage.
+ *
+ * @param callsign Indicatif de la station.
+ * @param state État de la station.
+ * @param timestamp Horodatage (ms).
+ * @param altitude Altitude en mètres.
+ */
+void FlightStateEngine::updateStationarity(const QString &callsign, State &state,
+                                           qint64 timestamp, double altitude)
+{
+    bool moved = !state.hasAnchor;
+    if (!moved) {
+        double dy = (state.latitude - state.anchorLatitude) * 110540.0;
+        double dx = (state.longitude - state.anchorLongitude) * 111320.0
+                    * std::cos(state.anchorLatitude * M_PI / 180.0);
+        moved = std::fabs(altitude - state.anchorAltitude) > LANDED_ALT_TOL
+                || std::hypot(dx, dy) > LANDED_DIST_TOL;
+    }
+
+    if (moved) {
+        state.hasAnchor = true;
+        state.anchorTime = timestamp;
+        state.anchorAltitude = altitude;
+        state.anchorLatitude = state.latitude;
+        state.anchorLongitude = state.longitude;
+    } else if (timestamp - state.anchorTime >= LANDED_WINDOW) {
+        state.phase = FlightPhase::Landed;
+        for (int source = 0; source < SourceCount; ++source) {
+            state.minAltitude[source] = state.lastAltitude[source];
+            state.maxAltitude[source] = state.lastAltitude[source];
+            state.maxTime[source] = state.lastTime[source];
+        }
+        emitEvent(callsign, state, FlightEventType::Landed, state.anchorTime, state.anchorAltitude);
+    }
+}
+
+/**
+ * @brief Construit et émet un événement de vol.
+ *
+ * @param callsign Indicatif de la station.
+ * @param state État de la station.
+ * @param type Type d'événement.
+ * @param timestamp Horodatage de l'événement (ms).
+ * @param altitude Altitude associée (m).
+ */
+void FlightStateEngine::emitEvent(const QString &callsign, const State &state, FlightEventType type,
+                                  qint64 timestamp, double altitude)
+{
+    FlightEvent event;
+    event.callsign = callsign;
+    event.type = type;
+    event.timestamp = timestamp;
+    event.altitude = altitude;
+    event.latitude = state.latitude;
+    event.longitude = state.longitude;
+    event.verticalRate = state.verticalRate;
+    emit flightEvent(event);
+}
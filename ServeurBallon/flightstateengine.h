@@ -0,0 +1,198 @@
+#ifndef FLIGHTSTATEENGINE_H
+#define FLIGHTSTATEENGINE_H
+
+/**
+ * @file flightstateengine.h
+ * @brief Déclaration de la classe FlightStateEngine.
+ *
+ * Ce fichier définit le moteur incrémental de détection des phases de vol (montée, éclatement,
+ * descente, atterrissage). Il est alimenté par les positions et la pression décodées de la nacelle
+ * et ne conserve qu'un état de taille fixe par indicatif.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QMetaType>
+#include <QHash>
+#include <QString>
+
+#include "frame.h"
+
+/**
+ * @brief Phase de vol courante d'une station.
+ */
+enum class FlightPhase {
+    Ground,     ///< Au sol, avant le décollage.
+    Ascent,     ///< En montée.
+    Burst,      ///< Éclatement détecté, descente non encore confirmée.
+    Descent,    ///< Descente sous parachute confirmée.
+    Landed      ///< Atterrissage détecté (jusqu'à un nouveau décollage).
+};
+
+/**
+ * @brief Type d'événement de vol.
+ */
+enum class FlightEventType {
+    Ascent,     ///< Décollage : début de la montée.
+    Burst,      ///< Éclatement du ballon (horodaté à l'altitude maximale).
+    Descent,    ///< Descente confirmée.
+    Landed      ///< Atterrissage (horodaté au début de l'immobilité).
+};
+
+/**
+ * @brief Événement de vol émis par le moteur.
+ */
+struct FlightEvent {
+    QString callsign;           ///< Indicatif de la station concernée.
+    FlightEventType type;       ///< Type d'événement.
+    qint64 timestamp;           ///< Horodatage de l'événement (ms depuis l'époque Unix).
+    double altitude;            ///< Altitude au moment de l'événement (m).
+    double latitude;            ///< Dernière latitude connue (degrés).
+    double longitude;           ///< Dernière longitude connue (degrés).
+    double verticalRate;        ///< Vitesse verticale lissée au moment de la détection (m/s).
+};
+
+Q_DECLARE_METATYPE(FlightEvent)
+
+/**
+ * @brief Moteur incrémental de détection des phases de vol.
+ *
+ * Chaque mise à jour coûte O(1) : une vitesse verticale lissée (moyenne exponentielle pondérée
+ * par l'intervalle de temps), l'altitude maximale et une fenêtre d'immobilité ancrée sur une
+ * position de référence suffisent à détecter montée, éclatement, descente et atterrissage.
+ */
+class FlightStateEngine : public QObject {
+    Q_OBJECT
+public:
+    static constexpr double RATE_TIME_CONSTANT = 30.0;  ///< Constante de temps du lissage de la vitesse verticale (s).
+    static constexpr double MAX_RATE           = 150.0; ///< Vitesse verticale au-delà de laquelle un échantillon est rejeté (m/s).
+    static constexpr double ASCENT_RATE        = 1.0;   ///< Vitesse verticale minimale de montée (m/s).
+    static constexpr double ASCENT_GAIN        = 50.0;  ///< Gain d'altitude minimal pour valider le décollage (m).
+    static constexpr double BURST_DROP         = 100.0; ///< Perte d'altitude sous le maximum signant l'éclatement (m).
+    static constexpr double BURST_RATE         = -3.0;  ///< Vitesse verticale maximale après éclatement (m/s).
+    static constexpr double DESCENT_RATE       = -2.0;  ///< Vitesse verticale maximale de descente (m/s).
+    static constexpr int    DESCENT_CONFIRM    = 2;     ///< Nombre de mises à jour consécutives confirmant la descente.
+    static constexpr double LANDED_ALT_TOL     = 30.0;  ///< Tolérance verticale de la fenêtre d'immobilité (m).
+    static constexpr double LANDED_DIST_TOL    = 100.0; ///< Tolérance horizontale de la fenêtre d'immobilité (m).
+    static constexpr qint64 LANDED_WINDOW      = 180000;///< Durée d'immobilité validant l'atterrissage (ms).
+
+    /**
+     * @brief Constructeur de la classe FlightStateEngine.
+     * @param parent Pointeur vers l'objet parent (par défaut nullptr).
+     */
+    explicit FlightStateEngine(QObject *parent = nullptr);
+
+    /**
+     * @brief Traite une trame reçue.
+     *
+     * Les positions munies d'une altitude et les mesures de pression (champ météo 'b')
+     * du paquet APRS décodé alimentent le moteur ; les autres trames, et toutes celles des
+     * stations autres que la nacelle (APRSParser::isBalloon()), sont ignorées.
+     *
+     * @param frame La trame reçue (horodatage de réception compris).
+     */
+    void processFrame(const Frame &frame);
+
+    /**
+     * @brief Ajoute une position (altitude GPS) pour un indicatif.
+     *
+     * @param callsign Indicatif de la station.
+     * @param timestamp Horodatage (ms depuis l'époque Unix).
+     * @param latitude Latitude en degrés.
+     * @param longitude Longitude en degrés.
+     * @param altitude Altitude en mètres.
+     */
+    void addPosition(const QString &callsign, qint64 timestamp,
+                     double latitude, double longitude, double altitude);
+
+    /**
+     * @brief Ajoute une mesure de pression pour un indicatif.
+     *
+     * La pression est convertie en altitude selon l'atmosphère standard ; elle ne sert qu'au
+     * calcul de la vitesse verticale et à la détection de l'éclatement.
+     *
+     * @param callsign Indicatif de la station.
+     * @param timestamp Horodatage (ms depuis l'époque Unix).
+     * @param pressure Pression en hPa.
+     */
+    void addPressure(const QString &callsign, qint64 timestamp, double pressure);
+
+    /**
+     * @brief Retourne la phase de vol courante d'un indicatif.
+     * @param callsign Indicatif de la station.
+     * @return FlightPhase La phase courante (Ground si l'indicatif est inconnu).
+     */
+    FlightPhase phase(const QString &callsign) const;
+
+    /**
+     * @brief Retourne le nom d'un type d'événement ("ascent", "burst", "descent", "landed").
+     * @param type Le type d'événement.
+     * @return QString Le nom de l'événement, tel que stocké en base.
+     */
+    static QString eventName(FlightEventType type);
+
+    /**
+     * @brief Convertit une pression en altitude selon l'atmosphère standard (ISA).
+     * @param pressure Pression en hPa.
+     * @return double Altitude en mètres.
+     */
+    static double pressureToAltitude(double pressure);
+
+signals:
+    /**
+     * @brief Signal émis dès qu'un événement de vol est détecté.
+     * @param event L'événement détecté.
+     */
+    void flightEvent(const FlightEvent &event);
+
+private:
+    /**
+     * @brief Source d'altitude : GPS (positions) ou barométrique (pression).
+     */
+    enum Source { GpsSource = 0, PressureSource = 1, SourceCount = 2 };
+
+    /**
+     * @brief État de taille fixe conservé pour chaque indicatif.
+     */
+    struct State {
+        FlightPhase phase = FlightPhase::Ground;
+        bool   hasLast[SourceCount] = {false, false};
+        qint64 lastTime[SourceCount] = {0, 0};
+        double lastAltitude[SourceCount] = {0.0, 0.0};
+        double minAltitude[SourceCount] = {0.0, 0.0};
+        double maxAltitude[SourceCount] = {0.0, 0.0};
+        qint64 maxTime[SourceCount] = {0, 0};
+        bool   hasRate = false;
+        double verticalRate = 0.0;
+        int    descentCount = 0;
+        bool   hasPosition = false;
+        double latitude = 0.0;
+        double longitude = 0.0;
+        bool   hasAnchor = false;
+        qint64 anchorTime = 0;
+        double anchorAltitude = 0.0;
+        double anchorLatitude = 0.0;
+        double anchorLongitude = 0.0;
+    };
+
+    /**
+     * @brief Met à jour l'état d'un indicatif avec un échantillon d'altitude.
+     */
+    void update(const QString &callsign, Source source, qint64 timestamp, double altitude);
+
+    /**
+     * @brief Met à jour la fenêtre d'immobilité et détecte l'atterrissage.
+     */
+    void updateStationarity(const QString &callsign, State &state, qint64 timestamp, double altitude);
+
+    /**
+     * @brief Construit et émet un événement de vol.
+     */
+    void emitEvent(const QString &callsign, const State &state, FlightEventType type,
+                   qint64 timestamp, double altitude);
+
+    QHash<QString, State> m_states; ///< État de vol par indicatif.
+};
+
+#endif // FLIGHTSTATEENGINE_H
@@ -0,0 +1,165 @@
+#include "frame.h"
+#include "ax25converter.h"
+
+#include <atomic>
+#include <cstring>
+
+/**
+ * @file frame.cpp
+ * @brief Implémentation de la classe Frame.
+ *
+ * Ce fichier contient la construction des trames depuis une trame AX.25 ou une ligne TNC2 :
+ * recopie des octets dans les tampons internes, extraction des indicatifs et du message,
+ * puis décodage APRS, le tout sans autre allocation que celle de la trame elle-même.
+ */
+
+namespace {
+
+std::atomic<quint64> s_nextId{1}; ///< Identifiant de la prochaine trame construite.
+
+/**
+ * @brief Retire les espaces de début et de fin d'une vue.
+ */
+std::string_view trimmed(std::string_view text)
+{
+    while (!text.empty() && static_cast<unsigned char>(text.front()) <= ' ')
+        text.remove_prefix(1);
+    while (!text.empty() && static_cast<unsigned char>(text.back()) <= ' ')
+        text.remove_suffix(1);
+    return text;
+}
+
+} // namespace
+
+/**
+ * @brief Construit une trame à partir d'une trame AX.25 de type UI.
+ *
+ * Parcourt les champs d'adresse jusqu'au bit d'extension, saute les octets de contrôle et de PID,
+ * puis écrit "SRC>DEST:info" dans le tampon TNC2 de la trame.
+ *
+ * @param data Pointeur vers les octets AX.25.
+ * @param size Nombre d'octets.
+ * @param port Port KISS de réception.
+ * @param timestamp Horodatage de réception (ms).
+ * @return FramePtr La trame, ou un pointeur nul si la trame est invalide ou trop longue.
+ */
+FramePtr Frame::fromAX25(const char *data, int size, quint8 port, qint64 timestamp)
+{
+    if (size <= 0 || size > MAX_AX25_SIZE)
+        return FramePtr();
+
+    // Parcours des champs d'adresses (7 octets chacun)
+    int offset = 0;
+    int addressCount = 0;
+    while (offset + 7 <= size) {
+        ++addressCount;
+        bool last = (data[offset + 6] & 0x01) != 0;
+        offset += 7;
+        if (last)
+            break;
+    }
+    if (addressCount < 2 || offset + 2 > size)
+        return FramePtr();
+    offset += 2; // Contrôle et PID
+
+    int payloadSize = size - offset;
+    if (2 * AX25Converter::MAX_ADDRESS_LENGTH + 2 + payloadSize > MAX_TNC2_SIZE)
+        return FramePtr();
+
+    QSharedPointer<Frame> frame = QSharedPointer<Frame>::create();
+    frame->m_id = s_nextId.fetch_add(1, std::memory_order_relaxed);
+    frame->m_timestamp = timestamp;
+    frame->m_port = port;
+    std::memcpy(frame->m_raw, data, static_cast<std::size_t>(size));
+    frame->m_rawSize = size;
+
+    char *text = frame->m_text;
+    int length = AX25Converter::decodeAX25Address(data + 7, text);
+    text[length++] = '>';
+    length += AX25Converter::decodeAX25Address(data, text + length);
+    text[length++] = ':';
+    std::memcpy(text + length, data + offset, static_cast<std::size_t>(payloadSize));
+    frame->m_textSize = length + payloadSize;
+
+    if (!frame->parseText())
+        return FramePtr();
+    return frame;
+}
+
+/**
+ * @brief Définit les indicatifs de la nacelle.
+ * @param callsigns Les indicatifs séparés par des virgules (espaces et entrées vides ignorés).
+ */
+void Frame::setBalloonCallsigns(const QString &callsigns)
+{
+    std::vector<std::string> list;
+    for (const QString &callsign : callsigns.split(',')) {
+        if (!callsign.trimmed().isEmpty())
+            list.push_back(callsign.trimmed().toUpper().toStdString());
+    }
+    APRSParser::setBalloonCallsigns(list);
+}
+
+/**
+ * @brief Construit une trame à partir d'une ligne TNC2.
+ *
+ * Les fins de ligne éventuelles sont retirées avant la recopie.
+ *
+ * @param line La ligne TNC2.
+ * @param timestamp Horodatage (ms).
+ * @return FramePtr La trame, ou un pointeur nul si la ligne est invalide ou trop longue.
+ */
+FramePtr Frame::fromTNC2(std::string_view line, qint64 timestamp)
+{
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n'))
+        line.remove_suffix(1);
+    if (line.empty() || line.size() > static_cast<std::size_t>(MAX_TNC2_SIZE))
+        return FramePtr();
+
+    QSharedPointer<Frame> frame = QSharedPointer<Frame>::create();
+    frame->m_id = s_nextId.fetch_add(1, std::memory_order_relaxed);
+    frame->m_timestamp = timestamp;
+    std::memcpy(frame->m_text, line.data(), line.size());
+    frame->m_textSize = static_cast<int>(line.size());
+
+    if (!frame->parseText())
+        return FramePtr();
+    return frame;
+}
+
+/**
+ * @brief Analyse le texte TNC2 de la trame.
+ *
+ * La source est le champ précédant '>'. Pour un message APRS (":DEST     :texte"), le destinataire
+ * et le message sont ceux du message ; sinon, le destinataire est le champ destination et le message
+ * est le champ d'information complet. Le champ d'information est ensuite décodé par APRSParser.
+ *
+ * @return bool @c true si l'en-tête TNC2 est valide, @c false sinon.
+ */
+bool Frame::parseText()
+{
+    std::string_view text = tnc2();
+    std::size_t posGT = text.find('>');
+    if (posGT == std::string_view::npos)
+        return false;
+    std::size_t posColon = text.find(':', posGT + 1);
+    if (posColon == std::string_view::npos)
+        return false;
+
+    m_source = CallsignTable::intern(trimmed(text.substr(0, posGT)));
+
+    std::string_view header = text.substr(posGT + 1, posColon - posGT - 1);
+    std::string_view info = text.substr(posColon + 1);
+    std::size_t posAddresseeEnd = (info.size() > 1 && info[0] == ':') ? info.find(':', 1)
+                                                                       : std::string_view::npos;
+    if (posAddresseeEnd != std::string_view::npos) {
+        m_destination = CallsignTable::intern(trimmed(info.substr(1, posAddresseeEnd - 1)));
+        m_message = trimmed(info.substr(posAddresseeEnd + 1));
+    } else {
+        m_destination = CallsignTable::intern(trimmed(header.substr(0, header.find(','))));
+        m_message = trimmed(info);
+    }
+
+    m_hasPacket = APRSParser::parseTNC2(text, m_packet);
+    return true;
+}
@@ -0,0 +1,182 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+/**
+ * @file frame.h
+ * @brief Déclaration de la classe Frame.
+ *
+ * Ce fichier définit la trame reçue telle qu'elle circule dans la station sol : un enregistrement
+ * immuable, partagé par comptage de références, qui contient les octets AX.25 bruts, le texte TNC2,
+ * les indicatifs internés et le paquet APRS décodé. La trame est construite une seule fois
+ * puis transmise par pointeur (FramePtr) à l'interface, à la base de données et à la passerelle APRS-IS.
+ */
+
+#pragma once
+
+#include <QMetaType>
+#include <QSharedPointer>
+#include <QString>
+
+#include <string_view>
+
+#include "aprsparser.h"
+#include "callsigntable.h"
+
+class Frame;
+
+/**
+ * @brief Pointeur partagé vers une trame immuable.
+ */
+using FramePtr = QSharedPointer<const Frame>;
+
+/**
+ * @brief Trame reçue, immuable et partagée.
+ *
+ * Les octets bruts et le texte TNC2 sont stockés dans des tampons internes de taille fixe :
+ * une trame ne coûte qu'une allocation (objet et compteur de références ensemble). Les vues
+ * texte (message, champs du paquet APRS) pointent dans le tampon TNC2 de la trame et restent
+ * valides tant que la trame est référencée. La trame n'est pas copiable.
+ *
+ * Les trames se construisent uniquement avec fromAX25() ou fromTNC2().
+ */
+class Frame {
+public:
+    static constexpr int MAX_AX25_SIZE = 330; ///< Taille maximale d'une trame AX.25 (10 adresses, contrôle, PID, 256 octets d'information).
+    static constexpr int MAX_TNC2_SIZE = 512; ///< Taille maximale du texte TNC2.
+
+    /**
+     * @brief Constructeur par défaut (trame vide) ; utiliser fromAX25() ou fromTNC2().
+     */
+    Frame() = default;
+
+    Frame(const Frame &) = delete;
+    Frame &operator=(const Frame &) = delete;
+
+    /**
+     * @brief Construit une trame à partir d'une trame AX.25 de type UI.
+     *
+     * Le texte TNC2 est produit directement dans la trame ("SRC>DEST:info"), les indicatifs
+     * sont internés et le champ d'information est décodé par APRSParser.
+     *
+     * @param data Pointeur vers les octets AX.25 (sans l'octet de port KISS).
+     * @param size Nombre d'octets.
+     * @param port Port KISS de réception.
+     * @param timestamp Horodatage de réception (ms depuis l'époque Unix).
+     * @return FramePtr La trame, ou un pointeur nul si la trame est invalide ou trop longue.
+     */
+    static FramePtr fromAX25(const char *data, int size, quint8 port, qint64 timestamp);
+
+    /**
+     * @brief Construit une trame à partir d'une ligne TNC2 ("SRC>DEST,PATH:info").
+     *
+     * Utilisé pour les trames émises par la station et pour les journaux importés.
+     * La trame ne contient alors pas d'octets AX.25.
+     *
+     * @param line La ligne TNC2.
+     * @param timestamp Horodatage (ms depuis l'époque Unix).
+     * @return FramePtr La trame, ou un pointeur nul si la ligne est invalide ou trop longue.
+     */
+    static FramePtr fromTNC2(std::string_view line, qint64 timestamp);
+
+    /**
+     * @brief Définit les indicatifs de la nacelle, dont la télémétrie compressée suit son profil.
+     *
+     * À appeler au lancement, avant la construction des trames (voir APRSParser::setBalloonCallsigns()).
+     *
+     * @param callsigns Les indicatifs séparés par des virgules ("F4KMN-8,F4KMN-9").
+     */
+    static void setBalloonCallsigns(const QString &callsigns);
+
+    /**
+     * @brief Retourne l'identifiant de la trame, unique pendant l'exécution (numéro de construction).
+     */
+    quint64 id() const { return m_id; }
+
+    /**
+     * @brief Retourne l'horodatage de réception (ms depuis l'époque Unix).
+     */
+    qint64 timestamp() const { return m_timestamp; }
+
+    /**
+     * @brief Retourne le port KISS de réception.
+     */
+    quint8 port() const { return m_port; }
+
+    /**
+     * @brief Retourne les octets AX.25 bruts (vide pour une trame construite depuis TNC2).
+     */
+    std::string_view raw() const { return std::string_view(m_raw, static_cast<std::size_t>(m_rawSize)); }
+
+    /**
+     * @brief Retourne la trame complète au format TNC2.
+     */
+    std::string_view tnc2() const { return std::string_view(m_text, static_cast<std::size_t>(m_textSize)); }
+
+    /**
+     * @brief Retourne le message utile : texte d'un message APRS, sinon champ d'information.
+     */
+    std::string_view message() const { return m_message; }
+
+    /**
+     * @brief Retourne l'identifiant de l'indicatif source.
+     */
+    CallsignId source() const { return m_source; }
+
+    /**
+     * @brief Retourne l'identifiant de l'indicatif destinataire.
+     *
+     * Pour un message APRS, il s'agit du destinataire du message, sinon du champ destination.
+     */
+    CallsignId destination() const { return m_destination; }
+
+    /**
+     * @brief Retourne le nom de l'indicatif source.
+     */
+    QString sourceName() const { return CallsignTable::name(m_source); }
+
+    /**
+     * @brief Retourne le nom de l'indicatif destinataire.
+     */
+    QString destinationName() const { return CallsignTable::name(m_destination); }
+
+    /**
+     * @brief Retourne le paquet APRS décodé, ou nullptr si le champ d'information n'a pas été reconnu.
+     */
+    const APRSPacket *packet() const { return m_hasPacket ? &m_packet : nullptr; }
+
+    /**
+     * @brief Convertit une vue de la trame en QString (copie).
+     *
+     * @param text Vue sur le texte de la trame.
+     * @return QString Le texte converti (Latin-1).
+     */
+    static QString toString(std::string_view text)
+    {
+        return QString::fromLatin1(text.data(), static_cast<int>(text.size()));
+    }
+
+private:
+    /**
+     * @brief Analyse le texte TNC2 de la trame : indicatifs, message et paquet APRS.
+     *
+     * @return bool @c false si l'en-tête TNC2 est invalide.
+     */
+    bool parseText();
+
+    quint64 m_id = 0;                         ///< Identifiant de la trame.
+    qint64 m_timestamp = 0;                   ///< Horodatage de réception (ms).
+    quint8 m_port = 0;                        ///< Port KISS de réception.
+    CallsignId m_source = CallsignTable::NONE;      ///< Indicatif source.
+    CallsignId m_destination = CallsignTable::NONE; ///< Indicatif destinataire.
+    int m_rawSize = 0;                        ///< Nombre d'octets AX.25.
+    int m_textSize = 0;                       ///< Longueur du texte TNC2.
+    std::string_view m_message;               ///< Message utile (vue dans m_text).
+    bool m_hasPacket = false;                 ///< Indique si m_packet est valide.
+    APRSPacket m_packet;                      ///< Paquet APRS décodé (vues dans m_text).
+    char m_raw[MAX_AX25_SIZE];                ///< Octets AX.25 bruts.
+    char m_text[MAX_TNC2_SIZE];               ///< Texte TNC2.
+};
+
+Q_DECLARE_METATYPE(FramePtr)
+
+#endif // FRAME_H
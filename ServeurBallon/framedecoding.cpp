@@ -0,0 +1,135 @@
+#include "framedecoding.h"
+#include "frame.h"
+
+#include <QDateTime>
+#include <QVariant>
+
+/**
+ * @file framedecoding.cpp
+ * @brief Implémentation de la classe FrameDecoding.
+ *
+ * Ce fichier contient la requête d'insertion de la table decodages et la liaison des valeurs
+ * décodées ; les champs absents du paquet sont enregistrés à NULL.
+ */
+
+namespace {
+
+/**
+ * @brief Colonnes de la table decodages, dans l'ordre de liaison.
+ */
+const char *const COLUMNS[FrameDecoding::COLUMN_COUNT] = {
+    "trame", "source", "date_reception", "type",
+    "latitude", "longitude", "altitude", "vitesse", "cap",
+    "sequence", "a1", "a2", "a3", "a4", "a5", "bits",
+    "temperature", "pression", "humidite", "version"
+};
+
+/**
+ * @brief Retourne la valeur si elle est présente, NULL sinon.
+ */
+template <typename T>
+QVariant optional(bool present, T value)
+{
+    return present ? QVariant(value) : QVariant();
+}
+
+} // namespace
+
+/**
+ * @brief Indique si la trame a un décodage à enregistrer.
+ *
+ * @param frame La trame.
+ * @return bool @c true si le paquet APRS de la trame est reconnu, @c false sinon.
+ */
+bool FrameDecoding::isDecoded(const Frame &frame)
+{
+    const APRSPacket *packet = frame.packet();
+    return packet && packet->type != APRSPacketType::Unknown;
+}
+
+/**
+ * @brief Retourne la clé de la trame, tronquée comme dans la table trames.
+ *
+ * @param frame La trame.
+ * @param driverName Nom du pilote Qt.
+ * @return QString La clé.
+ */
+QString FrameDecoding::key(const Frame &frame, const QString &driverName)
+{
+    const QString tnc2 = Frame::toString(frame.tnc2());
+    return driverName == QLatin1String("QMYSQL") ? tnc2.left(MYSQL_KEY_LENGTH) : tnc2;
+}
+
+/**
+ * @brief Construit la requête d'insertion de plusieurs lignes.
+ *
+ * Une ligne déjà présente (même trame) est remplacée : "INSERT OR REPLACE" avec SQLite,
+ * "ON DUPLICATE KEY UPDATE" avec MySQL.
+ *
+ * @param driverName Nom du pilote Qt.
+ * @param rows Nombre de lignes.
+ * @return QString La requête.
+ */
+QString FrameDecoding::insertStatement(const QString &driverName, int rows)
+{
+    const bool sqlite = (driverName == QLatin1String("QSQLITE"));
+
+    QString columns;
+    QString update;
+    for (int i = 0; i < COLUMN_COUNT; ++i) {
+        if (i > 0)
+            columns += ", ";
+        columns += COLUMNS[i];
+        if (i > 0) {
+            if (i > 1)
+                update += ", ";
+            update += QString("%1 = VALUES(%1)").arg(COLUMNS[i]);
+        }
+    }
+
+    QString placeholders = "(?" + QString(", ?").repeated(COLUMN_COUNT - 1) + ")";
+    QString sql = sqlite ? "INSERT OR REPLACE INTO decodages (" : "INSERT INTO decodages (";
+    sql += columns + ") VALUES " + placeholders;
+    for (int i = 1; i < rows; ++i)
+        sql += ", " + placeholders;
+    if (!sqlite)
+        sql += " ON DUPLICATE KEY UPDATE " + update;
+    return sql;
+}
+
+/**
+ * @brief Lie les valeurs d'une ligne de la requête d'insertion.
+ *
+ * @param query La requête préparée.
+ * @param row Indice de la ligne dans la requête.
+ * @param frame La trame décodée (isDecoded() doit être vrai).
+ * @param driverName Nom du pilote Qt.
+ */
+void FrameDecoding::bindValues(QSqlQuery &query, int row, const Frame &frame, const QString &driverName)
+{
+    const APRSPacket &packet = *frame.packet();
+    const APRSPosition &position = packet.position;
+    const APRSTelemetry &telemetry = packet.telemetry;
+    const APRSWeather &weather = packet.weather;
+    const bool hasPosition = (packet.type == APRSPacketType::Position || packet.type == APRSPacketType::MicE);
+    const bool hasTelemetry = (packet.type == APRSPacketType::Telemetry || telemetry.compressed);
+
+    const int base = row * COLUMN_COUNT;
+    query.bindValue(base + 0, key(frame, driverName));
+    query.bindValue(base + 1, frame.sourceName());
+    query.bindValue(base + 2, QDateTime::fromMSecsSinceEpoch(frame.timestamp()));
+    query.bindValue(base + 3, QString::fromLatin1(APRSParser::typeName(packet.type)));
+    query.bindValue(base + 4, optional(hasPosition, position.latitude));
+    query.bindValue(base + 5, optional(hasPosition, position.longitude));
+    query.bindValue(base + 6, optional(hasPosition && position.hasAltitude, position.altitude));
+    query.bindValue(base + 7, optional(hasPosition && position.hasCourseSpeed, position.speed));
+    query.bindValue(base + 8, optional(hasPosition && position.hasCourseSpeed, position.course));
+    query.bindValue(base + 9, optional(hasTelemetry && telemetry.sequence >= 0, telemetry.sequence));
+    for (int i = 0; i < APRSTelemetry::MAX_ANALOG; ++i)
+        query.bindValue(base + 10 + i, optional(hasTelemetry && i < telemetry.analogCount, telemetry.analog[i]));
+    query.bindValue(base + 15, optional(hasTelemetry && telemetry.hasDigital, int(telemetry.digital)));
+    query.bindValue(base + 16, optional(weather.hasTemperature, weather.temperature));
+    query.bindValue(base + 17, optional(weather.hasPressure, weather.pressure));
+    query.bindValue(base + 18, optional(weather.hasHumidity, weather.humidity));
+    query.bindValue(base + 19, VERSION);
+}
@@ -0,0 +1,73 @@
+#ifndef FRAMEDECODING_H
+#define FRAMEDECODING_H
+
+/**
+ * @file framedecoding.h
+ * @brief Déclaration de la classe FrameDecoding.
+ *
+ * Ce fichier définit l'enregistrement du résultat du décodage APRS d'une trame dans la table
+ * decodages (type, position, télémétrie, météo), commun à l'écriture en direct et au redécodage
+ * des trames historiques.
+ */
+
+#pragma once
+
+#include <QSqlQuery>
+#include <QString>
+
+class Frame;
+
+/**
+ * @brief Écriture du décodage d'une trame dans la table decodages.
+ *
+ * Une ligne de decodages est identifiée par la trame TNC2 (clé primaire de trames) et porte le
+ * numéro de version du décodeur qui l'a produite : une amélioration des décodeurs s'accompagne
+ * d'une incrémentation de VERSION, et l'outil de redécodage réécrit alors les lignes existantes.
+ * Les requêtes d'insertion peuvent regrouper plusieurs lignes.
+ */
+class FrameDecoding {
+public:
+    static constexpr int VERSION = 3;       ///< Version courante des décodeurs (2 : télémétrie compressée, 3 : profil de la nacelle par indicatif).
+    static constexpr int COLUMN_COUNT = 20; ///< Nombre de colonnes liées par ligne.
+    static constexpr int MYSQL_KEY_LENGTH = 100; ///< Longueur de trames.trame et decodages.trame (varchar(100)) sous MySQL.
+
+    /**
+     * @brief Retourne la clé de la trame, telle que la table trames l'enregistre.
+     *
+     * MySQL tronque le texte TNC2 à MYSQL_KEY_LENGTH caractères ; SQLite n'applique pas la longueur
+     * déclarée et conserve le texte complet. La même clé est liée dans trames et dans decodages.
+     *
+     * @param frame La trame.
+     * @param driverName Nom du pilote Qt ("QMYSQL", "QSQLITE").
+     * @return QString La clé.
+     */
+    static QString key(const Frame &frame, const QString &driverName);
+
+    /**
+     * @brief Indique si la trame a un décodage à enregistrer (type APRS reconnu).
+     * @param frame La trame.
+     * @return bool @c true si le paquet APRS de la trame est reconnu.
+     */
+    static bool isDecoded(const Frame &frame);
+
+    /**
+     * @brief Construit la requête d'insertion (ou de remplacement) de plusieurs lignes.
+     *
+     * @param driverName Nom du pilote Qt ("QMYSQL", "QSQLITE"), pour la syntaxe de remplacement.
+     * @param rows Nombre de lignes de la requête.
+     * @return QString La requête, avec rows * COLUMN_COUNT paramètres positionnels.
+     */
+    static QString insertStatement(const QString &driverName, int rows);
+
+    /**
+     * @brief Lie les valeurs d'une ligne de la requête d'insertion.
+     *
+     * @param query La requête préparée avec insertStatement().
+     * @param row Indice de la ligne dans la requête (à partir de 0).
+     * @param frame La trame décodée.
+     * @param driverName Nom du pilote Qt, pour la clé (voir key()).
+     */
+    static void bindValues(QSqlQuery &query, int row, const Frame &frame, const QString &driverName);
+};
+
+#endif // FRAMEDECODING_H
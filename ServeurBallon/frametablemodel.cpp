@@ -0,0 +1,366 @@
+#include "frametablemodel.h"
+#include "tracer.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+
+/**
+ * @file frametablemodel.cpp
+ * @brief Implémentation de la classe FrameTableModel.
+ *
+ * Ce fichier contient la gestion de l'anneau des trames, des index par indicatif et par type,
+ * les insertions regroupées, le chargement progressif des lignes et l'application des filtres.
+ */
+
+/**
+ * @brief Constructeur de la classe FrameTableModel.
+ *
+ * @param capacity Nombre maximal de trames conservées.
+ * @param parent Pointeur vers l'objet parent (par défaut nullptr).
+ */
+FrameTableModel::FrameTableModel(int capacity, QObject *parent)
+    : QAbstractTableModel(parent),
+    m_ring(static_cast<std::size_t>(qMax(1, capacity))),
+    m_refreshTimer(this)
+{
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(REFRESH_INTERVAL);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &FrameTableModel::flushPending);
+}
+
+/**
+ * @brief Retourne le nombre de lignes exposées à la vue.
+ *
+ * @param parent Index parent (la table n'a pas de hiérarchie).
+ * @return int Le nombre de lignes déjà chargées.
+ */
+int FrameTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_visible;
+}
+
+/**
+ * @brief Retourne le nombre de colonnes.
+ *
+ * @param parent Index parent.
+ * @return int ColumnCount.
+ */
+int FrameTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+/**
+ * @brief Retourne le contenu d'une cellule.
+ *
+ * Le texte est construit à la demande, uniquement pour les cellules affichées.
+ *
+ * @param index La cellule.
+ * @param role Le rôle demandé (affichage, info-bulle).
+ * @return QVariant Le contenu de la cellule.
+ */
+QVariant FrameTableModel::data(const QModelIndex &index, int role) const
+{
+    if (role != Qt::DisplayRole && role != Qt::ToolTipRole)
+        return QVariant();
+    FramePtr frame = frameAt(index.row());
+    if (!frame)
+        return QVariant();
+    if (role == Qt::ToolTipRole)
+        return Frame::toString(frame->tnc2());
+
+    switch (index.column()) {
+    case TimeColumn:
+        return QDateTime::fromMSecsSinceEpoch(frame->timestamp()).toString("HH:mm:ss.zzz");
+    case SourceColumn:
+        return frame->sourceName();
+    case DestinationColumn:
+        return frame->destinationName();
+    case TypeColumn:
+        return QString::fromLatin1(APRSParser::typeName(static_cast<APRSPacketType>(typeOf(*frame))));
+    case MessageColumn:
+        return Frame::toString(frame->message());
+    default:
+        return QVariant();
+    }
+}
+
+/**
+ * @brief Retourne les titres des colonnes.
+ *
+ * @param section La colonne.
+ * @param orientation L'orientation de l'en-tête.
+ * @param role Le rôle demandé.
+ * @return QVariant Le titre de la colonne.
+ */
+QVariant FrameTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    switch (section) {
+    case TimeColumn:        return QStringLiteral("Heure");
+    case SourceColumn:      return QStringLiteral("Source");
+    case DestinationColumn: return QStringLiteral("Destination");
+    case TypeColumn:        return QStringLiteral("Type");
+    case MessageColumn:     return QStringLiteral("Message");
+    default:                return QVariant();
+    }
+}
+
+/**
+ * @brief Indique s'il reste des lignes à charger.
+ *
+ * @param parent Index parent.
+ * @return bool @c true si des trames satisfaisant le filtre ne sont pas encore exposées.
+ */
+bool FrameTableModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return false;
+    std::size_t available = m_filtered ? m_rows.size() : m_count;
+    return static_cast<std::size_t>(m_visible) < available;
+}
+
+/**
+ * @brief Expose FETCH_BATCH lignes supplémentaires (appelé par la vue au défilement).
+ *
+ * @param parent Index parent.
+ */
+void FrameTableModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid())
+        return;
+    std::size_t available = m_filtered ? m_rows.size() : m_count;
+    int more = static_cast<int>(std::min<std::size_t>(FETCH_BATCH, available - static_cast<std::size_t>(m_visible)));
+    if (more <= 0)
+        return;
+    beginInsertRows(QModelIndex(), m_visible, m_visible + more - 1);
+    m_visible += more;
+    endInsertRows();
+}
+
+/**
+ * @brief Retourne la trame affichée à une ligne (la plus récente en ligne 0).
+ *
+ * @param row La ligne.
+ * @return FramePtr La trame, ou un pointeur nul si la ligne n'existe pas.
+ */
+FramePtr FrameTableModel::frameAt(int row) const
+{
+    if (row < 0 || row >= m_visible)
+        return FramePtr();
+    if (m_filtered)
+        return frameAtSequence(m_rows[m_rows.size() - 1 - static_cast<std::size_t>(row)]);
+    return frameAtSequence(m_next - 1 - static_cast<Sequence>(row));
+}
+
+/**
+ * @brief Met une trame en attente d'insertion.
+ *
+ * Le minuteur de rafraîchissement est lancé à la première trame en attente.
+ *
+ * @param frame La trame.
+ */
+void FrameTableModel::append(const FramePtr &frame)
+{
+    if (!frame)
+        return;
+    m_pending.append(frame);
+    if (!m_refreshTimer.isActive())
+        m_refreshTimer.start();
+}
+
+/**
+ * @brief Insère les trames en attente.
+ *
+ * Les trames les plus anciennes sont d'abord retirées pour faire de la place (une seule notification
+ * de suppression pour les lignes exposées concernées), puis les nouvelles trames satisfaisant
+ * le filtre sont insérées en tête en une seule notification.
+ */
+void FrameTableModel::flushPending()
+{
+    if (m_pending.isEmpty())
+        return;
+    TraceSpan span("table des trames");
+    QVector<FramePtr> batch;
+    batch.swap(m_pending);
+
+    const std::size_t capacity = m_ring.size();
+    const std::size_t size = static_cast<std::size_t>(batch.size());
+    const std::size_t first = size > capacity ? size - capacity : 0;
+    const std::size_t incoming = size - first;
+
+    // Retrait des trames les plus anciennes
+    const std::size_t evict = (m_count + incoming > capacity) ? m_count + incoming - capacity : 0;
+    if (evict > 0) {
+        const Sequence limit = m_next - m_count + evict;
+        std::size_t available = m_count - evict;
+        if (m_filtered) {
+            std::size_t evictedRows = 0;
+            while (evictedRows < m_rows.size() && m_rows[evictedRows] < limit)
+                ++evictedRows;
+            available = m_rows.size() - evictedRows;
+        }
+        const bool removeRows = static_cast<std::size_t>(m_visible) > available;
+        if (removeRows)
+            beginRemoveRows(QModelIndex(), static_cast<int>(available), m_visible - 1);
+        for (std::size_t i = 0; i < evict; ++i)
+            evictOldest();
+        if (removeRows) {
+            m_visible = static_cast<int>(available);
+            endRemoveRows();
+        }
+    }
+
+    // Insertion des nouvelles trames, les plus récentes en tête
+    int inserted = 0;
+    for (std::size_t i = first; i < size; ++i) {
+        if (!m_filtered || matches(*batch[static_cast<int>(i)]))
+            ++inserted;
+    }
+    if (inserted > 0)
+        beginInsertRows(QModelIndex(), 0, inserted - 1);
+    for (std::size_t i = first; i < size; ++i) {
+        const FramePtr &frame = batch[static_cast<int>(i)];
+        const Sequence seq = m_next++;
+        m_ring[seq % capacity] = frame;
+        ++m_count;
+        m_bySource[frame->source()].push_back(seq);
+        m_byDestination[frame->destination()].push_back(seq);
+        m_byType[typeOf(*frame)].push_back(seq);
+        if (m_filtered && matches(*frame))
+            m_rows.push_back(seq);
+    }
+    if (inserted > 0) {
+        m_visible += inserted;
+        endInsertRows();
+    }
+}
+
+/**
+ * @brief Retire la plus ancienne trame de l'anneau et des index.
+ *
+ * Les trames étant insérées dans l'ordre des séquences, la plus ancienne est toujours en tête
+ * de chacune de ses listes.
+ */
+void FrameTableModel::evictOldest()
+{
+    const Sequence seq = m_next - m_count;
+    FramePtr &slot = m_ring[seq % m_ring.size()];
+
+    auto popFront = [seq](auto &index, auto key) {
+        auto it = index.find(key);
+        if (it == index.end())
+            return;
+        if (!it->empty() && it->front() == seq)
+            it->pop_front();
+        if (it->empty())
+            index.erase(it);
+    };
+    popFront(m_bySource, slot->source());
+    popFront(m_byDestination, slot->destination());
+    popFront(m_byType, typeOf(*slot));
+    if (!m_rows.empty() && m_rows.front() == seq)
+        m_rows.pop_front();
+
+    slot.reset();
+    --m_count;
+}
+
+/**
+ * @brief Applique un filtre.
+ *
+ * Les lignes sont reconstruites à partir de la plus courte des listes d'index concernées.
+ *
+ * @param source Indicatif source (CallsignTable::NONE : tous).
+ * @param destination Indicatif destinataire (CallsignTable::NONE : tous).
+ * @param type Type de paquet (ANY_TYPE : tous).
+ */
+void FrameTableModel::setFilter(CallsignId source, CallsignId destination, int type)
+{
+    beginResetModel();
+    m_filterSource = source;
+    m_filterDestination = destination;
+    m_filterType = type;
+    m_filtered = (source != CallsignTable::NONE || destination != CallsignTable::NONE || type != ANY_TYPE);
+    rebuildRows();
+    std::size_t available = m_filtered ? m_rows.size() : m_count;
+    m_visible = static_cast<int>(std::min<std::size_t>(FETCH_BATCH, available));
+    endResetModel();
+}
+
+/**
+ * @brief Vide la table (le filtre est conservé).
+ */
+void FrameTableModel::clear()
+{
+    beginResetModel();
+    m_pending.clear();
+    std::fill(m_ring.begin(), m_ring.end(), FramePtr());
+    m_count = 0;
+    m_bySource.clear();
+    m_byDestination.clear();
+    m_byType.clear();
+    m_rows.clear();
+    m_visible = 0;
+    endResetModel();
+}
+
+/**
+ * @brief Indique si une trame satisfait le filtre courant.
+ *
+ * @param frame La trame.
+ * @return bool @c true si la trame doit être affichée.
+ */
+bool FrameTableModel::matches(const Frame &frame) const
+{
+    return (m_filterSource == CallsignTable::NONE || frame.source() == m_filterSource)
+           && (m_filterDestination == CallsignTable::NONE || frame.destination() == m_filterDestination)
+           && (m_filterType == ANY_TYPE || typeOf(frame) == m_filterType);
+}
+
+/**
+ * @brief Retourne le type de paquet d'une trame.
+ *
+ * @param frame La trame.
+ * @return int La valeur de APRSPacketType (Unknown si le paquet n'a pas été reconnu).
+ */
+int FrameTableModel::typeOf(const Frame &frame)
+{
+    const APRSPacket *packet = frame.packet();
+    return static_cast<int>(packet ? packet->type : APRSPacketType::Unknown);
+}
+
+/**
+ * @brief Reconstruit la liste des lignes filtrées.
+ *
+ * Parcourt la plus courte des listes d'index des critères actifs et vérifie les autres critères
+ * par comparaison d'identifiants.
+ */
+void FrameTableModel::rebuildRows()
+{
+    m_rows.clear();
+    if (!m_filtered)
+        return;
+
+    const Postings *candidates = nullptr;
+    auto narrow = [&candidates](const auto &index, auto key) {
+        auto it = index.constFind(key);
+        static const Postings empty;
+        const Postings *list = (it == index.constEnd()) ? &empty : &it.value();
+        if (!candidates || list->size() < candidates->size())
+            candidates = list;
+    };
+    if (m_filterSource != CallsignTable::NONE)
+        narrow(m_bySource, m_filterSource);
+    if (m_filterDestination != CallsignTable::NONE)
+        narrow(m_byDestination, m_filterDestination);
+    if (m_filterType != ANY_TYPE)
+        narrow(m_byType, m_filterType);
+
+    for (Sequence seq : *candidates) {
+        if (matches(*frameAtSequence(seq)))
+            m_rows.push_back(seq);
+    }
+}
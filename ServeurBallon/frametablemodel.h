@@ -0,0 +1,162 @@
+#ifndef FRAMETABLEMODEL_H
+#define FRAMETABLEMODEL_H
+
+/**
+ * @file frametablemodel.h
+ * @brief Déclaration de la classe FrameTableModel.
+ *
+ * Ce fichier définit le modèle de la table des trames reçues affichée dans l'interface : un anneau
+ * en mémoire des trames récentes, exposé à une QTableView avec chargement progressif des lignes,
+ * insertions regroupées et filtrage par indicatif et par type sur des index d'entiers.
+ */
+
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QTimer>
+#include <QVector>
+
+#include <deque>
+#include <vector>
+
+#include "frame.h"
+
+/**
+ * @brief Modèle de table des trames récentes.
+ *
+ * Les trames sont conservées (par pointeur partagé, sans copie) dans un anneau de capacité fixe ;
+ * chaque trame reçoit un numéro de séquence croissant, et sa place dans l'anneau est ce numéro
+ * modulo la capacité. Les trames les plus récentes sont affichées en premier. Chaque trame conservée
+ * coûte environ 1 Ko (objet Frame avec son texte TNC2 et son paquet décodé, entrées des index) :
+ * la capacité se règle au lancement (--history) selon la mémoire de la station.
+ *
+ * - Les trames reçues sont mises en attente par append() et insérées toutes ensemble à chaque tic
+ *   de rafraîchissement (REFRESH_INTERVAL ms) : une rafale ne provoque qu'une insertion.
+ * - Seules les FETCH_BATCH premières lignes sont exposées, les suivantes au fil du défilement
+ *   (canFetchMore()/fetchMore()). Le texte d'une cellule n'est construit qu'à l'affichage.
+ * - Chaque indicatif source, indicatif destinataire et type de paquet possède la liste des numéros
+ *   de séquence correspondants : un filtre part de la plus courte de ces listes et ne compare
+ *   que des identifiants entiers (CallsignId, APRSPacketType), sans recherche dans le texte.
+ */
+class FrameTableModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    static constexpr int DEFAULT_CAPACITY = 100000; ///< Nombre de trames conservées par défaut (environ 100 Mo).
+    static constexpr int REFRESH_INTERVAL = 200;    ///< Période d'insertion des trames en attente (ms).
+    static constexpr int FETCH_BATCH      = 1000;   ///< Lignes exposées à chaque chargement progressif.
+    static constexpr int ANY_TYPE         = -1;     ///< Valeur du filtre de type sans restriction.
+
+    /**
+     * @brief Colonnes de la table.
+     */
+    enum Column {
+        TimeColumn,        ///< Heure de réception.
+        SourceColumn,      ///< Indicatif source.
+        DestinationColumn, ///< Indicatif destinataire.
+        TypeColumn,        ///< Type de paquet APRS.
+        MessageColumn,     ///< Message ou champ d'information.
+        ColumnCount
+    };
+
+    /**
+     * @brief Constructeur de la classe FrameTableModel.
+     * @param capacity Nombre maximal de trames conservées.
+     * @param parent Pointeur vers l'objet parent (par défaut nullptr).
+     */
+    explicit FrameTableModel(int capacity = DEFAULT_CAPACITY, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    /**
+     * @brief Retourne la trame affichée à une ligne.
+     * @param row La ligne.
+     * @return FramePtr La trame, ou un pointeur nul si la ligne n'existe pas.
+     */
+    FramePtr frameAt(int row) const;
+
+    /**
+     * @brief Retourne le nombre de trames conservées (sans tenir compte du filtre).
+     */
+    int frameCount() const { return static_cast<int>(m_count); }
+
+public slots:
+    /**
+     * @brief Met une trame en attente d'insertion au prochain tic de rafraîchissement.
+     * @param frame La trame.
+     */
+    void append(const FramePtr &frame);
+
+    /**
+     * @brief Applique un filtre.
+     *
+     * @param source Indicatif source (CallsignTable::NONE : tous).
+     * @param destination Indicatif destinataire (CallsignTable::NONE : tous).
+     * @param type Type de paquet (valeur de APRSPacketType, ANY_TYPE : tous).
+     */
+    void setFilter(CallsignId source, CallsignId destination, int type);
+
+    /**
+     * @brief Vide la table.
+     */
+    void clear();
+
+private slots:
+    /**
+     * @brief Insère les trames en attente.
+     */
+    void flushPending();
+
+private:
+    using Sequence = quint64;
+    using Postings = std::deque<Sequence>;
+
+    /**
+     * @brief Retourne la trame d'un numéro de séquence conservé.
+     */
+    const FramePtr &frameAtSequence(Sequence seq) const { return m_ring[seq % m_ring.size()]; }
+
+    /**
+     * @brief Indique si une trame satisfait le filtre courant.
+     */
+    bool matches(const Frame &frame) const;
+
+    /**
+     * @brief Retourne le type de paquet d'une trame (Unknown si non décodée).
+     */
+    static int typeOf(const Frame &frame);
+
+    /**
+     * @brief Reconstruit la liste des lignes filtrées à partir des index.
+     */
+    void rebuildRows();
+
+    /**
+     * @brief Retire la plus ancienne trame de l'anneau et des index.
+     */
+    void evictOldest();
+
+    std::vector<FramePtr> m_ring;                 ///< Anneau des trames conservées.
+    Sequence m_next = 0;                          ///< Numéro de séquence de la prochaine trame.
+    std::size_t m_count = 0;                      ///< Nombre de trames conservées.
+    QHash<CallsignId, Postings> m_bySource;       ///< Séquences par indicatif source.
+    QHash<CallsignId, Postings> m_byDestination;  ///< Séquences par indicatif destinataire.
+    QHash<int, Postings> m_byType;                ///< Séquences par type de paquet.
+
+    bool m_filtered = false;                      ///< Indique si un filtre est actif.
+    CallsignId m_filterSource = CallsignTable::NONE;      ///< Filtre sur la source.
+    CallsignId m_filterDestination = CallsignTable::NONE; ///< Filtre sur le destinataire.
+    int m_filterType = ANY_TYPE;                  ///< Filtre sur le type.
+    Postings m_rows;                              ///< Séquences satisfaisant le filtre (si m_filtered), de la plus ancienne à la plus récente.
+    int m_visible = 0;                            ///< Lignes exposées à la vue (chargement progressif).
+
+    QVector<FramePtr> m_pending;                  ///< Trames en attente d'insertion.
+    QTimer m_refreshTimer;                        ///< Minuteur des insertions regroupées.
+};
+
+#endif // FRAMETABLEMODEL_H
@@ -5,9 +5,18 @@
 #include "aprsisclient.h"
 #include "ax25converter.h"
 #include "kisshandler.h"
-#include "mysqlmanager.h"
+#include "flightstateengine.h"
+#include "landingpredictor.h"
+#include "frametablemodel.h"
+#include "kisstcpserver.h"
+#include "tracer.h"
 
+#include <QDateTime>
 #include <QDebug>
+#include <QHeaderView>
+#include <QShortcut>
+#include <QTimer>
+#include <QtConcurrent>
 
 /**
  * @file interface.cpp
@@ -21,30 +30,56 @@
  * @brief Constructeur de la classe Interface.
  *
  * Initialise l'interface utilisateur et instancie les différents gestionnaires
- * (SerialPortManager, APRSISClient, AX25Converter, KISSHandler, MySQLManager). Configure les connexions
- * entre les signaux et les slots pour rediriger les messages vers le log.
+ * (SerialPortManager, APRSISClient, AX25Converter, KISSHandler, KISSTcpServer, FlightStateEngine, LandingPredictor)
+ * ainsi que l'écrivain de base de données, démarré dans son propre thread. Configure les connexions
+ * entre les signaux et les slots. Aucune opération bloquante n'est effectuée ici : l'ouverture du port
+ * série, la connexion APRS-IS et l'énumération des ports sont lancées par startUp() dès que la boucle
+ * d'événements tourne, c'est-à-dire une fois la fenêtre affichée.
  *
+ * @param config Paramètres de lancement (serveur APRS-IS, port série, ...).
  * @param parent Pointeur vers l'objet parent (par défaut nullptr).
  */
-Interface::Interface(QWidget *parent) :
+Interface::Interface(const Configuration &config, QWidget *parent) :
     QWidget(parent),
-    ui(new Ui::Interface)
+    ui(new Ui::Interface),
+    m_config(config),
+    m_firstFrame(true)
 {
+    m_startupTimer.start();
     ui->setupUi(this);
+    // Les trames sont consultées dans la table : la zone de logs ne conserve que les dernières lignes
+    ui->logs->document()->setMaximumBlockCount(5000);
 
     // Instanciation des gestionnaires
     m_serialManager = new SerialPortManager(this);
     m_aprsClient    = new APRSISClient(this);
     m_converter     = new AX25Converter(this);
     m_kissHandler   = new KISSHandler(m_aprsClient, m_converter, this);
-
-    // Connexion à la base de données
-    m_dbManager = new MySQLManager(this);
-    if (!m_dbManager->openConnection()) {
-        ui->logs->append("Erreur de connexion à la base MySQL !");
-    } else {
-        ui->logs->append("Connexion MySQL établie.");
-    }
+    m_flightEngine  = new FlightStateEngine(this);
+    m_predictor     = new LandingPredictor(this);
+    m_frameModel    = new FrameTableModel(m_config.frameHistory, this);
+    m_kissServer    = new KISSTcpServer(this);
+
+    // Table des trames : lignes de hauteur fixe pour un défilement fluide sur des centaines de milliers de trames
+    ui->frameTable->setModel(m_frameModel);
+    ui->frameTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    ui->frameTable->setWordWrap(false);
+    ui->frameTable->verticalHeader()->hide();
+    ui->frameTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui->frameTable->verticalHeader()->setDefaultSectionSize(ui->frameTable->fontMetrics().height() + 6);
+    ui->frameTable->horizontalHeader()->setStretchLastSection(true);
+    ui->filterTypeComboBox->addItem("Tous les types", FrameTableModel::ANY_TYPE);
+    for (APRSPacketType type : {APRSPacketType::Position, APRSPacketType::MicE, APRSPacketType::Message,
+                                APRSPacketType::Telemetry, APRSPacketType::Status, APRSPacketType::Weather,
+                                APRSPacketType::Unknown})
+        ui->filterTypeComboBox->addItem(APRSParser::typeName(type), static_cast<int>(type));
+
+    // Base de données : connexion et écritures de chaque support dans son propre thread
+    m_dbWriter = new DatabaseWriter(m_config, this);
+    connect(m_dbWriter, &DatabaseWriter::stateChanged, this, &Interface::onDatabaseStateChanged);
+    connect(m_dbWriter, &DatabaseWriter::logMessage, this, [this](const QString &msg) {
+        ui->logs->append(msg);
+    });
 
     // Redirection de la journalisation vers l'interface
     connect(m_serialManager, &SerialPortManager::errorOccurred, this, [this](const QString &err) {
@@ -56,21 +91,86 @@ Interface::Interface(QWidget *parent) :
     connect(m_aprsClient, &APRSISClient::messageReceived, this, [this](const QString &msg) {
         ui->logs->append("APRS-IS >> " + msg);
     });
+    connect(m_aprsClient, &APRSISClient::connected, this, [this]() {
+        ui->logs->append(QString("Connecté au serveur APRS-IS %1:%2.").arg(m_config.aprsHost).arg(m_config.aprsPort));
+    });
+    connect(m_aprsClient, &APRSISClient::reconnecting, this, [this](int delay) {
+        ui->logs->append(QString("APRS-IS indisponible, nouvelle tentative dans %1 s.").arg(delay / 1000));
+    });
 
-    // Traitement et stockage des trames LoRa reçues
-    connect(m_kissHandler, &KISSHandler::loRaFrameReceived, this,
-            [this](const QString &src, const QString &dest, const QString &fullTrame, const QString &msg) {
-                if (storeLoRaTrame(src, dest, fullTrame, msg)) {
-                    ui->logs->append("Trame LoRa reçue stockée dans la BDD.");
-                } else {
-                    ui->logs->append("Erreur lors du stockage de la trame reçue dans la BDD.");
-                }
-            });
+    // Stockage des trames reçues (files d'attente vers le thread de chaque support)
+    connect(m_kissHandler, &KISSHandler::frameReceived, m_dbWriter, &DatabaseWriter::storeFrame);
+    connect(m_kissHandler, &KISSHandler::frameReceived, m_frameModel, &FrameTableModel::append);
+
+    // Journalisation et détection des phases de vol pour chaque trame reçue
+    connect(m_kissHandler, &KISSHandler::frameReceived, this, [this](const FramePtr &frame) {
+        TraceSpan span("interface", frame->id());
+        if (m_firstFrame) {
+            m_firstFrame = false;
+            ui->logs->append(QString("Première trame reçue %1 ms après le lancement.").arg(m_startupTimer.elapsed()));
+        }
+        ui->logs->append(QString("Réception KISS => Port: 0x%1, Payload(hex): %2")
+                             .arg(frame->port(), 2, 16, QLatin1Char('0'))
+                             .arg(QString(QByteArray::fromRawData(frame->raw().data(),
+                                                                  static_cast<int>(frame->raw().size())).toHex(' '))));
+        ui->logs->append("Trame convertie => " + Frame::toString(frame->tnc2()));
+        if (const APRSPacket *packet = frame->packet())
+            ui->logs->append(QString("Paquet APRS décodé => %1").arg(APRSParser::typeName(packet->type)));
+
+        m_flightEngine->processFrame(*frame);
+        const APRSPacket *packet = frame->packet();
+        if (packet && APRSParser::isBalloon(packet->source)
+            && (packet->type == APRSPacketType::Position || packet->type == APRSPacketType::MicE)
+            && packet->position.hasAltitude) {
+            QString callsign = frame->sourceName();
+            m_predictor->addPosition(callsign, frame->timestamp(), packet->position.latitude,
+                                     packet->position.longitude, packet->position.altitude,
+                                     m_flightEngine->phase(callsign));
+        }
+    });
+    connect(m_flightEngine, &FlightStateEngine::flightEvent, this, [this](const FlightEvent &event) {
+        ui->logs->append(QString("*** Événement de vol %1 : %2 à %3, altitude %4 m ***")
+                             .arg(event.callsign)
+                             .arg(FlightStateEngine::eventName(event.type))
+                             .arg(QDateTime::fromMSecsSinceEpoch(event.timestamp).toString("HH:mm:ss"))
+                             .arg(event.altitude, 0, 'f', 0));
+    });
+    connect(m_flightEngine, &FlightStateEngine::flightEvent, m_dbWriter, &DatabaseWriter::storeFlightEvent);
+
+    connect(m_predictor, &LandingPredictor::predictionUpdated, this, [this](const LandingPrediction &prediction) {
+        ui->logs->append(QString("Prédiction d'atterrissage %1 : %2, %3 vers %4 (descente %5 m/s)")
+                             .arg(prediction.callsign)
+                             .arg(prediction.latitude, 0, 'f', 5)
+                             .arg(prediction.longitude, 0, 'f', 5)
+                             .arg(QDateTime::fromMSecsSinceEpoch(prediction.landingTime).toString("HH:mm:ss"))
+                             .arg(prediction.descentRate, 0, 'f', 1));
+    });
+    connect(m_predictor, &LandingPredictor::predictionUpdated, m_dbWriter, &DatabaseWriter::storeLandingPrediction);
 
     // Rediriger les données série vers le traitement KISS
     connect(m_serialManager, &SerialPortManager::dataReceived,
             m_kissHandler, &KISSHandler::parseKISSData);
 
+    // Serveur KISS sur TCP : diffusion des trames reçues, émission des trames soumises par les clients
+    connect(m_kissHandler, &KISSHandler::kissFrameReceived, m_kissServer, &KISSTcpServer::broadcastFrame);
+    connect(m_kissServer, &KISSTcpServer::logMessage, this, [this](const QString &msg) {
+        ui->logs->append(msg);
+    });
+    connect(m_kissServer, &KISSTcpServer::transmitRequested, this, [this](const QByteArray &frame) {
+        QByteArray kissFrame = KISSHandler::encodeFrame(static_cast<quint8>(frame.at(0)),
+                                                        frame.constData() + 1, frame.size() - 1);
+        if (m_serialManager->writeData(kissFrame) < 0) {
+            ui->logs->append("Erreur d'envoi sur le port série (trame KISS TCP) !");
+            return;
+        }
+        FramePtr sent = Frame::fromAX25(frame.constData() + 1, frame.size() - 1, static_cast<quint8>(frame.at(0)),
+                                        QDateTime::currentMSecsSinceEpoch());
+        if (sent) {
+            ui->logs->append("Trame KISS TCP envoyée : " + Frame::toString(sent->tnc2()));
+            recordSentFrame(sent);
+        }
+    });
+
     // Connexion des boutons de l'interface
     connect(ui->refreshButton, &QPushButton::clicked,
             this, &Interface::fillPortsComboBox);
@@ -80,36 +180,89 @@ Interface::Interface(QWidget *parent) :
             this, &Interface::onSendButtonClicked);
     connect(ui->aprsCheckBox, &QCheckBox::toggled,
             m_kissHandler, &KISSHandler::setSendToAprs);
+    connect(ui->filterSourceLineEdit, &QLineEdit::editingFinished,
+            this, &Interface::applyFrameFilter);
+    connect(ui->filterDestLineEdit, &QLineEdit::editingFinished,
+            this, &Interface::applyFrameFilter);
+    connect(ui->filterTypeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &Interface::applyFrameFilter);
+    connect(&m_portsWatcher, &QFutureWatcher<QStringList>::finished,
+            this, &Interface::onPortsEnumerated);
+    if (!m_config.tracePath.isEmpty())
+        connect(new QShortcut(QKeySequence("Ctrl+Shift+T"), this), &QShortcut::activated,
+                this, &Interface::dumpTrace);
 
     m_kissHandler->setSendToAprs(ui->aprsCheckBox->isChecked());
 
-    // Initialisation des ports série et connexion au serveur APRS-IS
-    fillPortsComboBox();
-    m_aprsClient->connectToServer("france.aprs2.net", 14580);
+    // Lancement des opérations réseau et matérielles après l'affichage de la fenêtre
+    m_dbWriter->start();
+    QTimer::singleShot(0, this, &Interface::startUp);
 }
 
 /**
  * @brief Destructeur de la classe Interface.
  *
- * Ferme la connexion à la base de données et libère la mémoire allouée pour l'interface utilisateur.
+ * Détruit l'écrivain de la base de données (chaque support écrit ses éléments en attente et se
+ * ferme, puis son thread s'arrête), attend la fin d'une éventuelle énumération de ports, écrit la trace si le traçage
+ * est actif et libère l'interface utilisateur.
  */
 Interface::~Interface()
 {
-    if (m_dbManager)
-        m_dbManager->closeConnection();
+    delete m_dbWriter;
+    m_portsWatcher.waitForFinished();
+    if (!m_config.tracePath.isEmpty())
+        Tracer::dump(m_config.tracePath);
     delete ui;
 }
 
 /**
- * @brief Remplit la combobox avec les ports série disponibles.
+ * @brief Démarre les opérations de lancement une fois la fenêtre affichée.
+ *
+ * Le port série configuré (option --port) est ouvert en premier pour recevoir les trames au plus tôt,
+ * puis la connexion APRS-IS et l'énumération des ports sont lancées, toutes deux asynchrones, et le
+ * serveur KISS TCP, s'il est demandé (option --kiss-port), ouvre son port d'écoute (--kiss-bind).
+ */
+void Interface::startUp()
+{
+    if (!m_config.serialPort.isEmpty()) {
+        ui->portComboBox->setEditText(m_config.serialPort);
+        onStartButtonClicked();
+    }
+    m_aprsClient->connectToServer(m_config.aprsHost, m_config.aprsPort);
+    if (m_config.kissPort > 0) {
+        QString error;
+        if (m_kissServer->listen(QHostAddress(m_config.kissBind), static_cast<quint16>(m_config.kissPort), error))
+            ui->logs->append(QString("Serveur KISS TCP à l'écoute sur %1, port %2.").arg(m_config.kissBind).arg(m_config.kissPort));
+        else
+            ui->logs->append("Erreur : serveur KISS TCP indisponible ! Cause : " + error);
+    }
+    fillPortsComboBox();
+}
+
+/**
+ * @brief Lance l'énumération des ports série disponibles en arrière-plan.
  *
- * Récupère la liste des ports via SerialPortManager et met à jour l'interface en conséquence.
- * Affiche un message dans le log si aucun port n'est détecté.
+ * L'énumération (QSerialPortInfo) peut prendre un temps notable ; elle est exécutée dans le pool
+ * de threads de Qt. Un nouvel appel pendant une énumération en cours est ignoré.
  */
 void Interface::fillPortsComboBox()
 {
+    if (m_portsWatcher.isRunning())
+        return;
+    m_portsWatcher.setFuture(QtConcurrent::run(&SerialPortManager::availablePorts));
+}
+
+/**
+ * @brief Remplit la combobox avec les ports série détectés.
+ *
+ * Le port saisi ou ouvert est conservé dans le champ éditable. Affiche un message dans le log
+ * si aucun port n'est détecté.
+ */
+void Interface::onPortsEnumerated()
+{
+    QStringList ports = m_portsWatcher.result();
+    QString current = ui->portComboBox->currentText();
     ui->portComboBox->clear();
-    QStringList ports = m_serialManager->availablePorts();
     if (ports.isEmpty()) {
         ui->logs->append("Aucun port série détecté.");
     } else {
@@ -117,6 +270,59 @@ void Interface::fillPortsComboBox()
         for (const QString &port : ports)
             ui->portComboBox->addItem(port);
     }
+    if (!current.isEmpty())
+        ui->portComboBox->setEditText(current);
+}
+
+/**
+ * @brief Affiche l'état de santé d'un support de stockage.
+ *
+ * L'étiquette d'état regroupe tous les supports, par exemple
+ * « SQLite : connectée — MySQL : indisponible (42 trame(s) en attente) ».
+ *
+ * @param backend Nom du support.
+ * @param state Le nouvel état.
+ * @param pending Nombre de trames en attente d'écriture sur ce support.
+ */
+void Interface::onDatabaseStateChanged(const QString &backend, DatabaseState state, int pending)
+{
+    QString text = backend + " : " + DatabaseWriter::stateName(state);
+    if (pending > 0)
+        text += QString(" (%1 trame(s) en attente)").arg(pending);
+    m_storageStatus.insert(backend, text);
+    ui->dbStatusLabel->setText("Base de données — " + QStringList(m_storageStatus.values()).join(" — "));
+}
+
+/**
+ * @brief Applique à la table des trames le filtre saisi.
+ *
+ * Les indicatifs saisis sont convertis une fois pour toutes en identifiants internés : le filtrage
+ * compare ensuite des entiers. Un champ vide ne filtre pas.
+ */
+void Interface::applyFrameFilter()
+{
+    auto callsignId = [](const QLineEdit *edit) {
+        QByteArray text = edit->text().trimmed().toUpper().toLatin1();
+        return CallsignTable::intern(std::string_view(text.constData(), static_cast<std::size_t>(text.size())));
+    };
+    ui->filterSourceLineEdit->setText(ui->filterSourceLineEdit->text().trimmed().toUpper());
+    ui->filterDestLineEdit->setText(ui->filterDestLineEdit->text().trimmed().toUpper());
+    m_frameModel->setFilter(callsignId(ui->filterSourceLineEdit),
+                            callsignId(ui->filterDestLineEdit),
+                            ui->filterTypeComboBox->currentData().toInt());
+}
+
+/**
+ * @brief Écrit la trace des étapes de réception dans le fichier configuré (--trace).
+ *
+ * Appelé par le raccourci Ctrl+Maj+T ; le traçage continue après l'écriture.
+ */
+void Interface::dumpTrace()
+{
+    if (Tracer::dump(m_config.tracePath))
+        ui->logs->append("Trace écrite dans " + m_config.tracePath);
+    else
+        ui->logs->append("Erreur : impossible d'écrire la trace dans " + m_config.tracePath);
 }
 
 /**
@@ -191,61 +397,12 @@ QString Interface::buildLoRaFrame()
         .arg(payload);
 }
 
-/**
- * @brief Stocke une trame LoRa dans la base de données.
- *
- * Vérifie si la machine source et la machine destination existent dans la base de données,
- * les insère automatiquement si nécessaire, puis stocke la trame et son message associé.
- *
- * @param source Indicatif de la machine source.
- * @param destination Indicatif de la machine destination.
- * @param fullTrame La trame LoRa complète à stocker.
- * @param message Le message extrait de la trame.
- * @return bool @c true si le stockage a réussi, @c false sinon.
- */
-bool Interface::storeLoRaTrame(const QString &source, const QString &destination,
-                               const QString &fullTrame, const QString &message)
-{
-    bool success = true;
-
-    // Vérifier et insérer la machine source si nécessaire
-    if (!m_dbManager->machineExists(source)) {
-        if (!m_dbManager->insertMachine(source, "Machine ajoutée automatiquement")) {
-            ui->logs->append("Erreur lors de l'insertion de la machine source dans la BDD.");
-            success = false;
-        }
-    }
-
-    // Vérifier et insérer la machine destination si nécessaire (uniquement si la précédente a réussi)
-    if (success && !m_dbManager->machineExists(destination)) {
-        if (!m_dbManager->insertMachine(destination, "Machine ajoutée automatiquement")) {
-            ui->logs->append("Erreur lors de l'insertion de la machine destination dans la BDD.");
-            success = false;
-        }
-    }
-
-    // Si tout est en ordre, procéder à l'insertion de la trame
-    if (success) {
-        QString queryStr = QString("INSERT INTO trames (source, destination, trame, message) "
-                                   "VALUES ('%1', '%2', '%3', '%4')")
-                               .arg(source)
-                               .arg(destination)
-                               .arg(fullTrame)
-                               .arg(message);
-        if (!m_dbManager->executeNonQuery(queryStr)) {
-            ui->logs->append("Erreur DB: " + m_dbManager->database().lastError().text());
-            success = false;
-        }
-    }
-
-    return success;
-}
-
 /**
  * @brief Gère l'envoi d'une trame.
  *
  * Vérifie que le message à envoyer n'est pas vide, construit et envoie une trame APRS et une trame LoRa.
- * La trame LoRa est convertie en trame AX.25 avant d'être transmise via le port série, puis stockée en base.
+ * La trame LoRa est convertie en trame AX.25 avant d'être transmise via le port série, puis stockée en base
+ * sous forme de Frame, comme les trames reçues.
  */
 void Interface::onSendButtonClicked()
 {
@@ -270,21 +427,7 @@ void Interface::onSendButtonClicked()
         return;
     }
 
-    QByteArray kissFrame;
-    kissFrame.append((char)0xC0);
-    kissFrame.append((char)0x00);
-    for (unsigned char b : ax25Frame) {
-        if (b == 0xC0) {
-            kissFrame.append((char)0xDB);
-            kissFrame.append((char)0xDC);
-        } else if (b == 0xDB) {
-            kissFrame.append((char)0xDB);
-            kissFrame.append((char)0xDD);
-        } else {
-            kissFrame.append((char)b);
-        }
-    }
-    kissFrame.append((char)0xC0);
+    QByteArray kissFrame = KISSHandler::encodeFrame(0x00, ax25Frame.constData(), ax25Frame.size());
 
     qint64 written = m_serialManager->writeData(kissFrame);
     if (written < 0) {
@@ -293,18 +436,24 @@ void Interface::onSendButtonClicked()
         ui->logs->append("Trame LoRa envoyée (hex) : " + QString(kissFrame.toHex(' ')));
     }
 
-    QString sourceStr = ui->sourceLineEdit->text().trimmed();
-    if (sourceStr.isEmpty())
-        sourceStr = "F4LTZ";
-    QString destStr = ui->destLineEdit->text().trimmed();
-    if (destStr.isEmpty())
-        destStr = "F4KMN";
-    int pos = loraTNC2.lastIndexOf(':');
-    QString messageUtil = (pos != -1) ? loraTNC2.mid(pos + 1).trimmed() : "";
-
-    if (storeLoRaTrame(sourceStr, destStr, loraTNC2, messageUtil)) {
-        ui->logs->append("Trame LoRa stockée dans la BDD.");
-    } else {
+    QByteArray line = loraTNC2.toLatin1();
+    FramePtr sent = Frame::fromTNC2(std::string_view(line.constData(), line.size()),
+                                    QDateTime::currentMSecsSinceEpoch());
+    if (sent)
+        recordSentFrame(sent);
+    else
         ui->logs->append("Erreur lors du stockage de la trame dans la BDD.");
-    }
+}
+
+/**
+ * @brief Enregistre une trame émise.
+ *
+ * La trame est écrite en base (files d'attente vers le thread de chaque support) et ajoutée à la table des trames.
+ *
+ * @param frame La trame émise.
+ */
+void Interface::recordSentFrame(const FramePtr &frame)
+{
+    m_dbWriter->storeFrame(frame);
+    m_frameModel->append(frame);
 }
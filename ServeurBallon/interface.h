@@ -11,6 +11,13 @@
  */
 
 #include <QWidget>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QStringList>
+#include <QMap>
+
+#include "configuration.h"
+#include "databasewriter.h"
 
 namespace Ui {
 class Interface;
@@ -28,7 +35,10 @@ class APRSISClient;
 class AX25Converter;
 class KISSHandler;
 class WebSocketServer;
-class MySQLManager;
+class FlightStateEngine;
+class LandingPredictor;
+class FrameTableModel;
+class KISSTcpServer;
 
 class Interface : public QWidget
 {
@@ -37,26 +47,56 @@ class Interface : public QWidget
 public:
     /**
      * @brief Constructeur de la classe Interface.
+     * @param config Paramètres de lancement (serveur APRS-IS, ...).
      * @param parent Pointeur vers l'objet parent (par défaut nullptr).
      */
-    explicit Interface(QWidget *parent = nullptr);
+    explicit Interface(const Configuration &config, QWidget *parent = nullptr);
 
     /**
      * @brief Destructeur de la classe Interface.
      *
-     * Libère les ressources allouées et ferme la connexion à la base de données si nécessaire.
+     * Arrête les threads de la base de données et libère les ressources allouées.
      */
     ~Interface();
 
 private slots:
     /**
-     * @brief Remplit la combobox avec les ports série disponibles.
+     * @brief Démarre les opérations de lancement une fois la fenêtre affichée.
+     *
+     * Ouvre le port série configuré, lance la connexion APRS-IS, le serveur KISS TCP et l'énumération des ports.
+     */
+    void startUp();
+
+    /**
+     * @brief Lance l'énumération des ports série disponibles en arrière-plan.
      *
-     * Interroge le gestionnaire SerialPortManager et met à jour l'interface avec la liste
-     * des ports détectés.
+     * Le résultat est traité par onPortsEnumerated, sans bloquer l'interface.
      */
     void fillPortsComboBox();
 
+    /**
+     * @brief Remplit la combobox avec les ports série détectés.
+     */
+    void onPortsEnumerated();
+
+    /**
+     * @brief Affiche l'état de santé d'un support de stockage.
+     * @param backend Nom du support.
+     * @param state Le nouvel état.
+     * @param pending Nombre de trames en attente d'écriture sur ce support.
+     */
+    void onDatabaseStateChanged(const QString &backend, DatabaseState state, int pending);
+
+    /**
+     * @brief Applique à la table des trames le filtre saisi (source, destination, type).
+     */
+    void applyFrameFilter();
+
+    /**
+     * @brief Écrit la trace des étapes de réception dans le fichier configuré (--trace).
+     */
+    void dumpTrace();
+
     /**
      * @brief Gère l'action du bouton "Start".
      *
@@ -74,11 +114,20 @@ private slots:
 
 private:
     Ui::Interface *ui;                   ///< Pointeur vers l'interface utilisateur générée par Qt Designer.
+    Configuration     m_config;           ///< Paramètres de lancement.
     SerialPortManager *m_serialManager;  ///< Gestionnaire des communications série.
     APRSISClient     *m_aprsClient;       ///< Client pour la communication avec le serveur APRS-IS.
     AX25Converter    *m_converter;        ///< Outil de conversion entre les formats TNC2 et AX.25.
     KISSHandler      *m_kissHandler;      ///< Gestionnaire pour le protocole KISS.
-    MySQLManager     *m_dbManager;        ///< Gestionnaire de la base de données MySQL.
+    DatabaseWriter   *m_dbWriter;         ///< Écrivain asynchrone de la base de données (un thread par support).
+    QFutureWatcher<QStringList> m_portsWatcher; ///< Suivi de l'énumération des ports en arrière-plan.
+    QElapsedTimer     m_startupTimer;     ///< Chronomètre depuis le lancement (délai de première trame).
+    bool              m_firstFrame;       ///< Indique si aucune trame n'a encore été reçue.
+    QMap<QString, QString> m_storageStatus; ///< État affiché de chaque support de stockage.
+    FlightStateEngine *m_flightEngine;    ///< Détection des phases de vol (montée, éclatement, descente, atterrissage).
+    LandingPredictor *m_predictor;        ///< Prédiction du point d'atterrissage pendant la descente.
+    FrameTableModel  *m_frameModel;       ///< Modèle de la table des trames récentes.
+    KISSTcpServer    *m_kissServer;       ///< Serveur KISS sur TCP partageant le modem avec d'autres applications.
 
     /**
      * @brief Construit une trame LoRa au format TNC2.
@@ -99,19 +148,10 @@ private:
     QString buildAprsFrame();
 
     /**
-     * @brief Stocke une trame LoRa dans la base de données.
-     *
-     * Vérifie l'existence des machines source et destination, insère celles-ci si nécessaire,
-     * puis insère la trame et son message associé dans la base.
-     *
-     * @param source Indicatif de la machine source.
-     * @param destination Indicatif de la machine destination.
-     * @param fullTrame La trame complète à stocker.
-     * @param message Le message extrait de la trame.
-     * @return bool @c true si le stockage a réussi, @c false sinon.
+     * @brief Enregistre une trame émise (base de données et table des trames).
+     * @param frame La trame émise.
      */
-    bool storeLoRaTrame(const QString &source, const QString &destination,
-                        const QString &fullTrame, const QString &message);
+    void recordSentFrame(const FramePtr &frame);
 };
 
 #endif // INTERFACE_H
@@ -1,21 +1,25 @@
 #include "kisshandler.h"
 #include "aprsisclient.h"
 #include "ax25converter.h"
+#include "tracer.h"
+
+#include <QDateTime>
 
 /**
  * @file KISSHandler.cpp
  * @brief Implémentation de la classe KISSHandler.
  *
  * Ce fichier contient l'implémentation des méthodes de la classe KISSHandler, qui gère
- * la réception et le décodage des données au format KISS, leur conversion en trame TNC2,
- * et la transmission vers APRS-IS ou la notification de réception de trames LoRa.
+ * la réception et le décodage des données au format KISS, la construction des trames (Frame)
+ * et leur diffusion vers l'interface, la base de données et APRS-IS.
  */
 
 /**
  * @brief Constructeur de la classe KISSHandler.
  *
  * Initialise l'objet KISSHandler en associant le client APRSISClient et le convertisseur AX25Converter,
- * et en désactivant par défaut l'envoi des trames vers APRS-IS.
+ * et en désactivant par défaut l'envoi des trames vers APRS-IS. Le tampon de reconstitution est
+ * dimensionné une fois pour toutes à la taille maximale d'une trame.
  *
  * @param aprsClient Pointeur vers le client APRSISClient.
  * @param converter Pointeur vers l'objet AX25Converter.
@@ -25,8 +29,12 @@ KISSHandler::KISSHandler(APRSISClient *aprsClient, AX25Converter *converter, QOb
     : QObject(parent),
     m_aprsClient(aprsClient),
     m_converter(converter),
-    m_sendToAprs(false)
-{ }
+    m_sendToAprs(false),
+    m_inFrame(false),
+    m_inEscape(false)
+{
+    m_frameBuffer.reserve(Frame::MAX_AX25_SIZE + 1);
+}
 
 /**
  * @brief Active ou désactive l'envoi des trames converties vers APRS-IS.
@@ -52,31 +60,28 @@ void KISSHandler::setSendToAprs(bool enabled)
  */
 void KISSHandler::parseKISSData(const QByteArray &data)
 {
-    static QByteArray frameBuffer;
-    static bool inFrame = false;
-    static bool inEscape = false;
-
+    TraceSpan span("deframe KISS");
     for (unsigned char c : data) {
         if (c == 0xC0) {
-            if (inFrame) {
-                if (!frameBuffer.isEmpty())
-                    processKISSFrame(frameBuffer);
-                frameBuffer.clear();
-                inFrame = false;
+            if (m_inFrame) {
+                if (!m_frameBuffer.isEmpty())
+                    processKISSFrame(m_frameBuffer);
+                m_frameBuffer.resize(0);
+                m_inFrame = false;
             } else {
-                frameBuffer.clear();
-                inFrame = true;
+                m_frameBuffer.resize(0);
+                m_inFrame = true;
             }
-            inEscape = false;
-        } else if (!inFrame) {
+            m_inEscape = false;
+        } else if (!m_inFrame) {
             continue;
         } else if (c == 0xDB) {
-            inEscape = true;
-        } else if (inEscape) {
-            frameBuffer.append((char)((c == 0xDC) ? 0xC0 : (c == 0xDD) ? 0xDB : c));
-            inEscape = false;
+            m_inEscape = true;
+        } else if (m_inEscape) {
+            m_frameBuffer.append((char)((c == 0xDC) ? 0xC0 : (c == 0xDD) ? 0xDB : c));
+            m_inEscape = false;
         } else {
-            frameBuffer.append((char)c);
+            m_frameBuffer.append((char)c);
         }
     }
 }
@@ -84,9 +89,9 @@ void KISSHandler::parseKISSData(const QByteArray &data)
 /**
  * @brief Traite une trame KISS complète.
  *
- * Extrait le byte de port et le payload AX.25 de la trame, convertit ce dernier en format TNC2
- * via l'objet AX25Converter, et émet des signaux pour la journalisation. Si la conversion est réussie,
- * la trame TNC2 est également émise via le signal loRaFrameReceived et, si activé, envoyée vers APRS-IS.
+ * Extrait le byte de port et construit la Frame directement depuis le payload AX.25, sans copie
+ * intermédiaire. Si la construction réussit, la trame est émise via le signal frameReceived et,
+ * si activé, envoyée vers APRS-IS.
  *
  * @param frame La trame KISS complète à traiter.
  */
@@ -94,49 +99,62 @@ void KISSHandler::processKISSFrame(const QByteArray &frame)
 {
     if (frame.isEmpty())
         return;
+    emit kissFrameReceived(frame);
 
-    // Récupérer le byte de port et le payload AX.25
+    // Récupérer le byte de port et construire la trame depuis le payload AX.25
     unsigned char portByte = static_cast<unsigned char>(frame.at(0));
-    QByteArray ax25Payload = frame.mid(1);
-
-    emit logMessage(QString("Réception KISS => Port: 0x%1, Payload(hex): %2")
-                        .arg(portByte, 2, 16, QLatin1Char('0'))
-                        .arg(QString(ax25Payload.toHex(' '))));
+    FramePtr received;
+    {
+        TraceSpan span("decodage AX.25");
+        received = Frame::fromAX25(frame.constData() + 1, frame.size() - 1, portByte,
+                                   QDateTime::currentMSecsSinceEpoch());
+        if (received)
+            span.setFrame(received->id());
+    }
+    if (!received) {
+        emit logMessage(QString("Impossible de convertir AX.25 -> TNC2 (pas UI frame?), Port: 0x%1, Payload(hex): %2")
+                            .arg(portByte, 2, 16, QLatin1Char('0'))
+                            .arg(QString(frame.mid(1).toHex(' '))));
+        return;
+    }
 
-    // Conversion de la trame AX.25 en format TNC2
-    QString tnc2 = m_converter->convertAX25ToTNC2(ax25Payload);
-    if (!tnc2.isEmpty()) {
-        emit logMessage("Trame convertie => " + tnc2);
+    emit frameReceived(received);
 
-        // Extraction des informations source, destination et message
-        int posGT = tnc2.indexOf('>');
-        QString src = (posGT != -1) ? tnc2.left(posGT).trimmed() : "";
-        QString dest;
-        QString messageUtil;
+    // Envoi vers APRS-IS si activé
+    if (m_sendToAprs) {
+        TraceSpan span("passerelle APRS-IS", received->id());
+        m_aprsClient->sendFrame(*received);
+    }
+}
 
-        int posDoubleColon = tnc2.indexOf("::");
-        if (posDoubleColon != -1) {
-            int posColonAfter = tnc2.indexOf(':', posDoubleColon + 2);
-            if (posColonAfter != -1) {
-                dest = tnc2.mid(posDoubleColon + 2, posColonAfter - (posDoubleColon + 2)).trimmed();
-                messageUtil = tnc2.mid(posColonAfter + 1).trimmed();
-            }
+/**
+ * @brief Encode une trame AX.25 au format KISS.
+ *
+ * La trame est encadrée par deux délimiteurs 0xC0 ; les octets 0xC0 et 0xDB du contenu sont
+ * remplacés par les séquences d'échappement 0xDB 0xDC et 0xDB 0xDD.
+ *
+ * @param port Octet de port et de commande KISS.
+ * @param data Pointeur vers les octets AX.25.
+ * @param size Nombre d'octets.
+ * @return QByteArray La trame KISS.
+ */
+QByteArray KISSHandler::encodeFrame(quint8 port, const char *data, int size)
+{
+    QByteArray kissFrame;
+    kissFrame.reserve(2 * size + 4);
+    kissFrame.append((char)0xC0);
+    for (int i = -1; i < size; ++i) {
+        unsigned char b = (i < 0) ? port : static_cast<unsigned char>(data[i]);
+        if (b == 0xC0) {
+            kissFrame.append((char)0xDB);
+            kissFrame.append((char)0xDC);
+        } else if (b == 0xDB) {
+            kissFrame.append((char)0xDB);
+            kissFrame.append((char)0xDD);
         } else {
-            int posColon = tnc2.indexOf(':', posGT + 1);
-            if (posColon != -1) {
-                dest = tnc2.mid(posGT + 1, posColon - posGT - 1).trimmed();
-                messageUtil = tnc2.mid(posColon + 1).trimmed();
-            }
-        }
-
-        emit loRaFrameReceived(src, dest, tnc2, messageUtil);
-
-        // Envoi vers APRS-IS si activé
-        if (m_sendToAprs) {
-            m_aprsClient->sendLine(tnc2 + "\r\n");
-            emit logMessage("Message APRS envoyé depuis la réception LoRa");
+            kissFrame.append((char)b);
         }
-    } else {
-        emit logMessage("Impossible de convertir AX.25 -> TNC2 (pas UI frame?)");
     }
+    kissFrame.append((char)0xC0);
+    return kissFrame;
 }
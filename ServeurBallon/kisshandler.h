@@ -6,12 +6,15 @@
  * @brief Déclaration de la classe KISSHandler.
  *
  * Ce fichier définit la classe KISSHandler qui gère l'interprétation des données
- * au format KISS. Elle se charge de décoder les trames KISS, de convertir les données
- * en trames TNC2 via un convertisseur AX.25 et d'émettre des signaux pour la journalisation
- * ou la transmission vers APRS-IS et la gestion des trames LoRa.
+ * au format KISS. Elle se charge de décoder les trames KISS, de construire les trames reçues
+ * (Frame) et de les transmettre par pointeur partagé à l'interface, à la base de données
+ * et à la passerelle APRS-IS.
  */
 
 #include <QObject>
+#include <QByteArray>
+
+#include "frame.h"
 
 class APRSISClient;
 class AX25Converter;
@@ -20,9 +23,9 @@ class AX25Converter;
  * @brief Gestionnaire de trames KISS.
  *
  * La classe KISSHandler permet de traiter les données brutes reçues au format KISS.
- * Elle décode ces données pour extraire une trame AX.25, la convertit en format TNC2,
- * et transmet des informations via des signaux, notamment pour l'envoi de trames vers APRS-IS
- * et pour la notification de réception de trames LoRa.
+ * Elle décode ces données pour extraire une trame AX.25, construit une Frame immuable
+ * (texte TNC2, indicatifs internés, paquet APRS décodé) et la diffuse via le signal frameReceived.
+ * Si activé, la trame est aussi relayée vers APRS-IS.
  */
 class KISSHandler : public QObject {
     Q_OBJECT
@@ -59,6 +62,16 @@ public:
      */
     void parseKISSData(const QByteArray &data);
 
+    /**
+     * @brief Encode une trame AX.25 au format KISS (délimiteurs, octet de port, échappements).
+     *
+     * @param port Octet de port et de commande KISS (0x00 : données, port 0).
+     * @param data Pointeur vers les octets AX.25.
+     * @param size Nombre d'octets.
+     * @return QByteArray La trame KISS prête à être écrite.
+     */
+    static QByteArray encodeFrame(quint8 port, const char *data, int size);
+
 signals:
     /**
      * @brief Signal pour la journalisation des messages.
@@ -70,26 +83,28 @@ signals:
     void logMessage(const QString &msg);
 
     /**
-     * @brief Signal pour la réception d'une trame LoRa.
+     * @brief Signal émis pour chaque trame LoRa reçue et décodée.
      *
-     * Émis lorsqu'une trame LoRa a été extraite et convertie depuis une trame KISS.
+     * La trame est partagée : les récepteurs la conservent aussi longtemps que nécessaire
+     * sans copie, y compris à travers des connexions en file d'attente.
+     *
+     * @param frame La trame reçue.
+     */
+    void frameReceived(const FramePtr &frame);
+
+    /**
+     * @brief Signal émis pour chaque trame KISS complète, décodable ou non.
      *
-     * @param source L'indicatif source de la trame.
-     * @param destination L'indicatif destination de la trame.
-     * @param fullTrame La trame complète au format TNC2.
-     * @param message Le message extrait de la trame.
+     * @param frame La trame sans délimiteurs ni échappements (octet de port puis octets AX.25).
      */
-    void loRaFrameReceived(const QString &source,
-                           const QString &destination,
-                           const QString &fullTrame,
-                           const QString &message);
+    void kissFrameReceived(const QByteArray &frame);
 
 private:
     /**
      * @brief Traite une trame KISS complète.
      *
-     * Décode la trame KISS en extrayant le port et le payload, convertit la trame AX.25 en format TNC2,
-     * puis émet des signaux pour la journalisation et, si activé, pour l'envoi vers APRS-IS.
+     * Décode la trame KISS en extrayant le port et le payload, construit la Frame correspondante,
+     * puis émet le signal frameReceived et, si activé, relaie la trame vers APRS-IS.
      *
      * @param frame La trame KISS complète à traiter.
      */
@@ -98,6 +113,9 @@ private:
     APRSISClient *m_aprsClient;     ///< Pointeur vers le client APRSISClient pour l'envoi de trames APRS.
     AX25Converter *m_converter;      ///< Pointeur vers l'objet AX25Converter pour la conversion des trames.
     bool m_sendToAprs;               ///< Indique si les trames converties doivent être envoyées vers APRS-IS.
+    QByteArray m_frameBuffer;        ///< Trame KISS en cours de reconstitution (capacité conservée).
+    bool m_inFrame;                  ///< Indique si un délimiteur de début de trame a été reçu.
+    bool m_inEscape;                 ///< Indique si le dernier octet reçu est un échappement.
 };
 
 #endif // KISSHANDLER_H
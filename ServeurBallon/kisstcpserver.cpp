@@ -0,0 +1,233 @@
+#include "kisstcpserver.h"
+#include "kisshandler.h"
+#include "frame.h"
+
+#include <algorithm>
+
+/**
+ * @file kisstcpserver.cpp
+ * @brief Implémentation de la classe KISSTcpServer.
+ *
+ * Ce fichier contient l'acceptation des clients, la diffusion des trames reçues avec des files
+ * par client bornées, et le décodage des trames KISS soumises par les clients.
+ */
+
+/**
+ * @brief Constructeur de la classe KISSTcpServer.
+ *
+ * @param parent Pointeur vers l'objet parent (par défaut nullptr).
+ */
+KISSTcpServer::KISSTcpServer(QObject *parent)
+    : QObject(parent),
+    m_server(this)
+{
+    m_server.setMaxPendingConnections(MAX_CLIENTS);
+    connect(&m_server, &QTcpServer::newConnection, this, &KISSTcpServer::onNewConnection);
+}
+
+/**
+ * @brief Destructeur de la classe KISSTcpServer.
+ *
+ * Les sockets sont détachés du serveur avant leur fermeture : aucun signal n'est plus traité.
+ */
+KISSTcpServer::~KISSTcpServer()
+{
+    for (auto &client : m_clients) {
+        client->socket->disconnect(this);
+        client->socket->abort();
+    }
+}
+
+/**
+ * @brief Ouvre le port d'écoute.
+ *
+ * @param address L'adresse d'écoute.
+ * @param port Le port TCP.
+ * @param errorString Référence à une chaîne pour retourner le message d'erreur en cas d'échec.
+ * @return bool @c true si le serveur écoute.
+ */
+bool KISSTcpServer::listen(const QHostAddress &address, quint16 port, QString &errorString)
+{
+    if (address.isNull()) {
+        errorString = "adresse d'écoute invalide";
+        return false;
+    }
+    if (!m_server.listen(address, port)) {
+        errorString = m_server.errorString();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Accepte les connexions en attente.
+ *
+ * Au-delà de MAX_CLIENTS, les nouvelles connexions sont refusées. Les trames étant courtes et
+ * sensibles à la latence, l'algorithme de Nagle est désactivé.
+ */
+void KISSTcpServer::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+        if (clientCount() >= MAX_CLIENTS) {
+            emit logMessage(QString("KISS TCP : connexion de %1 refusée (%2 clients au maximum).")
+                                .arg(socket->peerAddress().toString())
+                                .arg(MAX_CLIENTS));
+            socket->abort();
+            socket->deleteLater();
+            continue;
+        }
+
+        auto client = std::make_unique<Client>();
+        client->socket = socket;
+        client->peer = QString("%1:%2").arg(socket->peerAddress().toString()).arg(socket->peerPort());
+        client->frameBuffer.reserve(Frame::MAX_AX25_SIZE + 1);
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+        Client *raw = client.get();
+        connect(socket, &QTcpSocket::readyRead, this, [this, raw]() {
+            readClient(*raw);
+            removeDroppedClients();
+        });
+        connect(socket, &QTcpSocket::bytesWritten, this, [this, raw]() {
+            flushClient(*raw);
+        });
+        connect(socket, &QTcpSocket::disconnected, this, [this, raw]() {
+            dropClient(*raw, "déconnexion");
+            removeDroppedClients();
+        });
+        m_clients.push_back(std::move(client));
+        emit logMessage(QString("KISS TCP : client %1 connecté (%2 client(s)).").arg(raw->peer).arg(clientCount()));
+    }
+}
+
+/**
+ * @brief Diffuse une trame reçue du modem à tous les clients.
+ *
+ * La trame est encodée une seule fois ; chaque file de client ne contient qu'une référence
+ * vers ce tampon. Un client dont la file dépasserait MAX_CLIENT_BACKLOG octets est déconnecté.
+ *
+ * @param frame La trame sans délimiteurs ni échappements (octet de port puis octets AX.25).
+ */
+void KISSTcpServer::broadcastFrame(const QByteArray &frame)
+{
+    if (m_clients.empty() || frame.isEmpty())
+        return;
+
+    const QByteArray kissFrame = KISSHandler::encodeFrame(static_cast<quint8>(frame.at(0)),
+                                                          frame.constData() + 1, frame.size() - 1);
+    for (auto &client : m_clients) {
+        if (client->dropped)
+            continue;
+        if (client->pendingBytes + kissFrame.size() > MAX_CLIENT_BACKLOG) {
+            dropClient(*client, QString("client trop lent, %1 octets en attente").arg(client->pendingBytes));
+            continue;
+        }
+        client->pending.enqueue(kissFrame);
+        client->pendingBytes += kissFrame.size();
+        flushClient(*client);
+    }
+    removeDroppedClients();
+}
+
+/**
+ * @brief Confie au socket d'un client les trames en attente.
+ *
+ * Le tampon d'écriture du socket est limité à WRITE_WINDOW octets : les trames suivantes restent
+ * dans la file (sans copie) jusqu'à ce que le client ait lu les précédentes.
+ *
+ * @param client Le client.
+ */
+void KISSTcpServer::flushClient(Client &client)
+{
+    while (!client.dropped && !client.pending.isEmpty() && client.socket->bytesToWrite() < WRITE_WINDOW) {
+        const QByteArray kissFrame = client.pending.dequeue();
+        client.pendingBytes -= kissFrame.size();
+        client.socket->write(kissFrame);
+    }
+}
+
+/**
+ * @brief Lit et décode les trames soumises par un client.
+ *
+ * Même découpage que KISSHandler::parseKISSData ; une trame plus longue que la plus longue trame
+ * AX.25 possible est ignorée jusqu'au délimiteur suivant.
+ *
+ * @param client Le client.
+ */
+void KISSTcpServer::readClient(Client &client)
+{
+    const QByteArray data = client.socket->readAll();
+    for (unsigned char c : data) {
+        if (c == 0xC0) {
+            if (client.inFrame && !client.overflow && !client.frameBuffer.isEmpty())
+                processSubmittedFrame(client);
+            client.frameBuffer.resize(0);
+            client.inFrame = true;
+            client.inEscape = false;
+            client.overflow = false;
+        } else if (!client.inFrame || client.overflow) {
+            continue;
+        } else if (client.frameBuffer.size() > Frame::MAX_AX25_SIZE) {
+            client.overflow = true;
+        } else if (c == 0xDB) {
+            client.inEscape = true;
+        } else if (client.inEscape) {
+            client.frameBuffer.append((char)((c == 0xDC) ? 0xC0 : (c == 0xDD) ? 0xDB : c));
+            client.inEscape = false;
+        } else {
+            client.frameBuffer.append((char)c);
+        }
+    }
+}
+
+/**
+ * @brief Traite une trame complète soumise par un client.
+ *
+ * Seules les trames de données (commande 0 dans les 4 bits de poids faible de l'octet de port)
+ * contenant au moins deux adresses AX.25, le contrôle et le PID sont transmises.
+ *
+ * @param client Le client.
+ */
+void KISSTcpServer::processSubmittedFrame(const Client &client)
+{
+    const QByteArray &frame = client.frameBuffer;
+    if ((static_cast<quint8>(frame.at(0)) & 0x0F) != 0)
+        return;
+    if (frame.size() < 1 + 2 * 7 + 2) {
+        emit logMessage(QString("KISS TCP : trame trop courte ignorée (client %1).").arg(client.peer));
+        return;
+    }
+    emit transmitRequested(QByteArray(frame.constData(), frame.size()));
+}
+
+/**
+ * @brief Déconnecte un client.
+ *
+ * Le socket est détaché du serveur puis fermé ; sa destruction est différée au retour dans
+ * la boucle d'événements, et le client est retiré de la liste par removeDroppedClients().
+ *
+ * @param client Le client.
+ * @param reason Cause de la déconnexion, pour la journalisation.
+ */
+void KISSTcpServer::dropClient(Client &client, const QString &reason)
+{
+    if (client.dropped)
+        return;
+    client.dropped = true;
+    client.pending.clear();
+    client.pendingBytes = 0;
+    client.socket->disconnect(this);
+    client.socket->abort();
+    client.socket->deleteLater();
+    emit logMessage(QString("KISS TCP : client %1 déconnecté (%2).").arg(client.peer, reason));
+}
+
+/**
+ * @brief Retire de la liste les clients déconnectés.
+ */
+void KISSTcpServer::removeDroppedClients()
+{
+    m_clients.erase(std::remove_if(m_clients.begin(), m_clients.end(),
+                                   [](const std::unique_ptr<Client> &client) { return client->dropped; }),
+                    m_clients.end());
+}
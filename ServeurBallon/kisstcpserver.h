@@ -0,0 +1,144 @@
+#ifndef KISSTCPSERVER_H
+#define KISSTCPSERVER_H
+
+/**
+ * @file kisstcpserver.h
+ * @brief Déclaration de la classe KISSTcpServer.
+ *
+ * Ce fichier définit le serveur KISS sur TCP (port 8001 comme Direwolf, à activer explicitement) : d'autres applications
+ * (second décodeur, enregistreur, cartographie) reçoivent toutes les trames du modem LoRa et peuvent
+ * lui soumettre des trames à émettre, sans se disputer le port série.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QQueue>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Serveur KISS sur TCP.
+ *
+ * Chaque trame reçue du modem est encodée une seule fois au format KISS ; le tampon obtenu est partagé
+ * (QByteArray à partage implicite) par les files de tous les clients. Un client ne reçoit dans
+ * son socket que WRITE_WINDOW octets d'avance, le reste attendant dans sa file : un client lent
+ * dont la file dépasse MAX_CLIENT_BACKLOG octets est déconnecté, sans jamais retarder la lecture
+ * du port série ni les autres clients.
+ *
+ * Les trames KISS de données envoyées par un client sont décodées et transmises par le signal
+ * transmitRequested ; les commandes de paramétrage KISS (TXDELAY, persistance...) sont ignorées.
+ */
+class KISSTcpServer : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int DEFAULT_PORT = 8001;                    ///< Port d'écoute par défaut (celui de Direwolf).
+    static constexpr int MAX_CLIENTS = 16;                       ///< Nombre maximal de clients simultanés.
+    static constexpr qint64 WRITE_WINDOW = 16 * 1024;            ///< Octets confiés d'avance au socket d'un client.
+    static constexpr qint64 MAX_CLIENT_BACKLOG = 256 * 1024;     ///< Octets en attente au-delà desquels un client est déconnecté.
+
+    /**
+     * @brief Constructeur de la classe KISSTcpServer.
+     * @param parent Pointeur vers l'objet parent (par défaut nullptr).
+     */
+    explicit KISSTcpServer(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructeur : ferme les connexions des clients.
+     */
+    ~KISSTcpServer();
+
+    /**
+     * @brief Ouvre le port d'écoute.
+     *
+     * Un client peut faire émettre la radio sans authentification : l'adresse par défaut de
+     * l'application est la boucle locale, l'écoute sur le réseau doit être demandée (--kiss-bind).
+     *
+     * @param address L'adresse d'écoute.
+     * @param port Le port TCP.
+     * @param errorString Référence à une chaîne pour retourner le message d'erreur en cas d'échec.
+     * @return bool @c true si le serveur écoute.
+     */
+    bool listen(const QHostAddress &address, quint16 port, QString &errorString);
+
+    /**
+     * @brief Retourne le nombre de clients connectés.
+     */
+    int clientCount() const { return static_cast<int>(m_clients.size()); }
+
+public slots:
+    /**
+     * @brief Diffuse une trame reçue du modem à tous les clients.
+     * @param frame La trame sans délimiteurs ni échappements (octet de port puis octets AX.25).
+     */
+    void broadcastFrame(const QByteArray &frame);
+
+signals:
+    /**
+     * @brief Signal émis pour chaque trame de données soumise par un client.
+     * @param frame La trame sans délimiteurs ni échappements (octet de port puis octets AX.25).
+     */
+    void transmitRequested(const QByteArray &frame);
+
+    /**
+     * @brief Signal pour la journalisation des messages (connexions, déconnexions, clients lents).
+     * @param msg Le message à journaliser.
+     */
+    void logMessage(const QString &msg);
+
+private slots:
+    /**
+     * @brief Accepte les connexions en attente.
+     */
+    void onNewConnection();
+
+private:
+    /**
+     * @brief Client connecté et trames en attente d'envoi.
+     */
+    struct Client {
+        QTcpSocket *socket = nullptr;  ///< Socket du client.
+        QString peer;                  ///< Adresse du client, pour la journalisation.
+        QQueue<QByteArray> pending;    ///< Trames KISS en attente (tampons partagés entre clients).
+        qint64 pendingBytes = 0;       ///< Taille totale des trames en attente.
+        QByteArray frameBuffer;        ///< Trame soumise en cours de reconstitution.
+        bool inFrame = false;          ///< Indique si un délimiteur de début de trame a été reçu.
+        bool inEscape = false;         ///< Indique si le dernier octet reçu est un échappement.
+        bool overflow = false;         ///< Trame soumise trop longue, ignorée jusqu'au prochain délimiteur.
+        bool dropped = false;          ///< Client déconnecté, à retirer de la liste.
+    };
+
+    /**
+     * @brief Confie au socket d'un client les trames en attente, dans la limite de WRITE_WINDOW.
+     */
+    void flushClient(Client &client);
+
+    /**
+     * @brief Lit et décode les trames soumises par un client.
+     */
+    void readClient(Client &client);
+
+    /**
+     * @brief Traite une trame complète soumise par un client.
+     */
+    void processSubmittedFrame(const Client &client);
+
+    /**
+     * @brief Déconnecte un client ; il est retiré de la liste par removeDroppedClients().
+     */
+    void dropClient(Client &client, const QString &reason);
+
+    /**
+     * @brief Retire de la liste les clients déconnectés.
+     */
+    void removeDroppedClients();
+
+    QTcpServer m_server;                           ///< Socket d'écoute.
+    std::vector<std::unique_ptr<Client>> m_clients; ///< Clients connectés.
+};
+
+#endif // KISSTCPSERVER_H
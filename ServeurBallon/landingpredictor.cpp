@@ -0,0 +1,178 @@
+#include "landingpredictor.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file landingpredictor.cpp
+ * @brief Implémentation de la classe LandingPredictor.
+ *
+ * Ce fichier contient l'apprentissage du profil de vent par tranche d'altitude et l'intégration
+ * de la descente restante jusqu'à l'altitude de lancement.
+ */
+
+namespace {
+
+constexpr double METERS_PER_DEG_LAT = 110540.0; ///< Mètres par degré de latitude.
+constexpr double METERS_PER_DEG_LON = 111320.0; ///< Mètres par degré de longitude à l'équateur.
+
+} // namespace
+
+/**
+ * @brief Constructeur de la classe LandingPredictor.
+ *
+ * @param parent Pointeur vers l'objet parent (par défaut nullptr).
+ */
+LandingPredictor::LandingPredictor(QObject *parent)
+    : QObject(parent)
+{ }
+
+/**
+ * @brief Retourne l'indice de la tranche contenant une altitude.
+ *
+ * @param altitude Altitude en mètres.
+ * @return int L'indice de tranche, borné à [0, BAND_COUNT - 1].
+ */
+int LandingPredictor::bandIndex(double altitude)
+{
+    int index = static_cast<int>(std::floor(altitude / BAND_HEIGHT));
+    if (index < 0)
+        index = 0;
+    if (index >= BAND_COUNT)
+        index = BAND_COUNT - 1;
+    return index;
+}
+
+/**
+ * @brief Ajoute une position pour un indicatif.
+ *
+ * Au sol et en montée, l'altitude minimale est retenue comme altitude de lancement et le vent
+ * mesuré entre deux positions est moyenné dans la tranche d'altitude médiane. Après l'éclatement,
+ * la vitesse de descente, ramenée au niveau de la mer, est lissée puis une prédiction est calculée
+ * et émise. Un nouveau vol après un atterrissage repart d'un profil vierge, le lieu d'atterrissage
+ * servant d'altitude de lancement.
+ *
+ * @param callsign Indicatif de la station.
+ * @param timestamp Horodatage (ms).
+ * @param latitude Latitude en degrés.
+ * @param longitude Longitude en degrés.
+ * @param altitude Altitude en mètres.
+ * @param phase Phase de vol courante.
+ */
+void LandingPredictor::addPosition(const QString &callsign, qint64 timestamp, double latitude,
+                                   double longitude, double altitude, FlightPhase phase)
+{
+    Profile &profile = m_profiles[callsign];
+    if (profile.landed && phase != FlightPhase::Landed) {
+        double ground = profile.lastAltitude;
+        profile = Profile();
+        profile.hasGround = true;
+        profile.groundAltitude = ground;
+    }
+    profile.landed = (phase == FlightPhase::Landed);
+    bool falling = (phase == FlightPhase::Burst || phase == FlightPhase::Descent);
+
+    if (!falling && phase != FlightPhase::Landed
+        && (!profile.hasGround || altitude < profile.groundAltitude)) {
+        profile.groundAltitude = altitude;
+        profile.hasGround = true;
+    }
+
+    if (profile.hasLast && timestamp > profile.lastTime) {
+        double dt = (timestamp - profile.lastTime) / 1000.0;
+        if (phase == FlightPhase::Ascent) {
+            double east = (longitude - profile.lastLongitude) * METERS_PER_DEG_LON
+                          * std::cos(profile.lastLatitude * M_PI / 180.0) / dt;
+            double north = (latitude - profile.lastLatitude) * METERS_PER_DEG_LAT / dt;
+            WindBand &band = profile.bands[bandIndex((altitude + profile.lastAltitude) / 2.0)];
+            ++band.count;
+            band.east += (east - band.east) / band.count;
+            band.north += (north - band.north) / band.count;
+        } else if (falling && altitude < profile.lastAltitude) {
+            // Vitesse observée à l'altitude médiane, ramenée au niveau de la mer
+            double middle = (profile.lastAltitude + altitude) / 2.0;
+            double rate = (profile.lastAltitude - altitude) / dt
+                          * std::exp(-middle / (2.0 * SCALE_HEIGHT));
+            profile.descentRate = profile.hasRate
+                                      ? profile.descentRate + RATE_SMOOTHING * (rate - profile.descentRate)
+                                      : rate;
+            profile.hasRate = true;
+        }
+    } else if (profile.hasLast && timestamp <= profile.lastTime) {
+        return;
+    }
+
+    profile.hasLast = true;
+    profile.lastTime = timestamp;
+    profile.lastLatitude = latitude;
+    profile.lastLongitude = longitude;
+    profile.lastAltitude = altitude;
+
+    if (falling && profile.hasRate)
+        emit predictionUpdated(predict(callsign, profile));
+}
+
+/**
+ * @brief Intègre la descente restante depuis la dernière position du profil.
+ *
+ * La vitesse de descente varie comme l'inverse de la racine de la densité de l'air : la vitesse
+ * équivalente au niveau de la mer est extrapolée à l'altitude médiane de chaque tranche. Les tranches
+ * sans mesure de vent reprennent le vent de la dernière tranche connue traversée.
+ *
+ * @param callsign Indicatif de la station.
+ * @param profile Profil de la station.
+ * @return LandingPrediction Le point et l'heure d'atterrissage estimés.
+ */
+LandingPrediction LandingPredictor::predict(const QString &callsign, const Profile &profile) const
+{
+    double currentAltitude = profile.lastAltitude;
+    double ground = profile.hasGround ? profile.groundAltitude : 0.0;
+
+    // Vent par défaut : la tranche connue la plus proche au-dessus de l'altitude courante
+    double windEast = 0.0;
+    double windNorth = 0.0;
+    for (int i = bandIndex(currentAltitude); i < BAND_COUNT; ++i) {
+        if (profile.bands[i].count > 0) {
+            windEast = profile.bands[i].east;
+            windNorth = profile.bands[i].north;
+            break;
+        }
+    }
+
+    double h = currentAltitude;
+    double seconds = 0.0;
+    double driftEast = 0.0;
+    double driftNorth = 0.0;
+    while (h > ground) {
+        int index = bandIndex(h);
+        double bottom = index * BAND_HEIGHT;
+        if (bottom >= h)
+            bottom -= BAND_HEIGHT;
+        if (bottom < ground)
+            bottom = ground;
+
+        const WindBand &band = profile.bands[bandIndex((h + bottom) / 2.0)];
+        if (band.count > 0) {
+            windEast = band.east;
+            windNorth = band.north;
+        }
+
+        double v = profile.descentRate * std::exp((h + bottom) / (4.0 * SCALE_HEIGHT));
+        double dt = (h - bottom) / std::max(v, MIN_DESCENT_RATE);
+        driftEast += windEast * dt;
+        driftNorth += windNorth * dt;
+        seconds += dt;
+        h = bottom;
+    }
+
+    LandingPrediction prediction;
+    prediction.callsign = callsign;
+    prediction.timestamp = profile.lastTime;
+    prediction.latitude = profile.lastLatitude + driftNorth / METERS_PER_DEG_LAT;
+    prediction.longitude = profile.lastLongitude
+                           + driftEast / (METERS_PER_DEG_LON * std::cos(profile.lastLatitude * M_PI / 180.0));
+    prediction.landingTime = profile.lastTime + static_cast<qint64>(seconds * 1000.0);
+    prediction.altitude = currentAltitude;
+    prediction.descentRate = profile.descentRate * std::exp(currentAltitude / (2.0 * SCALE_HEIGHT));
+    return prediction;
+}
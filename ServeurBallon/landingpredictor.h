@@ -0,0 +1,124 @@
+#ifndef LANDINGPREDICTOR_H
+#define LANDINGPREDICTOR_H
+
+/**
+ * @file landingpredictor.h
+ * @brief Déclaration de la classe LandingPredictor.
+ *
+ * Ce fichier définit le prédicteur incrémental du point d'atterrissage. Le profil de vent est
+ * appris tranche d'altitude par tranche d'altitude pendant la montée ; pendant la descente,
+ * chaque position déclenche une nouvelle intégration de la seule descente restante.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QMetaType>
+#include <QHash>
+#include <QString>
+
+#include "flightstateengine.h"
+
+/**
+ * @brief Point d'atterrissage estimé.
+ */
+struct LandingPrediction {
+    QString callsign;       ///< Indicatif de la station.
+    qint64 timestamp;       ///< Horodatage de la position ayant servi au calcul (ms).
+    double latitude;        ///< Latitude estimée du point d'atterrissage (degrés).
+    double longitude;       ///< Longitude estimée du point d'atterrissage (degrés).
+    qint64 landingTime;     ///< Heure estimée de l'atterrissage (ms depuis l'époque Unix).
+    double altitude;        ///< Altitude de la position courante (m).
+    double descentRate;     ///< Vitesse de descente observée (m/s, positive).
+};
+
+Q_DECLARE_METATYPE(LandingPrediction)
+
+/**
+ * @brief Prédicteur incrémental du point d'atterrissage.
+ *
+ * Pendant la montée, le vent horizontal mesuré entre deux positions successives est moyenné
+ * dans la tranche d'altitude correspondante. Pendant la descente, la vitesse de descente observée
+ * est extrapolée aux altitudes inférieures selon la densité de l'air, puis la dérive est intégrée
+ * tranche par tranche jusqu'à l'altitude de lancement. Le coût d'une mise à jour est borné par
+ * le nombre de tranches (quelques microsecondes).
+ */
+class LandingPredictor : public QObject {
+    Q_OBJECT
+public:
+    static constexpr double BAND_HEIGHT       = 500.0;  ///< Épaisseur d'une tranche d'altitude (m).
+    static constexpr int    BAND_COUNT        = 90;     ///< Nombre de tranches (jusqu'à 45 km).
+    static constexpr double SCALE_HEIGHT      = 7238.0; ///< Hauteur d'échelle de la densité de l'air (m).
+    static constexpr double MIN_DESCENT_RATE  = 1.0;    ///< Vitesse de descente minimale retenue (m/s).
+    static constexpr double RATE_SMOOTHING    = 0.5;    ///< Coefficient de lissage de la vitesse de descente.
+
+    /**
+     * @brief Constructeur de la classe LandingPredictor.
+     * @param parent Pointeur vers l'objet parent (par défaut nullptr).
+     */
+    explicit LandingPredictor(QObject *parent = nullptr);
+
+    /**
+     * @brief Ajoute une position pour un indicatif.
+     *
+     * En montée, la position enrichit le profil de vent ; en descente (après éclatement),
+     * elle déclenche une nouvelle prédiction émise via le signal predictionUpdated.
+     *
+     * @param callsign Indicatif de la station.
+     * @param timestamp Horodatage (ms depuis l'époque Unix).
+     * @param latitude Latitude en degrés.
+     * @param longitude Longitude en degrés.
+     * @param altitude Altitude en mètres.
+     * @param phase Phase de vol courante de la station.
+     */
+    void addPosition(const QString &callsign, qint64 timestamp, double latitude,
+                     double longitude, double altitude, FlightPhase phase);
+
+signals:
+    /**
+     * @brief Signal émis à chaque nouvelle prédiction du point d'atterrissage.
+     * @param prediction La prédiction calculée.
+     */
+    void predictionUpdated(const LandingPrediction &prediction);
+
+private:
+    /**
+     * @brief Vent moyen appris dans une tranche d'altitude.
+     */
+    struct WindBand {
+        double east = 0.0;  ///< Composante est (m/s).
+        double north = 0.0; ///< Composante nord (m/s).
+        int count = 0;      ///< Nombre de mesures intégrées.
+    };
+
+    /**
+     * @brief Profil de vol conservé pour chaque indicatif.
+     */
+    struct Profile {
+        WindBand bands[BAND_COUNT];
+        bool   hasLast = false;
+        qint64 lastTime = 0;
+        double lastLatitude = 0.0;
+        double lastLongitude = 0.0;
+        double lastAltitude = 0.0;
+        bool   hasGround = false;
+        double groundAltitude = 0.0;
+        bool   hasRate = false;
+        double descentRate = 0.0;   ///< Vitesse de descente équivalente au niveau de la mer (m/s).
+        bool   landed = false;      ///< Dernière position reçue après l'atterrissage.
+    };
+
+    /**
+     * @brief Retourne l'indice de la tranche contenant une altitude.
+     */
+    static int bandIndex(double altitude);
+
+    /**
+     * @brief Intègre la descente restante depuis la dernière position du profil.
+     */
+    LandingPrediction predict(const QString &callsign, const Profile &profile) const;
+
+    QHash<QString, Profile> m_profiles; ///< Profil de vent et de descente par indicatif.
+};
+
+#endif // LANDINGPREDICTOR_H
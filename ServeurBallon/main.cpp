@@ -1,11 +1,25 @@
 #include "interface.h"
+#include "configuration.h"
+#include "frame.h"
+#include "databasewriter.h"
+#include "tracer.h"
 
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
-    Interface w;
+    qRegisterMetaType<FramePtr>("FramePtr");
+    qRegisterMetaType<FlightEvent>("FlightEvent");
+    qRegisterMetaType<LandingPrediction>("LandingPrediction");
+    qRegisterMetaType<DatabaseState>("DatabaseState");
+    Configuration config = Configuration::fromArguments(a.arguments());
+    Frame::setBalloonCallsigns(config.balloonCallsigns);
+    if (!config.tracePath.isEmpty()) {
+        Tracer::enable();
+        Tracer::setThreadName("interface");
+    }
+    Interface w(config);
     w.show();
     return a.exec();
 }
@@ -1,5 +1,11 @@
 #include "mysqlmanager.h"
+#include "frame.h"
+#include "framedecoding.h"
+#include "flightstateengine.h"
+#include "landingpredictor.h"
+#include "stationstate.h"
 #include <QDebug>
+#include <QDateTime>
 
 /**
  * @file MySQLManager.cpp
@@ -20,11 +26,13 @@ MySQLManager::MySQLManager(QObject *parent)
     : QObject(parent)
 {
     // Configuration de la connexion MySQL
-    m_db = QSqlDatabase::addDatabase("QMYSQL");
+    m_db = QSqlDatabase::addDatabase("QMYSQL", "mysql");
     m_db.setHostName("195.221.60.234");
     m_db.setDatabaseName("Ballon2025");
     m_db.setUserName("ciel1_estanislawski");
     m_db.setPassword("P6wL9sF4");
+    // Borne le temps de connexion lorsque le serveur est injoignable
+    m_db.setConnectOptions("MYSQL_OPT_CONNECT_TIMEOUT=5");
 }
 
 /**
@@ -37,6 +45,16 @@ MySQLManager::~MySQLManager()
     closeConnection();
 }
 
+/**
+ * @brief Retourne le nom du support.
+ *
+ * @return QString "MySQL".
+ */
+QString MySQLManager::name() const
+{
+    return QStringLiteral("MySQL");
+}
+
 /**
  * @brief Ouvre la connexion à la base de données.
  *
@@ -61,10 +79,61 @@ bool MySQLManager::openConnection()
  */
 void MySQLManager::closeConnection()
 {
+    m_insertFrameQuery = QSqlQuery();
+    m_insertDecodingQuery = QSqlQuery();
+    m_insertEventQuery = QSqlQuery();
+    m_insertPredictionQuery = QSqlQuery();
+    m_insertsPrepared = false;
+    m_knownMachines.clear();
     if (m_db.isOpen())
         m_db.close();
 }
 
+/**
+ * @brief Vérifie que le serveur répond encore.
+ *
+ * @return bool @c true si la connexion est ouverte et que le serveur a répondu, @c false sinon.
+ */
+bool MySQLManager::ping()
+{
+    if (!m_db.isOpen())
+        return false;
+    QSqlQuery query(m_db);
+    return query.exec("SELECT 1");
+}
+
+/**
+ * @brief Ouvre une transaction regroupant les écritures suivantes.
+ *
+ * @return bool @c true si la transaction est ouverte, @c false sinon.
+ */
+bool MySQLManager::beginBatch()
+{
+    return m_db.transaction();
+}
+
+/**
+ * @brief Valide la transaction en cours.
+ *
+ * @return bool @c true si la transaction est validée, @c false sinon.
+ */
+bool MySQLManager::commitBatch()
+{
+    return m_db.commit();
+}
+
+/**
+ * @brief Annule la transaction en cours.
+ *
+ * Les machines insérées pendant la transaction sont annulées avec elle : le cache des machines
+ * connues est vidé.
+ */
+void MySQLManager::rollbackBatch()
+{
+    m_db.rollback();
+    m_knownMachines.clear();
+}
+
 /**
  * @brief Exécute une requête SQL de lecture.
  *
@@ -131,6 +200,201 @@ bool MySQLManager::insertMachine(const QString &indicatif, const QString &descri
     return success;
 }
 
+/**
+ * @brief Vérifie qu'une machine existe, en l'insérant si nécessaire.
+ *
+ * Le résultat positif est mémorisé : un indicatif déjà vérifié ne coûte plus aucune requête.
+ *
+ * @param id L'identifiant de l'indicatif.
+ * @return bool @c true si la machine existe ou a été insérée, @c false sinon.
+ */
+bool MySQLManager::ensureMachine(CallsignId id)
+{
+    if (m_knownMachines.contains(id))
+        return true;
+
+    QString indicatif = CallsignTable::name(id);
+    if (!machineExists(indicatif) && !insertMachine(indicatif, "Machine ajoutée automatiquement"))
+        return false;
+    m_knownMachines.insert(id);
+    return true;
+}
+
+/**
+ * @brief Prépare les requêtes d'insertion, une seule fois par connexion.
+ *
+ * Les événements et prédictions déjà présents sont ignorés, comme les trames : une validation dont
+ * le résultat est incertain est rejouée sans que ses lignes soient refusées.
+ *
+ * @return bool @c true si les requêtes sont prêtes, @c false sinon.
+ */
+bool MySQLManager::prepareInserts()
+{
+    if (m_insertsPrepared)
+        return true;
+    m_insertFrameQuery = QSqlQuery(m_db);
+    if (!m_insertFrameQuery.prepare("INSERT IGNORE INTO trames (source, destination, trame, message, date_reception) VALUES (?, ?, ?, ?, ?)")) {
+        qDebug() << "Erreur insertFrame:" << m_insertFrameQuery.lastError().text();
+        return false;
+    }
+    m_insertDecodingQuery = QSqlQuery(m_db);
+    if (!m_insertDecodingQuery.prepare(FrameDecoding::insertStatement(m_db.driverName(), 1))) {
+        qDebug() << "Erreur insertFrame (decodages):" << m_insertDecodingQuery.lastError().text();
+        return false;
+    }
+    m_insertEventQuery = QSqlQuery(m_db);
+    if (!m_insertEventQuery.prepare("INSERT IGNORE INTO evenements (indicatif, type, date_evenement, altitude, latitude, longitude, vitesse_verticale) "
+                                    "VALUES (?, ?, ?, ?, ?, ?, ?)")) {
+        qDebug() << "Erreur insertFlightEvent:" << m_insertEventQuery.lastError().text();
+        return false;
+    }
+    m_insertPredictionQuery = QSqlQuery(m_db);
+    if (!m_insertPredictionQuery.prepare("INSERT IGNORE INTO predictions (indicatif, date_calcul, latitude, longitude, date_atterrissage, altitude, vitesse_descente) "
+                                         "VALUES (?, ?, ?, ?, ?, ?, ?)")) {
+        qDebug() << "Erreur insertLandingPrediction:" << m_insertPredictionQuery.lastError().text();
+        return false;
+    }
+    m_insertsPrepared = true;
+    return true;
+}
+
+/**
+ * @brief Insère une trame reçue dans la base de données.
+ *
+ * Vérifie les machines source et destination puis exécute la requête d'insertion préparée
+ * lors du premier appel. Une trame déjà présente (même texte) est ignorée, comme avec SQLite, ce qui
+ * permet de réimporter sans doublon des journaux recouvrant la réception en direct. Si la trame a
+ * été reconnue, son décodage APRS est enregistré dans la table decodages. La date de réception est
+ * celle de la trame (et non celle de l'écriture, qui peut être différée). La clé est le texte TNC2
+ * tronqué à la longueur de la colonne (FrameDecoding::key()), liée à l'identique dans decodages.
+ *
+ * @param frame La trame à enregistrer.
+ * @return bool @c true si la trame a été insérée (même si son décodage a été refusé), @c false sinon.
+ */
+bool MySQLManager::insertFrame(const Frame &frame)
+{
+    if (!ensureMachine(frame.source()) || !ensureMachine(frame.destination()))
+        return false;
+
+    if (!prepareInserts())
+        return false;
+
+    m_insertFrameQuery.bindValue(0, frame.sourceName());
+    m_insertFrameQuery.bindValue(1, frame.destinationName());
+    m_insertFrameQuery.bindValue(2, FrameDecoding::key(frame, m_db.driverName()));
+    m_insertFrameQuery.bindValue(3, Frame::toString(frame.message()));
+    m_insertFrameQuery.bindValue(4, QDateTime::fromMSecsSinceEpoch(frame.timestamp()));
+    if (!m_insertFrameQuery.exec()) {
+        qDebug() << "Erreur insertFrame:" << m_insertFrameQuery.lastError().text();
+        return false;
+    }
+    // Un décodage refusé ne coûte pas la trame : redecodage pourra le réécrire
+    if (FrameDecoding::isDecoded(frame)) {
+        FrameDecoding::bindValues(m_insertDecodingQuery, 0, frame, m_db.driverName());
+        if (!m_insertDecodingQuery.exec())
+            qDebug() << "Erreur insertFrame (decodages):" << m_insertDecodingQuery.lastError().text();
+    }
+    return true;
+}
+
+/**
+ * @brief Insère un événement de vol dans la base de données.
+ *
+ * Exécute la requête d'insertion préparée lors du premier appel dans la table evenements avec le
+ * type, l'horodatage, l'altitude, la dernière position connue et la vitesse verticale. Un événement
+ * déjà présent (même indicatif, type et date) est ignoré, comme avec SQLite.
+ *
+ * @param event L'événement de vol à enregistrer.
+ * @return bool @c true si l'insertion a réussi, @c false sinon.
+ */
+bool MySQLManager::insertFlightEvent(const FlightEvent &event)
+{
+    if (!prepareInserts())
+        return false;
+
+    m_insertEventQuery.bindValue(0, event.callsign);
+    m_insertEventQuery.bindValue(1, FlightStateEngine::eventName(event.type));
+    m_insertEventQuery.bindValue(2, QDateTime::fromMSecsSinceEpoch(event.timestamp));
+    m_insertEventQuery.bindValue(3, event.altitude);
+    m_insertEventQuery.bindValue(4, event.latitude);
+    m_insertEventQuery.bindValue(5, event.longitude);
+    m_insertEventQuery.bindValue(6, event.verticalRate);
+    if (!m_insertEventQuery.exec()) {
+        qDebug() << "Erreur insertFlightEvent:" << m_insertEventQuery.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Insère une prédiction du point d'atterrissage dans la base de données.
+ *
+ * Exécute la requête d'insertion préparée lors du premier appel dans la table predictions avec le
+ * point et l'heure d'atterrissage estimés, l'altitude courante et la vitesse de descente observée.
+ * Une prédiction déjà présente (même indicatif et date de calcul) est ignorée, comme avec SQLite.
+ *
+ * @param prediction La prédiction à enregistrer.
+ * @return bool @c true si l'insertion a réussi, @c false sinon.
+ */
+bool MySQLManager::insertLandingPrediction(const LandingPrediction &prediction)
+{
+    if (!prepareInserts())
+        return false;
+
+    m_insertPredictionQuery.bindValue(0, prediction.callsign);
+    m_insertPredictionQuery.bindValue(1, QDateTime::fromMSecsSinceEpoch(prediction.timestamp));
+    m_insertPredictionQuery.bindValue(2, prediction.latitude);
+    m_insertPredictionQuery.bindValue(3, prediction.longitude);
+    m_insertPredictionQuery.bindValue(4, QDateTime::fromMSecsSinceEpoch(prediction.landingTime));
+    m_insertPredictionQuery.bindValue(5, prediction.altitude);
+    m_insertPredictionQuery.bindValue(6, prediction.descentRate);
+    if (!m_insertPredictionQuery.exec()) {
+        qDebug() << "Erreur insertLandingPrediction:" << m_insertPredictionQuery.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Insère ou remplace le dernier état connu d'une station.
+ *
+ * La ligne de la station est entièrement réécrite (ON DUPLICATE KEY UPDATE).
+ *
+ * @param state L'état à enregistrer.
+ * @return bool @c true si l'écriture a réussi, @c false sinon.
+ */
+bool MySQLManager::upsertStationState(const StationState &state)
+{
+    bool success = true;
+    QSqlQuery query(m_db);
+    query.prepare(StationState::upsertStatement(m_db.driverName()));
+    state.bindValues(query);
+    if (!query.exec()) {
+        qDebug() << "Erreur upsertStationState:" << query.lastError().text();
+        success = false;
+    }
+    return success;
+}
+
+/**
+ * @brief Relit les derniers états connus de toutes les stations.
+ *
+ * @param states Les états lus.
+ * @return bool @c true si la lecture a réussi, @c false sinon.
+ */
+bool MySQLManager::loadStationStates(QVector<StationState> &states)
+{
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    if (!query.exec(StationState::selectStatement())) {
+        qDebug() << "Erreur loadStationStates:" << query.lastError().text();
+        return false;
+    }
+    while (query.next())
+        states.append(StationState::fromQuery(query));
+    return true;
+}
+
 /**
  * @brief Exécute une requête SQL de modification.
  *
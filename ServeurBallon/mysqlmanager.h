@@ -14,15 +14,19 @@
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QSet>
+
+#include "callsigntable.h"
+#include "storagebackend.h"
 
 /**
  * @brief Gestionnaire de connexion et d'opérations MySQL.
  *
  * La classe MySQLManager permet d'ouvrir et de fermer la connexion à une base de données MySQL,
  * d'exécuter des requêtes SQL (lecture et modification) et de réaliser des opérations spécifiques
- * liées à la gestion des machines dans la base de données.
+ * liées à la gestion des machines dans la base de données. Elle implémente l'interface StorageBackend.
  */
-class MySQLManager : public QObject {
+class MySQLManager : public QObject, public StorageBackend {
     Q_OBJECT
 public:
     /**
@@ -36,7 +40,12 @@ public:
      *
      * Ferme la connexion à la base de données si elle est ouverte.
      */
-    ~MySQLManager();
+    ~MySQLManager() override;
+
+    /**
+     * @brief Retourne le nom du support ("MySQL").
+     */
+    QString name() const override;
 
     /**
      * @brief Ouvre la connexion à la base de données.
@@ -45,14 +54,41 @@ public:
      *
      * @return bool @c true si la connexion est établie avec succès, @c false sinon.
      */
-    bool openConnection();
+    bool openConnection() override;
 
     /**
      * @brief Ferme la connexion à la base de données.
      *
      * Ferme la connexion MySQL si celle-ci est actuellement ouverte.
      */
-    void closeConnection();
+    void closeConnection() override;
+
+    /**
+     * @brief Vérifie que le serveur répond encore.
+     *
+     * Exécute une requête triviale ; utilisé après un échec d'écriture pour distinguer
+     * une donnée refusée d'une connexion perdue.
+     *
+     * @return bool @c true si le serveur a répondu, @c false sinon.
+     */
+    bool ping() override;
+
+    /**
+     * @brief Ouvre une transaction regroupant les écritures suivantes.
+     * @return bool @c true si la transaction est ouverte, @c false sinon.
+     */
+    bool beginBatch() override;
+
+    /**
+     * @brief Valide la transaction en cours.
+     * @return bool @c true si la transaction est validée, @c false sinon.
+     */
+    bool commitBatch() override;
+
+    /**
+     * @brief Annule la transaction en cours.
+     */
+    void rollbackBatch() override;
 
     /**
      * @brief Exécute une requête SQL et retourne le résultat.
@@ -96,6 +132,51 @@ public:
      */
     bool insertMachine(const QString &indicatif, const QString &description = "");
 
+    /**
+     * @brief Insère une trame reçue dans la base de données.
+     *
+     * Les machines source et destination sont ajoutées si nécessaire ; les indicatifs déjà
+     * vérifiés sont mémorisés par identifiant pour éviter de nouvelles requêtes.
+     *
+     * @param frame La trame à enregistrer dans la table trames.
+     * @return bool @c true si l'insertion a réussi, @c false sinon.
+     */
+    bool insertFrame(const Frame &frame) override;
+
+    /**
+     * @brief Insère un événement de vol dans la base de données.
+     *
+     * Enregistre l'événement (montée, éclatement, descente, atterrissage) dans la table evenements.
+     *
+     * @param event L'événement de vol à enregistrer.
+     * @return bool @c true si l'insertion a réussi, @c false sinon.
+     */
+    bool insertFlightEvent(const FlightEvent &event) override;
+
+    /**
+     * @brief Insère une prédiction du point d'atterrissage dans la base de données.
+     *
+     * @param prediction La prédiction à enregistrer dans la table predictions.
+     * @return bool @c true si l'insertion a réussi, @c false sinon.
+     */
+    bool insertLandingPrediction(const LandingPrediction &prediction) override;
+
+    /**
+     * @brief Insère ou remplace le dernier état connu d'une station.
+     *
+     * @param state L'état à enregistrer dans la table station_state.
+     * @return bool @c true si l'écriture a réussi, @c false sinon.
+     */
+    bool upsertStationState(const StationState &state) override;
+
+    /**
+     * @brief Relit les derniers états connus de toutes les stations (table station_state).
+     *
+     * @param states Les états lus.
+     * @return bool @c true si la lecture a réussi, @c false sinon.
+     */
+    bool loadStationStates(QVector<StationState> &states) override;
+
     /**
      * @brief Retourne l'objet QSqlDatabase utilisé par le gestionnaire.
      *
@@ -106,7 +187,28 @@ public:
     QSqlDatabase database() const;
 
 private:
-    QSqlDatabase m_db; ///< Objet QSqlDatabase gérant la connexion à la base de données.
+    /**
+     * @brief Vérifie qu'une machine existe, en l'insérant si nécessaire.
+     *
+     * @param id L'identifiant de l'indicatif.
+     * @return bool @c true si la machine existe ou a été insérée, @c false sinon.
+     */
+    bool ensureMachine(CallsignId id);
+
+    /**
+     * @brief Prépare les requêtes d'insertion, une seule fois par connexion.
+     *
+     * @return bool @c true si les requêtes sont prêtes, @c false sinon.
+     */
+    bool prepareInserts();
+
+    QSqlDatabase m_db;                ///< Objet QSqlDatabase gérant la connexion à la base de données.
+    QSet<CallsignId> m_knownMachines; ///< Indicatifs dont la présence dans la table machines est vérifiée.
+    QSqlQuery m_insertFrameQuery;     ///< Requête d'insertion de trame, préparée une seule fois.
+    QSqlQuery m_insertDecodingQuery;  ///< Requête d'insertion du décodage d'une trame.
+    QSqlQuery m_insertEventQuery;     ///< Requête d'insertion d'un événement de vol.
+    QSqlQuery m_insertPredictionQuery; ///< Requête d'insertion d'une prédiction d'atterrissage.
+    bool m_insertsPrepared = false;   ///< Indique si les requêtes d'insertion sont préparées.
 };
 
 #endif // MYSQLMANAGER_H
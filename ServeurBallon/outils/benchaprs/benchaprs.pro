@@ -0,0 +1,13 @@
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+# Banc d'essai de l'analyseur APRS (sans dépendance Qt)
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    ../../aprsparser.cpp
+
+HEADERS += \
+    ../../aprsparser.h
@@ -0,0 +1,68 @@
+/**
+ * @file main.cpp
+ * @brief Banc d'essai de débit de l'analyseur APRS.
+ *
+ * Analyse en boucle un corpus de trames TNC2 représentatif du trafic reçu (positions
+ * non compressées, compressées, Mic-E, télémétrie, messages, statut) et affiche le débit
+ * obtenu en trames par seconde et en Mo/s.
+ *
+ * Usage : benchaprs [iterations]
+ */
+
+#include "aprsparser.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static const char *const CORPUS[] = {
+    "F4KMN-8>APLT00,WIDE1-1:!4542.16N/00451.24E_180/010g015t078h31b10148/A=012345",
+    "F4KMN-8>APLT00,WIDE1-1:/092345z4903.50N/07201.75W>088/036/A=001234 Ballon 2025",
+    "F4LTZ-9>APRS:!/5L!!<*e7>7P[ Tracker compresse",
+    "F4LTZ-9>APRS,WIDE2-1:=/5L!!<*e7OS]S Altitude GGA",
+    "F4KMN-7>T2SP0W,WIDE1-1:`(_fn\"Oj/]\"4-}Mic-E tracker",
+    "F4KMN-8>APLT00:T#005,199,000,255,073,123,01101001",
+    "F4LTZ>APIN21,WIDE1-1::F4KMN-8  :QSA?{42",
+    "F4KMN-8>APIN21::F4LTZ    :ack42",
+    "F4KMN-8>APLT00:>092345zNacelle operationnelle",
+    "F4KMN-8>APLT00:_10090556c220s004g005t077r000p000P000h50b09900",
+};
+
+int main(int argc, char *argv[])
+{
+    long iterations = (argc > 1) ? std::atol(argv[1]) : 1000000;
+    if (iterations <= 0)
+        iterations = 1000000;
+
+    std::vector<std::string> corpus(std::begin(CORPUS), std::end(CORPUS));
+    std::size_t bytesPerRound = 0;
+    for (const std::string &line : corpus)
+        bytesPerRound += line.size();
+
+    // Vérification préalable : chaque trame du corpus doit être décodée
+    APRSPacket packet;
+    for (const std::string &line : corpus) {
+        bool ok = APRSParser::parseTNC2(line, packet);
+        std::printf("%-10s %-9s %s\n", ok ? "OK" : "ECHEC",
+                    APRSParser::typeName(packet.type), line.c_str());
+    }
+
+    long decoded = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        for (const std::string &line : corpus)
+            decoded += APRSParser::parseTNC2(line, packet) ? 1 : 0;
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    double frames = static_cast<double>(iterations) * corpus.size();
+    std::printf("\n%.0f trames analysees (%ld decodees) en %.3f s\n", frames, decoded, seconds);
+    std::printf("Debit : %.2f Mtrames/s, %.1f Mo/s, %.1f ns/trame\n",
+                frames / seconds / 1e6,
+                static_cast<double>(iterations) * bytesPerRound / seconds / 1e6,
+                seconds * 1e9 / frames);
+    return EXIT_SUCCESS;
+}
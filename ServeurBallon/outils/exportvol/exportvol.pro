@@ -0,0 +1,31 @@
+TEMPLATE = app
+QT = core sql
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+# Export en flux d'un vol depuis la base MySQL ou SQLite (curseur en avant seulement)
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    ../../aprsparser.cpp \
+    ../../ax25converter.cpp \
+    ../../callsigntable.cpp \
+    ../../flightstateengine.cpp \
+    ../../frame.cpp \
+    ../../framedecoding.cpp \
+    ../../landingpredictor.cpp \
+    ../../mysqlmanager.cpp \
+    ../../stationstate.cpp
+
+HEADERS += \
+    ../../aprsparser.h \
+    ../../ax25converter.h \
+    ../../callsigntable.h \
+    ../../flightstateengine.h \
+    ../../frame.h \
+    ../../framedecoding.h \
+    ../../landingpredictor.h \
+    ../../mysqlmanager.h \
+    ../../stationstate.h \
+    ../../storagebackend.h
@@ -0,0 +1,580 @@
+/**
+ * @file main.cpp
+ * @brief Export en flux d'un vol (trames, positions, télémétrie) vers CSV, NDJSON ou GPX.
+ *
+ * Les trames d'une fenêtre temporelle sont lues avec un curseur en avant seulement
+ * (QSqlQuery::setForwardOnly) : avec MySQL, le résultat n'est pas rapatrié en bloc mais lu ligne
+ * à ligne au fil de l'écriture (mysql_use_result). La requête MySQL n'est pas préparée, le pilote
+ * rapatriant toujours le résultat complet d'une requête préparée (mysql_stmt_store_result) ; ses
+ * valeurs sont mises en forme et échappées par le pilote (QSqlDriver::formatValue). Chaque trame est
+ * décodée par l'analyseur APRS du serveur puis écrite immédiatement dans un tampon de sortie de
+ * taille fixe : la mémoire utilisée ne dépend pas de la taille du vol.
+ *
+ * Le débit (lignes/s) est affiché chaque seconde sur la sortie d'erreur, puis en fin d'export.
+ *
+ * Exemple :
+ *   ./exportvol --sqlite Ballon2025.sqlite --from 2025-05-14T08:00 --to 2025-05-14T12:00 \
+ *               --source F4KMN-11 --kind positions --format gpx --output vol.gpx
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QSqlDatabase>
+#include <QSqlDriver>
+#include <QSqlError>
+#include <QSqlField>
+#include <QSqlQuery>
+#include <QVariant>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+#include "aprsparser.h"
+#include "frame.h"
+#include "mysqlmanager.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t OUTPUT_BUFFER_SIZE = 1 << 20;   ///< Tampon de la sortie (octets).
+
+/**
+ * @brief Données à exporter.
+ */
+enum class Kind {
+    Frames,     ///< Toutes les trames, avec leur type APRS.
+    Positions,  ///< Positions décodées (positions et Mic-E).
+    Telemetry   ///< Télémétrie "T#" et mesures météo.
+};
+
+/**
+ * @brief Format de sortie.
+ */
+enum class Format {
+    Csv,
+    NdJson,
+    Gpx
+};
+
+/**
+ * @brief Paramètres de l'export.
+ */
+struct Options {
+    QString sqlitePath;             ///< Base SQLite à lire (sinon la base MySQL).
+    QDateTime from;                 ///< Début de la fenêtre (inclus, invalide : pas de borne).
+    QDateTime to;                   ///< Fin de la fenêtre (exclue, invalide : pas de borne).
+    QString source;                 ///< Indicatif source (vide : tous).
+    Kind kind = Kind::Frames;       ///< Données à exporter.
+    Format format = Format::Csv;    ///< Format de sortie.
+    QString output;                 ///< Fichier de sortie (vide : sortie standard).
+};
+
+/**
+ * @brief Ligne de résultat courante, décodée.
+ */
+struct Row {
+    QByteArray date;                ///< Date de réception (ISO 8601, UTC).
+    QByteArray source;              ///< Indicatif source.
+    QByteArray destination;         ///< Indicatif destination.
+    QByteArray tnc2;                ///< Trame TNC2 (les vues du paquet pointent dedans).
+    QByteArray message;             ///< Message associé.
+    APRSPacket packet;              ///< Paquet décodé.
+    bool decoded = false;           ///< Indique si la trame a été reconnue.
+};
+
+/**
+ * @brief Sortie tamponnée et fonctions d'échappement propres à chaque format.
+ */
+class Output {
+public:
+    explicit Output(std::FILE *file)
+        : m_file(file),
+        m_buffer(new char[OUTPUT_BUFFER_SIZE])
+    {
+        std::setvbuf(m_file, m_buffer.get(), _IOFBF, OUTPUT_BUFFER_SIZE);
+    }
+
+    void raw(std::string_view text) { std::fwrite(text.data(), 1, text.size(), m_file); }
+    void put(char c) { std::fputc(c, m_file); }
+
+    /**
+     * @brief Écrit un nombre (ou rien si la valeur est absente).
+     */
+    void number(double value, bool present = true, int decimals = 6)
+    {
+        if (present)
+            std::fprintf(m_file, "%.*f", decimals, value);
+    }
+
+    /**
+     * @brief Écrit un champ CSV, entre guillemets s'il contient un séparateur.
+     */
+    void csv(std::string_view text)
+    {
+        if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+            raw(text);
+            return;
+        }
+        put('"');
+        for (char c : text) {
+            if (c == '"')
+                put('"');
+            put(c);
+        }
+        put('"');
+    }
+
+    /**
+     * @brief Écrit une chaîne JSON entre guillemets.
+     */
+    void json(std::string_view text)
+    {
+        put('"');
+        for (char c : text) {
+            switch (c) {
+            case '"':  raw("\\\""); break;
+            case '\\': raw("\\\\"); break;
+            case '\n': raw("\\n"); break;
+            case '\r': raw("\\r"); break;
+            case '\t': raw("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                    std::fprintf(m_file, "\\u%04x", static_cast<unsigned char>(c));
+                else
+                    put(c);
+            }
+        }
+        put('"');
+    }
+
+    /**
+     * @brief Écrit un texte échappé pour XML.
+     */
+    void xml(std::string_view text)
+    {
+        for (char c : text) {
+            switch (c) {
+            case '<': raw("&lt;"); break;
+            case '>': raw("&gt;"); break;
+            case '&': raw("&amp;"); break;
+            case '"': raw("&quot;"); break;
+            default:  put(c);
+            }
+        }
+    }
+
+    bool close() { return std::fflush(m_file) == 0 && !std::ferror(m_file); }
+
+private:
+    std::FILE *m_file;
+    std::unique_ptr<char[]> m_buffer;
+};
+
+std::string_view view(const QByteArray &bytes)
+{
+    return std::string_view(bytes.constData(), static_cast<std::size_t>(bytes.size()));
+}
+
+bool hasPosition(const Row &row)
+{
+    return row.decoded && (row.packet.type == APRSPacketType::Position || row.packet.type == APRSPacketType::MicE);
+}
+
+bool hasTelemetry(const Row &row)
+{
+    const APRSWeather &w = row.packet.weather;
+    return row.decoded && (row.packet.type == APRSPacketType::Telemetry || row.packet.telemetry.compressed
+                           || w.hasTemperature || w.hasPressure || w.hasHumidity);
+}
+
+/**
+ * @brief Écrit l'en-tête du fichier (ligne de titres CSV, prologue GPX).
+ */
+void writeHeader(Output &out, const Options &options)
+{
+    if (options.format == Format::Gpx) {
+        out.raw("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                "<gpx version=\"1.1\" creator=\"exportvol\" xmlns=\"http://www.topografix.com/GPX/1/1\">\n");
+        return;
+    }
+    if (options.format != Format::Csv)
+        return;
+    switch (options.kind) {
+    case Kind::Frames:
+        out.raw("date,source,destination,type,trame,message\n");
+        break;
+    case Kind::Positions:
+        out.raw("date,source,latitude,longitude,altitude,vitesse,cap\n");
+        break;
+    case Kind::Telemetry:
+        out.raw("date,source,sequence,a1,a2,a3,a4,a5,bits,temperature,pression,humidite\n");
+        break;
+    }
+}
+
+/**
+ * @brief Écrit la fin du fichier (clôture de la trace GPX).
+ */
+void writeFooter(Output &out, const Options &options, bool trackOpen)
+{
+    if (options.format != Format::Gpx)
+        return;
+    if (trackOpen)
+        out.raw("</trkseg></trk>\n");
+    out.raw("</gpx>\n");
+}
+
+void writeFrame(Output &out, const Options &options, const Row &row)
+{
+    const char *type = APRSParser::typeName(row.decoded ? row.packet.type : APRSPacketType::Unknown);
+    if (options.format == Format::Csv) {
+        out.csv(view(row.date)); out.put(',');
+        out.csv(view(row.source)); out.put(',');
+        out.csv(view(row.destination)); out.put(',');
+        out.csv(type); out.put(',');
+        out.csv(view(row.tnc2)); out.put(',');
+        out.csv(view(row.message)); out.put('\n');
+        return;
+    }
+    out.raw("{\"date\":"); out.json(view(row.date));
+    out.raw(",\"source\":"); out.json(view(row.source));
+    out.raw(",\"destination\":"); out.json(view(row.destination));
+    out.raw(",\"type\":"); out.json(type);
+    out.raw(",\"trame\":"); out.json(view(row.tnc2));
+    out.raw(",\"message\":"); out.json(view(row.message));
+    out.raw("}\n");
+}
+
+/**
+ * @brief Écrit une position ; en GPX, une trace est ouverte pour chaque indicatif.
+ */
+void writePosition(Output &out, const Options &options, const Row &row, QByteArray &track)
+{
+    const APRSPosition &p = row.packet.position;
+    switch (options.format) {
+    case Format::Csv:
+        out.csv(view(row.date)); out.put(',');
+        out.csv(view(row.source)); out.put(',');
+        out.number(p.latitude); out.put(',');
+        out.number(p.longitude); out.put(',');
+        out.number(p.altitude, p.hasAltitude, 1); out.put(',');
+        out.number(p.speed, p.hasCourseSpeed, 1); out.put(',');
+        out.number(p.course, p.hasCourseSpeed, 0); out.put('\n');
+        break;
+    case Format::NdJson:
+        out.raw("{\"date\":"); out.json(view(row.date));
+        out.raw(",\"source\":"); out.json(view(row.source));
+        out.raw(",\"latitude\":"); out.number(p.latitude);
+        out.raw(",\"longitude\":"); out.number(p.longitude);
+        if (p.hasAltitude) {
+            out.raw(",\"altitude\":"); out.number(p.altitude, true, 1);
+        }
+        if (p.hasCourseSpeed) {
+            out.raw(",\"vitesse\":"); out.number(p.speed, true, 1);
+            out.raw(",\"cap\":"); out.number(p.course, true, 0);
+        }
+        out.raw("}\n");
+        break;
+    case Format::Gpx:
+        if (row.source != track) {
+            if (!track.isEmpty())
+                out.raw("</trkseg></trk>\n");
+            out.raw("<trk><name>"); out.xml(view(row.source)); out.raw("</name><trkseg>\n");
+            track = row.source;
+        }
+        out.raw("<trkpt lat=\""); out.number(p.latitude);
+        out.raw("\" lon=\""); out.number(p.longitude); out.raw("\">");
+        if (p.hasAltitude) {
+            out.raw("<ele>"); out.number(p.altitude, true, 1); out.raw("</ele>");
+        }
+        out.raw("<time>"); out.raw(view(row.date)); out.raw("</time></trkpt>\n");
+        break;
+    }
+}
+
+void writeTelemetry(Output &out, const Options &options, const Row &row)
+{
+    const APRSTelemetry &t = row.packet.telemetry;
+    const APRSWeather &w = row.packet.weather;
+    // Télémétrie "T#" ou compressée en base91 à la suite d'une position
+    bool isTelemetry = row.packet.type == APRSPacketType::Telemetry || t.compressed;
+    if (options.format == Format::Csv) {
+        out.csv(view(row.date)); out.put(',');
+        out.csv(view(row.source)); out.put(',');
+        out.number(t.sequence, isTelemetry && t.sequence >= 0, 0);
+        for (int i = 0; i < APRSTelemetry::MAX_ANALOG; ++i) {
+            out.put(',');
+            out.number(t.analog[i], isTelemetry && i < t.analogCount, 3);
+        }
+        out.put(',');
+        out.number(t.digital, isTelemetry && t.hasDigital, 0); out.put(',');
+        out.number(w.temperature, w.hasTemperature, 1); out.put(',');
+        out.number(w.pressure, w.hasPressure, 1); out.put(',');
+        out.number(w.humidity, w.hasHumidity, 0); out.put('\n');
+        return;
+    }
+    out.raw("{\"date\":"); out.json(view(row.date));
+    out.raw(",\"source\":"); out.json(view(row.source));
+    if (isTelemetry) {
+        if (t.sequence >= 0) {
+            out.raw(",\"sequence\":"); out.number(t.sequence, true, 0);
+        }
+        out.raw(",\"analogique\":[");
+        for (int i = 0; i < t.analogCount; ++i) {
+            if (i > 0)
+                out.put(',');
+            out.number(t.analog[i], true, 3);
+        }
+        out.put(']');
+        if (t.hasDigital) {
+            out.raw(",\"bits\":"); out.number(t.digital, true, 0);
+        }
+    }
+    if (w.hasTemperature) {
+        out.raw(",\"temperature\":"); out.number(w.temperature, true, 1);
+    }
+    if (w.hasPressure) {
+        out.raw(",\"pression\":"); out.number(w.pressure, true, 1);
+    }
+    if (w.hasHumidity) {
+        out.raw(",\"humidite\":"); out.number(w.humidity, true, 0);
+    }
+    out.raw("}\n");
+}
+
+/**
+ * @brief Lit les options de la ligne de commande.
+ *
+ * @return bool @c false si une option est invalide.
+ */
+bool parseArguments(const QCoreApplication &app, Options &options)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Export en flux d'un vol vers CSV, NDJSON ou GPX");
+    parser.addHelpOption();
+
+    QCommandLineOption sqliteOption("sqlite", "Base SQLite à lire (par défaut : base MySQL).", "fichier");
+    QCommandLineOption fromOption("from", "Début de la fenêtre (ISO 8601, inclus).", "date");
+    QCommandLineOption toOption("to", "Fin de la fenêtre (ISO 8601, exclue).", "date");
+    QCommandLineOption sourceOption("source", "Indicatif source à exporter (par défaut : tous).", "indicatif");
+    QCommandLineOption kindOption("kind", "Données : frames, positions ou telemetry.", "type", "frames");
+    QCommandLineOption formatOption("format", "Format : csv, ndjson ou gpx (positions).", "format", "csv");
+    QCommandLineOption outputOption("output", "Fichier de sortie (par défaut : sortie standard).", "fichier");
+    QCommandLineOption balloonOption("balloon", "Indicatifs de la nacelle, séparés par des virgules.", "indicatifs",
+                                     APRSParser::DEFAULT_BALLOON_CALLSIGN);
+    parser.addOptions({sqliteOption, fromOption, toOption, sourceOption, kindOption, formatOption, outputOption,
+                       balloonOption});
+    parser.process(app);
+
+    options.sqlitePath = parser.value(sqliteOption);
+    options.source = parser.value(sourceOption);
+    options.output = parser.value(outputOption);
+    Frame::setBalloonCallsigns(parser.value(balloonOption));
+    if (parser.isSet(fromOption))
+        options.from = QDateTime::fromString(parser.value(fromOption), Qt::ISODate);
+    if (parser.isSet(toOption))
+        options.to = QDateTime::fromString(parser.value(toOption), Qt::ISODate);
+    if ((parser.isSet(fromOption) && !options.from.isValid()) || (parser.isSet(toOption) && !options.to.isValid())) {
+        std::fprintf(stderr, "Date invalide (format attendu : 2025-05-14T08:00:00)\n");
+        return false;
+    }
+
+    const QString kind = parser.value(kindOption);
+    if (kind == "frames")
+        options.kind = Kind::Frames;
+    else if (kind == "positions")
+        options.kind = Kind::Positions;
+    else if (kind == "telemetry")
+        options.kind = Kind::Telemetry;
+    else {
+        std::fprintf(stderr, "Type inconnu : %s\n", qPrintable(kind));
+        return false;
+    }
+
+    const QString format = parser.value(formatOption);
+    if (format == "csv")
+        options.format = Format::Csv;
+    else if (format == "ndjson")
+        options.format = Format::NdJson;
+    else if (format == "gpx" && options.kind == Kind::Positions)
+        options.format = Format::Gpx;
+    else {
+        std::fprintf(stderr, "Format invalide : %s (gpx n'est possible qu'avec --kind positions)\n",
+                     qPrintable(format));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Met une valeur en forme de littéral SQL, échappé par le pilote de la connexion.
+ */
+QString sqlLiteral(const QSqlDatabase &db, const QVariant &value)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    QSqlField field(QString(), value.metaType());
+#else
+    QSqlField field(QString(), value.type());
+#endif
+    field.setValue(value);
+    return db.driver()->formatValue(field);
+}
+
+/**
+ * @brief Construit la requête de la fenêtre demandée.
+ *
+ * Les trames sont triées par date (par indicatif puis par date en GPX, une trace par indicatif) ;
+ * les index de la table trames sur (date_reception) et (source, date_reception) évitent un tri
+ * du résultat complet sur le serveur.
+ *
+ * @param options Les options de l'export.
+ * @param literals Connexion dont le pilote met en forme les valeurs dans la requête (MySQL, requête
+ *                 non préparée), ou nullptr pour des paramètres nommés à lier (:from, :to, :source).
+ */
+QString selectStatement(const Options &options, const QSqlDatabase *literals)
+{
+    auto value = [literals](const char *name, const QVariant &v) {
+        return literals ? sqlLiteral(*literals, v) : QString(name);
+    };
+    QString sql = "SELECT source, destination, trame, message, date_reception FROM trames WHERE 1 = 1";
+    if (options.from.isValid())
+        sql += " AND date_reception >= " + value(":from", options.from);
+    if (options.to.isValid())
+        sql += " AND date_reception < " + value(":to", options.to);
+    if (!options.source.isEmpty())
+        sql += " AND source = " + value(":source", options.source);
+    sql += (options.format == Format::Gpx && options.source.isEmpty())
+               ? " ORDER BY source, date_reception"
+               : " ORDER BY date_reception";
+    return sql;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    Options options;
+    if (!parseArguments(app, options))
+        return EXIT_FAILURE;
+
+    // Ouverture de la base : fichier SQLite en lecture seule, ou base MySQL du serveur
+    std::unique_ptr<MySQLManager> mysql;
+    QSqlDatabase db;
+    if (options.sqlitePath.isEmpty()) {
+        mysql = std::make_unique<MySQLManager>();
+        if (!mysql->openConnection())
+            return EXIT_FAILURE;
+        db = mysql->database();
+    } else {
+        db = QSqlDatabase::addDatabase("QSQLITE", "export");
+        db.setDatabaseName(options.sqlitePath);
+        db.setConnectOptions("QSQLITE_OPEN_READONLY");
+        if (!db.open()) {
+            std::fprintf(stderr, "Ouverture impossible : %s\n", qPrintable(db.lastError().text()));
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::FILE *file = stdout;
+    if (!options.output.isEmpty()) {
+        file = std::fopen(QFile::encodeName(options.output).constData(), "wb");
+        if (!file) {
+            std::perror("fopen");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // MySQL : requête directe, lue au fil de l'eau ; SQLite : requête préparée, lue pas à pas
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    bool executed;
+    if (mysql) {
+        executed = query.exec(selectStatement(options, &db));
+    } else {
+        if (!query.prepare(selectStatement(options, nullptr))) {
+            std::fprintf(stderr, "Requete invalide : %s\n", qPrintable(query.lastError().text()));
+            return EXIT_FAILURE;
+        }
+        if (options.from.isValid())
+            query.bindValue(":from", options.from);
+        if (options.to.isValid())
+            query.bindValue(":to", options.to);
+        if (!options.source.isEmpty())
+            query.bindValue(":source", options.source);
+        executed = query.exec();
+    }
+    if (!executed) {
+        std::fprintf(stderr, "Erreur de lecture : %s\n", qPrintable(query.lastError().text()));
+        return EXIT_FAILURE;
+    }
+
+    Output out(file);
+    writeHeader(out, options);
+
+    Row row;
+    QByteArray track;
+    long read = 0;
+    long written = 0;
+    long intervalRead = 0;
+    const Clock::time_point start = Clock::now();
+    Clock::time_point nextReport = start + std::chrono::seconds(1);
+
+    while (query.next()) {
+        ++read;
+        ++intervalRead;
+        row.source = query.value(0).toString().toUtf8();
+        row.tnc2 = query.value(2).toString().toUtf8();
+        row.decoded = APRSParser::parseTNC2(view(row.tnc2), row.packet);
+
+        bool keep = true;
+        switch (options.kind) {
+        case Kind::Frames:    keep = true; break;
+        case Kind::Positions: keep = hasPosition(row); break;
+        case Kind::Telemetry: keep = hasTelemetry(row); break;
+        }
+        if (keep) {
+            row.date = query.value(4).toDateTime().toUTC().toString(Qt::ISODateWithMs).toUtf8();
+            if (options.kind == Kind::Frames) {
+                row.destination = query.value(1).toString().toUtf8();
+                row.message = query.value(3).toString().toUtf8();
+                writeFrame(out, options, row);
+            } else if (options.kind == Kind::Positions) {
+                writePosition(out, options, row, track);
+            } else {
+                writeTelemetry(out, options, row);
+            }
+            ++written;
+        }
+
+        if ((read & 0x3ff) == 0 && Clock::now() >= nextReport) {
+            std::fprintf(stderr, "%ld lignes lues, %ld exportees, %ld lignes/s\n", read, written, intervalRead);
+            intervalRead = 0;
+            nextReport += std::chrono::seconds(1);
+        }
+    }
+
+    bool failed = query.lastError().isValid();
+    if (failed)
+        std::fprintf(stderr, "Lecture interrompue : %s\n", qPrintable(query.lastError().text()));
+
+    writeFooter(out, options, !track.isEmpty());
+    if (!out.close()) {
+        std::perror("ecriture");
+        failed = true;
+    }
+    if (file != stdout)
+        std::fclose(file);
+
+    double total = std::chrono::duration<double>(Clock::now() - start).count();
+    std::fprintf(stderr, "%ld lignes lues, %ld exportees en %.2f s (%.0f lignes/s)\n",
+                 read, written, total, total > 0.0 ? read / total : 0.0);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
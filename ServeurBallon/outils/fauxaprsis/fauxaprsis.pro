@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+# Faux serveur APRS-IS local pour les mesures de débit du relais (POSIX, sans dépendance Qt)
+SOURCES += \
+    main.cpp
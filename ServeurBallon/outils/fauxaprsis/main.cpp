@@ -0,0 +1,412 @@
+/**
+ * @file main.cpp
+ * @brief Faux serveur APRS-IS local.
+ *
+ * Remplace france.aprs2.net:14580 pour mesurer hors ligne le relais (gating) de ServeurBallon :
+ * accepte la ligne de login "user ... pass ... vers ...", peut injecter un flux entrant à débit
+ * réglable, enregistre chaque ligne relayée avec son heure de réception et sait simuler des
+ * déconnexions et un lecteur lent. Une ligne de statistiques est affichée chaque seconde
+ * (lignes relayées par seconde, reconnexions, délai de reconnexion).
+ *
+ * Lancer ensuite ServeurBallon avec --aprs-host 127.0.0.1 --aprs-port <port>.
+ */
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile std::sig_atomic_t g_stop = 0;
+
+/**
+ * @brief Paramètres du faux serveur.
+ */
+struct Options {
+    int port = 14580;               ///< Port d'écoute.
+    std::string record;             ///< Fichier d'enregistrement des lignes relayées.
+    std::string feedFile;           ///< Fichier de lignes à injecter (sinon lignes générées).
+    double feedRate = 0.0;          ///< Lignes injectées par seconde vers chaque client (0 : aucune).
+    long dropAfter = 0;             ///< Déconnexion après N lignes relayées (0 : jamais).
+    double dropEvery = 0.0;         ///< Déconnexion toutes les S secondes (0 : jamais).
+    long slowRead = 0;              ///< Débit de lecture limité en octets/s (0 : illimité).
+    double duration = 0.0;          ///< Durée de fonctionnement (s, 0 : illimitée).
+};
+
+/**
+ * @brief État d'une connexion cliente.
+ */
+struct Client {
+    int fd = -1;
+    int id = 0;
+    std::string input;
+    std::string output;
+    std::string callsign;
+    bool loggedIn = false;
+    long lines = 0;
+    double readBudget = 0.0;
+    Clock::time_point connectedAt;
+    Clock::time_point nextFeed;
+    std::size_t feedIndex = 0;
+};
+
+/**
+ * @brief Statistiques globales.
+ */
+struct Stats {
+    long totalLines = 0;
+    long intervalLines = 0;
+    long connections = 0;
+    long forcedDisconnects = 0;
+    long feedLines = 0;
+    bool waitingReconnect = false;
+    Clock::time_point lastDisconnect;
+    double lastReconnectMs = -1.0;
+};
+
+void onSignal(int)
+{
+    g_stop = 1;
+}
+
+std::int64_t nowMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Calcule le code d'accès APRS-IS associé à un indicatif (sans SSID).
+ */
+int passcode(const std::string &callsign)
+{
+    std::string call;
+    for (char c : callsign) {
+        if (c == '-')
+            break;
+        call += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    int hash = 0x73e2;
+    for (std::size_t i = 0; i < call.size(); i += 2) {
+        hash ^= call[i] << 8;
+        if (i + 1 < call.size())
+            hash ^= call[i + 1];
+    }
+    return hash & 0x7fff;
+}
+
+/**
+ * @brief Traite la ligne de login "user CALL pass CODE vers LOGICIEL VERSION".
+ */
+void handleLogin(Client &client, const std::string &line)
+{
+    char user[32] = {0};
+    int pass = -1;
+    if (std::sscanf(line.c_str(), "user %31s pass %d", user, &pass) < 1) {
+        client.output += "# Login attendu : user CALL pass CODE vers LOGICIEL VERSION\r\n";
+        return;
+    }
+    client.callsign = user;
+    client.loggedIn = true;
+    bool verified = (pass == passcode(client.callsign));
+    client.output += "# logresp " + client.callsign + (verified ? " verified" : " unverified")
+                     + ", server FAUXAPRSIS\r\n";
+    std::printf("Client %d : login %s (%s)\n", client.id, user, verified ? "verifie" : "non verifie");
+}
+
+void usage(const char *program)
+{
+    std::fprintf(stderr,
+                 "Usage : %s [options]\n"
+                 "  -p, --port N            port d'ecoute (defaut 14580)\n"
+                 "  -o, --record FICHIER    enregistre chaque ligne relayee avec son horodatage\n"
+                 "  -f, --feed FICHIER      lignes a injecter vers les clients (sinon generees)\n"
+                 "  -r, --feed-rate N       lignes injectees par seconde et par client (defaut 0)\n"
+                 "  -a, --drop-after N      deconnecte le client apres N lignes relayees\n"
+                 "  -e, --drop-every S      deconnecte le client toutes les S secondes\n"
+                 "  -s, --slow-read N       limite la lecture a N octets/s (lecteur lent)\n"
+                 "  -d, --duration S        duree de fonctionnement en secondes\n",
+                 program);
+}
+
+bool parseArguments(int argc, char *argv[], Options &options)
+{
+    static const option longOptions[] = {
+        {"port", required_argument, nullptr, 'p'},
+        {"record", required_argument, nullptr, 'o'},
+        {"feed", required_argument, nullptr, 'f'},
+        {"feed-rate", required_argument, nullptr, 'r'},
+        {"drop-after", required_argument, nullptr, 'a'},
+        {"drop-every", required_argument, nullptr, 'e'},
+        {"slow-read", required_argument, nullptr, 's'},
+        {"duration", required_argument, nullptr, 'd'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "p:o:f:r:a:e:s:d:h", longOptions, nullptr)) != -1) {
+        switch (opt) {
+        case 'p': options.port = std::atoi(optarg); break;
+        case 'o': options.record = optarg; break;
+        case 'f': options.feedFile = optarg; break;
+        case 'r': options.feedRate = std::atof(optarg); break;
+        case 'a': options.dropAfter = std::atol(optarg); break;
+        case 'e': options.dropEvery = std::atof(optarg); break;
+        case 's': options.slowRead = std::atol(optarg); break;
+        case 'd': options.duration = std::atof(optarg); break;
+        default: return false;
+        }
+    }
+    return options.port > 0 && options.port < 65536 && options.feedRate >= 0.0;
+}
+
+int openListener(int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(fd, 8) != 0) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> feed;
+    if (!options.feedFile.empty()) {
+        std::ifstream in(options.feedFile);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (!line.empty())
+                feed.push_back(line + "\r\n");
+        }
+    }
+    if (feed.empty()) {
+        for (int i = 0; i < 100; ++i) {
+            char line[128];
+            std::snprintf(line, sizeof(line), "F4FEED-%d>APRS,TCPIP*,qAC,T2FAUX:!4542.%02dN/00451.%02dE-Flux injecte %d\r\n",
+                          i % 16, i, (i * 7) % 100, i);
+            feed.push_back(line);
+        }
+    }
+
+    FILE *record = nullptr;
+    if (!options.record.empty() && !(record = std::fopen(options.record.c_str(), "w"))) {
+        std::perror("Erreur ouverture du fichier d'enregistrement");
+        return EXIT_FAILURE;
+    }
+
+    int listener = openListener(options.port);
+    if (listener < 0) {
+        std::perror("Erreur ouverture du port d'ecoute");
+        return EXIT_FAILURE;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+    std::printf("Faux serveur APRS-IS en ecoute sur le port %d\n", options.port);
+    std::fflush(stdout);
+
+    std::vector<Client> clients;
+    Stats stats;
+    int nextId = 1;
+    const auto start = Clock::now();
+    auto lastTick = start;
+    auto nextReport = start + std::chrono::seconds(1);
+    const auto feedPeriod = options.feedRate > 0.0
+                                ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options.feedRate))
+                                : Clock::duration::zero();
+    char buffer[8192];
+
+    while (!g_stop) {
+        auto now = Clock::now();
+        if (options.duration > 0.0 && now - start >= std::chrono::duration<double>(options.duration))
+            break;
+
+        // Crédit de lecture du lecteur lent et injection du flux entrant
+        double elapsed = std::chrono::duration<double>(now - lastTick).count();
+        lastTick = now;
+        for (Client &client : clients) {
+            if (options.slowRead > 0)
+                client.readBudget = std::min(client.readBudget + elapsed * options.slowRead,
+                                             static_cast<double>(options.slowRead));
+            while (client.loggedIn && options.feedRate > 0.0 && now >= client.nextFeed
+                   && client.output.size() < 1 << 20) {
+                client.output += feed[client.feedIndex++ % feed.size()];
+                client.nextFeed += feedPeriod;
+                ++stats.feedLines;
+            }
+        }
+
+        std::vector<pollfd> pfds;
+        pfds.push_back({listener, POLLIN, 0});
+        for (const Client &client : clients) {
+            short events = 0;
+            if (options.slowRead == 0 || client.readBudget >= 1.0)
+                events |= POLLIN;
+            if (!client.output.empty())
+                events |= POLLOUT;
+            pfds.push_back({client.fd, events, 0});
+        }
+
+        int timeout = 100;
+        if (options.feedRate > 0.0 || options.slowRead > 0)
+            timeout = 1;
+        if (poll(pfds.data(), pfds.size(), timeout) < 0 && errno != EINTR)
+            break;
+
+        if (pfds[0].revents & POLLIN) {
+            int fd;
+            while ((fd = accept(listener, nullptr, nullptr)) >= 0) {
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                if (options.slowRead > 0) {
+                    int size = 4096;
+                    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+                }
+                Client client;
+                client.fd = fd;
+                client.id = nextId++;
+                client.connectedAt = Clock::now();
+                client.nextFeed = client.connectedAt;
+                client.output = "# fauxaprsis 1.0\r\n";
+                clients.push_back(client);
+                ++stats.connections;
+                std::printf("Client %d connecte\n", client.id);
+            }
+        }
+
+        for (std::size_t i = 0; i < clients.size(); ++i) {
+            Client &client = clients[i];
+            short revents = pfds[i + 1].revents;
+            bool closed = false;
+
+            if (revents & (POLLIN | POLLHUP | POLLERR)) {
+                std::size_t want = sizeof(buffer);
+                if (options.slowRead > 0)
+                    want = std::min(want, static_cast<std::size_t>(client.readBudget));
+                ssize_t n = (want > 0) ? read(client.fd, buffer, want) : 0;
+                if (n > 0) {
+                    if (options.slowRead > 0)
+                        client.readBudget -= n;
+                    client.input.append(buffer, static_cast<std::size_t>(n));
+                } else if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    closed = true;
+                }
+            }
+
+            // Découpage en lignes : la première est le login, les suivantes sont relayées
+            std::size_t eol;
+            while ((eol = client.input.find('\n')) != std::string::npos) {
+                std::string line = client.input.substr(0, eol);
+                client.input.erase(0, eol + 1);
+                if (!line.empty() && line.back() == '\r')
+                    line.pop_back();
+                if (line.empty())
+                    continue;
+                if (!client.loggedIn) {
+                    handleLogin(client, line);
+                    if (client.loggedIn && stats.waitingReconnect) {
+                        stats.lastReconnectMs = std::chrono::duration<double, std::milli>(Clock::now() - stats.lastDisconnect).count();
+                        stats.waitingReconnect = false;
+                        std::printf("Reconnexion apres %.0f ms\n", stats.lastReconnectMs);
+                    }
+                    continue;
+                }
+                ++client.lines;
+                ++stats.totalLines;
+                ++stats.intervalLines;
+                if (record)
+                    std::fprintf(record, "%lld %d %s\n", static_cast<long long>(nowMicros()), client.id, line.c_str());
+            }
+
+            if (!client.output.empty() && (revents & POLLOUT)) {
+                ssize_t n = write(client.fd, client.output.data(), client.output.size());
+                if (n > 0)
+                    client.output.erase(0, static_cast<std::size_t>(n));
+                else if (n < 0 && errno != EAGAIN && errno != EINTR)
+                    closed = true;
+            }
+
+            bool drop = (options.dropAfter > 0 && client.lines >= options.dropAfter)
+                        || (options.dropEvery > 0.0
+                            && Clock::now() - client.connectedAt >= std::chrono::duration<double>(options.dropEvery));
+            if (drop && !closed) {
+                std::printf("Client %d : deconnexion simulee apres %ld lignes\n", client.id, client.lines);
+                ++stats.forcedDisconnects;
+                closed = true;
+            }
+
+            if (closed) {
+                close(client.fd);
+                client.fd = -1;
+                stats.waitingReconnect = true;
+                stats.lastDisconnect = Clock::now();
+            }
+        }
+        for (std::size_t i = clients.size(); i-- > 0;) {
+            if (clients[i].fd < 0)
+                clients.erase(clients.begin() + static_cast<long>(i));
+        }
+
+        if (Clock::now() >= nextReport) {
+            std::printf("[%5.0f s] clients=%zu lignes/s=%ld total=%ld injectees=%ld connexions=%ld "
+                        "deconnexions simulees=%ld dernier delai de reconnexion=%.0f ms\n",
+                        std::chrono::duration<double>(Clock::now() - start).count(), clients.size(),
+                        stats.intervalLines, stats.totalLines, stats.feedLines, stats.connections,
+                        stats.forcedDisconnects, stats.lastReconnectMs);
+            std::fflush(stdout);
+            if (record)
+                std::fflush(record);
+            stats.intervalLines = 0;
+            nextReport += std::chrono::seconds(1);
+        }
+    }
+
+    double total = std::chrono::duration<double>(Clock::now() - start).count();
+    std::printf("\n%ld lignes relayees en %.1f s (%.1f lignes/s), %ld connexions\n",
+                stats.totalLines, total, stats.totalLines / total, stats.connections);
+    for (const Client &client : clients)
+        close(client.fd);
+    close(listener);
+    if (record)
+        std::fclose(record);
+    return EXIT_SUCCESS;
+}
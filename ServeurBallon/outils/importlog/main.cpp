@@ -0,0 +1,460 @@
+/**
+ * @file main.cpp
+ * @brief Import en masse de journaux APRS bruts (TNC2, export brut aprs.fi).
+ *
+ * Le fichier est projeté en mémoire (mmap) et parcouru par fenêtres de quelques Mo. Chaque fenêtre
+ * est découpée en tranches alignées sur les fins de ligne, analysées en parallèle sur le pool de
+ * threads avec les décodeurs du serveur (Frame::fromTNC2, donc APRSParser) pendant que la fenêtre
+ * précédente est écrite. L'écriture passe par le support de stockage (SQLiteStorage ou
+ * MySQLManager) en transactions groupées.
+ *
+ * Formats de ligne reconnus :
+ *   F4KMN-11>APLRT1,WIDE1-1:!4850.00N/00220.00EO/A=001234
+ *   2025-05-14 08:00:01 UTC: F4KMN-11>APLRT1,WIDE1-1,qAR,F4XYZ:!4850.00N/00220.00EO/A=001234
+ * Les lignes vides et les commentaires APRS-IS ('#') sont ignorés.
+ *
+ * Le chemin de digipeaters est retiré ("SRC>DEST:info") comme pour les trames reçues en direct :
+ * un paquet relayé par plusieurs iGates, ou déjà reçu par la station, donne la même trame. Les doublons
+ * proches dans le journal sont écartés en mémoire, les autres par la clé primaire de la table trames.
+ *
+ * Exemple :
+ *   ./importlog --sqlite Ballon2025.sqlite aprsfi-F4KMN-11.txt igate-2025-05-14.log
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <memory>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_set>
+#include <vector>
+
+#include "frame.h"
+#include "mysqlmanager.h"
+#include "sqlitestorage.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t WINDOW_SIZE = 4 << 20;    ///< Taille d'une fenêtre du fichier (octets).
+constexpr std::size_t DEDUP_WINDOW = 65536;     ///< Nombre de trames récentes mémorisées pour l'élimination des doublons.
+
+/**
+ * @brief Paramètres de l'import.
+ */
+struct Options {
+    QString sqlitePath;             ///< Base SQLite à alimenter (sinon la base MySQL).
+    QStringList files;              ///< Journaux à importer.
+    int threads = 0;                ///< Threads d'analyse (0 : nombre de cœurs).
+    int utcOffset = 0;              ///< Décalage des dates non UTC du journal (minutes).
+    qint64 defaultDate = -1;        ///< Date des lignes sans horodatage (ms, -1 : date du fichier).
+    bool dryRun = false;            ///< Analyse seulement, sans écriture.
+};
+
+/**
+ * @brief Résultat de l'analyse d'une tranche du fichier.
+ */
+struct Parsed {
+    std::vector<FramePtr> frames;   ///< Trames valides, dans l'ordre du fichier.
+    long lines = 0;                 ///< Lignes lues (hors lignes vides).
+    long skipped = 0;               ///< Commentaires APRS-IS.
+    long invalid = 0;               ///< Lignes non reconnues.
+};
+
+/**
+ * @brief Nombre de jours depuis le 1970-01-01 (calendrier grégorien proleptique).
+ */
+qint64 daysFromCivil(int year, int month, int day)
+{
+    year -= month <= 2;
+    const qint64 era = (year >= 0 ? year : year - 399) / 400;
+    const int yoe = year - static_cast<int>(era * 400);
+    const int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/**
+ * @brief Lit n chiffres décimaux.
+ */
+bool digits(const char *p, int n, int &value)
+{
+    value = 0;
+    for (int i = 0; i < n; ++i) {
+        if (p[i] < '0' || p[i] > '9')
+            return false;
+        value = value * 10 + (p[i] - '0');
+    }
+    return true;
+}
+
+/**
+ * @brief Extrait l'horodatage "AAAA-MM-JJ HH:MM:SS[ TZ]:" en tête de ligne.
+ *
+ * @param line La ligne ; en cas de succès, l'horodatage en est retiré.
+ * @param utcOffset Décalage appliqué aux dates dont le fuseau n'est pas UTC (minutes).
+ * @param timestamp Horodatage extrait (ms).
+ * @return bool @c true si la ligne commence par un horodatage.
+ */
+bool parseDatePrefix(std::string_view &line, int utcOffset, qint64 &timestamp)
+{
+    int year, month, day, hour, minute, second;
+    if (line.size() < 20 || line[4] != '-' || line[7] != '-' || (line[10] != ' ' && line[10] != 'T')
+        || line[13] != ':' || line[16] != ':'
+        || !digits(line.data(), 4, year) || !digits(line.data() + 5, 2, month) || !digits(line.data() + 8, 2, day)
+        || !digits(line.data() + 11, 2, hour) || !digits(line.data() + 14, 2, minute)
+        || !digits(line.data() + 17, 2, second))
+        return false;
+
+    std::string_view rest = line.substr(19);
+    std::size_t colon = rest.find(':');
+    if (colon == std::string_view::npos || colon > 8)
+        return false;
+    std::string_view zone = rest.substr(0, colon);
+    while (!zone.empty() && zone.front() == ' ')
+        zone.remove_prefix(1);
+    const bool utc = zone.empty() || zone == "UTC" || zone == "GMT" || zone == "Z";
+
+    qint64 seconds = ((daysFromCivil(year, month, day) * 24 + hour) * 60 + minute) * 60 + second;
+    if (!utc)
+        seconds -= static_cast<qint64>(utcOffset) * 60;
+    timestamp = seconds * 1000;
+
+    rest.remove_prefix(colon + 1);
+    while (!rest.empty() && rest.front() == ' ')
+        rest.remove_prefix(1);
+    line = rest;
+    return true;
+}
+
+/**
+ * @brief Retire le chemin de digipeaters : "SRC>DEST,PATH:info" devient "SRC>DEST:info".
+ *
+ * @param line La trame TNC2.
+ * @param buffer Tampon de sortie d'au moins Frame::MAX_TNC2_SIZE octets.
+ * @return std::string_view La trame normalisée (vide si la ligne n'est pas une trame TNC2).
+ */
+std::string_view stripPath(std::string_view line, char *buffer)
+{
+    std::size_t gt = line.find('>');
+    if (gt == std::string_view::npos || gt == 0)
+        return std::string_view();
+    std::size_t colon = line.find(':', gt + 1);
+    if (colon == std::string_view::npos)
+        return std::string_view();
+    std::size_t destEnd = line.find(',', gt + 1);
+    if (destEnd == std::string_view::npos || destEnd > colon)
+        return line;
+
+    std::string_view info = line.substr(colon);
+    if (destEnd + info.size() > static_cast<std::size_t>(Frame::MAX_TNC2_SIZE))
+        return std::string_view();
+    std::memcpy(buffer, line.data(), destEnd);
+    std::memcpy(buffer + destEnd, info.data(), info.size());
+    return std::string_view(buffer, destEnd + info.size());
+}
+
+/**
+ * @brief Analyse une tranche du fichier (exécuté sur le pool de threads).
+ */
+Parsed parseSlice(const char *begin, const char *end, const Options &options, qint64 defaultDate)
+{
+    Parsed parsed;
+    parsed.frames.reserve(static_cast<std::size_t>(end - begin) / 64);
+    char buffer[Frame::MAX_TNC2_SIZE];
+
+    const char *p = begin;
+    while (p < end) {
+        const char *eol = static_cast<const char *>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        if (!eol)
+            eol = end;
+        std::string_view line(p, static_cast<std::size_t>(eol - p));
+        p = eol + 1;
+
+        while (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (line.empty())
+            continue;
+        ++parsed.lines;
+        if (line.front() == '#') {
+            ++parsed.skipped;
+            continue;
+        }
+
+        qint64 timestamp = defaultDate;
+        parseDatePrefix(line, options.utcOffset, timestamp);
+        std::string_view tnc2 = stripPath(line, buffer);
+        FramePtr frame = tnc2.empty() ? FramePtr() : Frame::fromTNC2(tnc2, timestamp);
+        if (frame)
+            parsed.frames.push_back(std::move(frame));
+        else
+            ++parsed.invalid;
+    }
+    return parsed;
+}
+
+/**
+ * @brief Lance l'analyse parallèle d'une fenêtre découpée en tranches alignées sur les lignes.
+ */
+std::vector<QFuture<Parsed>> parseWindow(const char *begin, const char *end, int slices,
+                                         const Options &options, qint64 defaultDate)
+{
+    std::vector<QFuture<Parsed>> futures;
+    const std::size_t sliceSize = static_cast<std::size_t>(end - begin) / static_cast<std::size_t>(slices) + 1;
+    const char *p = begin;
+    while (p < end) {
+        const char *cut = (static_cast<std::size_t>(end - p) > sliceSize) ? p + sliceSize : end;
+        if (cut < end) {
+            const char *eol = static_cast<const char *>(std::memchr(cut, '\n', static_cast<std::size_t>(end - cut)));
+            cut = eol ? eol + 1 : end;
+        }
+        futures.push_back(QtConcurrent::run(parseSlice, p, cut, options, defaultDate));
+        p = cut;
+    }
+    return futures;
+}
+
+/**
+ * @brief Fin de la fenêtre commençant en @p begin, alignée sur une fin de ligne.
+ */
+const char *windowEnd(const char *begin, const char *end)
+{
+    if (static_cast<std::size_t>(end - begin) <= WINDOW_SIZE)
+        return end;
+    const char *cut = begin + WINDOW_SIZE;
+    const char *eol = static_cast<const char *>(std::memchr(cut, '\n', static_cast<std::size_t>(end - cut)));
+    return eol ? eol + 1 : end;
+}
+
+/**
+ * @brief Élimination des doublons récents (même trame normalisée), en mémoire bornée.
+ */
+class RecentFrames {
+public:
+    /**
+     * @brief Mémorise une trame.
+     * @return bool @c true si la trame fait partie des DEDUP_WINDOW dernières trames.
+     */
+    bool seen(const Frame &frame)
+    {
+        const std::size_t hash = std::hash<std::string_view>()(frame.tnc2());
+        if (!m_hashes.insert(hash).second)
+            return true;
+        m_order.push_back(hash);
+        if (m_order.size() > DEDUP_WINDOW) {
+            m_hashes.erase(m_order.front());
+            m_order.pop_front();
+        }
+        return false;
+    }
+
+private:
+    std::unordered_set<std::size_t> m_hashes;
+    std::deque<std::size_t> m_order;
+};
+
+/**
+ * @brief Compteurs de l'import.
+ */
+struct Stats {
+    long lines = 0;
+    long skipped = 0;
+    long invalid = 0;
+    long duplicates = 0;
+    long written = 0;
+    long rejected = 0;
+};
+
+/**
+ * @brief Écrit les trames d'une fenêtre dans une transaction.
+ *
+ * @return bool @c false si le support est perdu.
+ */
+bool writeWindow(StorageBackend *backend, std::vector<QFuture<Parsed>> &futures, RecentFrames &recent, Stats &stats)
+{
+    if (backend && !backend->beginBatch())
+        return false;
+    for (QFuture<Parsed> &future : futures) {
+        const Parsed parsed = future.result();
+        stats.lines += parsed.lines;
+        stats.skipped += parsed.skipped;
+        stats.invalid += parsed.invalid;
+        for (const FramePtr &frame : parsed.frames) {
+            if (recent.seen(*frame)) {
+                ++stats.duplicates;
+                continue;
+            }
+            if (!backend || backend->insertFrame(*frame))
+                ++stats.written;
+            else if (!backend->ping())
+                return false;
+            else
+                ++stats.rejected;
+        }
+    }
+    return !backend || backend->commitBatch();
+}
+
+bool parseArguments(const QCoreApplication &app, Options &options)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Import de journaux APRS bruts (TNC2, aprs.fi) dans la base");
+    parser.addHelpOption();
+    parser.addPositionalArgument("journaux", "Fichiers à importer.", "journal...");
+
+    QCommandLineOption sqliteOption("sqlite", "Base SQLite à alimenter (par défaut : base MySQL).", "fichier");
+    QCommandLineOption threadsOption("threads", "Threads d'analyse (0 : nombre de cœurs).", "n", "0");
+    QCommandLineOption offsetOption("utc-offset", "Décalage des dates non UTC du journal, en minutes (120 pour CEST).",
+                                    "minutes", "0");
+    QCommandLineOption dateOption("date", "Date des lignes sans horodatage (ISO 8601, par défaut : date du fichier).",
+                                  "date");
+    QCommandLineOption dryRunOption("dry-run", "Analyse seulement, sans écriture (mesure du débit d'analyse).");
+    QCommandLineOption balloonOption("balloon", "Indicatifs de la nacelle, séparés par des virgules.", "indicatifs",
+                                     APRSParser::DEFAULT_BALLOON_CALLSIGN);
+    parser.addOptions({sqliteOption, threadsOption, offsetOption, dateOption, dryRunOption, balloonOption});
+    parser.process(app);
+
+    options.sqlitePath = parser.value(sqliteOption);
+    options.files = parser.positionalArguments();
+    options.threads = parser.value(threadsOption).toInt();
+    options.utcOffset = parser.value(offsetOption).toInt();
+    options.dryRun = parser.isSet(dryRunOption);
+    Frame::setBalloonCallsigns(parser.value(balloonOption));
+    if (parser.isSet(dateOption)) {
+        QDateTime date = QDateTime::fromString(parser.value(dateOption), Qt::ISODate);
+        if (!date.isValid()) {
+            std::fprintf(stderr, "Date invalide : %s\n", qPrintable(parser.value(dateOption)));
+            return false;
+        }
+        options.defaultDate = date.toMSecsSinceEpoch();
+    }
+    if (options.files.isEmpty() || options.threads < 0) {
+        parser.showHelp(EXIT_FAILURE);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Importe un journal.
+ *
+ * @return bool @c false si le fichier est illisible ou si le support est perdu.
+ */
+bool importFile(const QString &path, const Options &options, StorageBackend *backend, RecentFrames &recent, Stats &stats)
+{
+    int fd = open(QFile::encodeName(path).constData(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        std::perror(qPrintable(path));
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+    if (info.st_size == 0) {
+        close(fd);
+        return true;
+    }
+    const std::size_t size = static_cast<std::size_t>(info.st_size);
+    void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        std::perror("mmap");
+        return false;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    const qint64 defaultDate = options.defaultDate >= 0 ? options.defaultDate
+                                                        : static_cast<qint64>(info.st_mtime) * 1000;
+    const int slices = QThreadPool::globalInstance()->maxThreadCount();
+    const char *begin = static_cast<const char *>(map);
+    const char *end = begin + size;
+
+    // La fenêtre suivante est analysée pendant l'écriture de la fenêtre courante
+    const char *next = windowEnd(begin, end);
+    std::vector<QFuture<Parsed>> current = parseWindow(begin, next, slices, options, defaultDate);
+    bool ok = true;
+    while (!current.empty()) {
+        std::vector<QFuture<Parsed>> following;
+        if (next < end) {
+            const char *after = windowEnd(next, end);
+            following = parseWindow(next, after, slices, options, defaultDate);
+            next = after;
+        }
+        if (!writeWindow(backend, current, recent, stats)) {
+            std::fprintf(stderr, "Support %s perdu\n", qPrintable(backend->name()));
+            ok = false;
+            next = end;
+        }
+        for (QFuture<Parsed> &future : current)
+            future.waitForFinished();
+        current = ok ? std::move(following) : std::vector<QFuture<Parsed>>();
+        if (!ok) {
+            for (QFuture<Parsed> &future : following)
+                future.waitForFinished();
+        }
+    }
+
+    munmap(map, size);
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    Options options;
+    if (!parseArguments(app, options))
+        return EXIT_FAILURE;
+    if (options.threads > 0)
+        QThreadPool::globalInstance()->setMaxThreadCount(options.threads);
+
+    std::unique_ptr<StorageBackend> backend;
+    if (!options.dryRun) {
+        if (options.sqlitePath.isEmpty())
+            backend = std::make_unique<MySQLManager>();
+        else
+            backend = std::make_unique<SQLiteStorage>(options.sqlitePath);
+        if (!backend->openConnection())
+            return EXIT_FAILURE;
+    }
+
+    RecentFrames recent;
+    Stats stats;
+    bool ok = true;
+    const Clock::time_point start = Clock::now();
+    for (const QString &path : std::as_const(options.files)) {
+        const Clock::time_point fileStart = Clock::now();
+        const long before = stats.lines;
+        ok = importFile(path, options, backend.get(), recent, stats) && ok;
+        double elapsed = std::chrono::duration<double>(Clock::now() - fileStart).count();
+        std::fprintf(stderr, "%s : %ld lignes en %.2f s (%.0f lignes/s)\n", qPrintable(path),
+                     stats.lines - before, elapsed, elapsed > 0.0 ? (stats.lines - before) / elapsed : 0.0);
+        if (!ok && backend && !backend->ping())
+            break;
+    }
+
+    double total = std::chrono::duration<double>(Clock::now() - start).count();
+    std::fprintf(stderr, "%ld lignes en %.2f s (%.0f lignes/s) : %ld trames %s, %ld doublons, "
+                         "%ld refusees, %ld invalides, %ld commentaires\n",
+                 stats.lines, total, total > 0.0 ? stats.lines / total : 0.0, stats.written,
+                 options.dryRun ? "analysees" : "transmises", stats.duplicates, stats.rejected,
+                 stats.invalid, stats.skipped);
+    if (backend)
+        backend->closeConnection();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
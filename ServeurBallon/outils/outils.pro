@@ -0,0 +1,10 @@
+# Outils de mise au point et de mesure de ServeurBallon
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    benchaprs \
+    exportvol \
+    fauxaprsis \
+    importlog \
+    redecodage \
+    simutnc
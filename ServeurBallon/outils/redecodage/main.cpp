@@ -0,0 +1,341 @@
+/**
+ * @file main.cpp
+ * @brief Redécodage parallèle des trames historiques.
+ *
+ * Relit la table trames par tranches de clé primaire ("WHERE trame > dernière clé ORDER BY trame
+ * LIMIT n"), décode chaque tranche sur le pool de threads avec les décodeurs du serveur
+ * (Frame::fromTNC2, donc APRSParser) et écrit les résultats dans la table decodages par insertions
+ * groupées de plusieurs lignes (49 avec SQLite, dont les versions antérieures à 3.32 limitent une
+ * requête à 999 paramètres, 200 avec MySQL). La lecture de la tranche suivante se fait pendant le décodage de
+ * la tranche courante.
+ *
+ * Chaque tranche est écrite dans une transaction qui met aussi à jour le point de reprise (table
+ * reprises) : un arrêt à n'importe quel moment (Ctrl-C, coupure) reprend à la première tranche
+ * non validée. Le débit est bridé (--max-rate) pour laisser la base disponible à l'écriture
+ * en direct de ServeurBallon.
+ *
+ * Exemple :
+ *   ./redecodage --sqlite Ballon2025.sqlite --threads 4 --max-rate 50000
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "frame.h"
+#include "framedecoding.h"
+#include "mysqlmanager.h"
+#include "sqlitestorage.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int BATCH_ROWS = 200;     ///< Lignes par requête d'insertion groupée (MySQL).
+constexpr int SQLITE_MAX_VARIABLES = 999; ///< Paramètres par requête admis par SQLite avant 3.32.
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void onSignal(int)
+{
+    g_stop = 1;
+}
+
+/**
+ * @brief Paramètres du redécodage.
+ */
+struct Options {
+    QString sqlitePath;             ///< Base SQLite à traiter (sinon la base MySQL).
+    int chunk = 5000;               ///< Trames par tranche (et par transaction).
+    int threads = 0;                ///< Threads de décodage (0 : nombre de cœurs).
+    double maxRate = 20000.0;       ///< Débit maximal en trames/s (0 : illimité).
+    QString name;                   ///< Nom du point de reprise.
+    bool restart = false;           ///< Ignore le point de reprise existant.
+};
+
+/**
+ * @brief Trame lue, en attente de décodage puis d'écriture.
+ */
+struct Row {
+    QByteArray tnc2;                ///< Trame TNC2 (clé primaire de trames).
+    qint64 timestamp = 0;           ///< Date de réception (ms).
+    FramePtr frame;                 ///< Trame décodée (nulle si la ligne est invalide).
+};
+
+using Chunk = std::vector<Row>;
+
+/**
+ * @brief Décode une trame (exécuté sur le pool de threads).
+ */
+void decodeRow(Row &row)
+{
+    row.frame = Frame::fromTNC2(std::string_view(row.tnc2.constData(), static_cast<std::size_t>(row.tnc2.size())),
+                                row.timestamp);
+}
+
+bool parseArguments(const QCoreApplication &app, Options &options)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Redécodage des trames historiques vers la table decodages");
+    parser.addHelpOption();
+
+    QCommandLineOption sqliteOption("sqlite", "Base SQLite à traiter (par défaut : base MySQL).", "fichier");
+    QCommandLineOption chunkOption("chunk", "Trames par tranche et par transaction.", "n", QString::number(options.chunk));
+    QCommandLineOption threadsOption("threads", "Threads de décodage (0 : nombre de cœurs).", "n", "0");
+    QCommandLineOption rateOption("max-rate", "Débit maximal en trames/s (0 : illimité).", "n",
+                                  QString::number(options.maxRate));
+    QCommandLineOption nameOption("name", "Nom du point de reprise.", "nom",
+                                  QString("redecodage-v%1").arg(FrameDecoding::VERSION));
+    QCommandLineOption restartOption("restart", "Reprend depuis la première trame.");
+    QCommandLineOption balloonOption("balloon", "Indicatifs de la nacelle, séparés par des virgules.", "indicatifs",
+                                     APRSParser::DEFAULT_BALLOON_CALLSIGN);
+    parser.addOptions({sqliteOption, chunkOption, threadsOption, rateOption, nameOption, restartOption, balloonOption});
+    parser.process(app);
+
+    options.sqlitePath = parser.value(sqliteOption);
+    options.chunk = parser.value(chunkOption).toInt();
+    options.threads = parser.value(threadsOption).toInt();
+    options.maxRate = parser.value(rateOption).toDouble();
+    options.name = parser.value(nameOption);
+    options.restart = parser.isSet(restartOption);
+    Frame::setBalloonCallsigns(parser.value(balloonOption));
+    if (options.chunk <= 0 || options.threads < 0 || options.maxRate < 0.0 || options.name.isEmpty()) {
+        std::fprintf(stderr, "Option invalide\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Redécodeur : lecture par tranches, décodage parallèle, écriture groupée et point de reprise.
+ */
+class Backfill {
+public:
+    Backfill(QSqlDatabase db, const Options &options)
+        : m_db(db),
+        m_options(options),
+        m_read(db),
+        m_batch(db),
+        m_checkpoint(db)
+    {
+    }
+
+    /**
+     * @brief Prépare les requêtes et lit le point de reprise.
+     */
+    bool prepare()
+    {
+        m_read.setForwardOnly(true);
+        const bool sqlite = (m_db.driverName() == QLatin1String("QSQLITE"));
+        m_batchRows = sqlite ? SQLITE_MAX_VARIABLES / FrameDecoding::COLUMN_COUNT : BATCH_ROWS;
+        bool ok = m_read.prepare("SELECT trame, date_reception FROM trames WHERE trame > ? ORDER BY trame LIMIT ?")
+                  && m_batch.prepare(FrameDecoding::insertStatement(m_db.driverName(), m_batchRows))
+                  && m_checkpoint.prepare(sqlite
+                        ? "INSERT OR REPLACE INTO reprises (nom, derniere_trame, lignes, date_maj) VALUES (?, ?, ?, ?)"
+                        : "INSERT INTO reprises (nom, derniere_trame, lignes, date_maj) VALUES (?, ?, ?, ?) "
+                          "ON DUPLICATE KEY UPDATE derniere_trame = VALUES(derniere_trame), "
+                          "lignes = VALUES(lignes), date_maj = VALUES(date_maj)");
+        if (!ok) {
+            for (const QSqlQuery *query : {&m_read, &m_batch, &m_checkpoint}) {
+                if (query->lastError().isValid())
+                    std::fprintf(stderr, "Preparation impossible : %s\n", qPrintable(query->lastError().text()));
+            }
+            return false;
+        }
+        if (m_options.restart)
+            return true;
+
+        QSqlQuery query(m_db);
+        query.prepare("SELECT derniere_trame, lignes FROM reprises WHERE nom = ?");
+        query.addBindValue(m_options.name);
+        if (query.exec() && query.next()) {
+            m_lastKey = query.value(0).toString();
+            m_processed = query.value(1).toLongLong();
+            std::fprintf(stderr, "Reprise apres %lld trames (point de reprise %s)\n",
+                         m_processed, qPrintable(m_options.name));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Traite toutes les tranches restantes.
+     *
+     * @return bool @c false en cas d'erreur de lecture ou d'écriture.
+     */
+    bool run()
+    {
+        const Clock::time_point start = Clock::now();
+        long long done = 0;
+
+        Chunk current;
+        if (!readChunk(m_lastKey, current))
+            return false;
+        while (!current.empty() && !g_stop) {
+            QFuture<void> decoding = QtConcurrent::map(current, decodeRow);
+
+            Chunk next;
+            bool readOk = readChunk(QString::fromLatin1(current.back().tnc2), next);
+            decoding.waitForFinished();
+            if (!readOk || !writeChunk(current))
+                return false;
+
+            done += static_cast<long long>(current.size());
+            double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            std::fprintf(stderr, "%lld trames traitees (%lld decodees), %.0f trames/s\n",
+                         m_processed, m_decoded, elapsed > 0.0 ? done / elapsed : 0.0);
+
+            // Bridage : attend si le débit moyen dépasse --max-rate
+            if (m_options.maxRate > 0.0) {
+                double ahead = done / m_options.maxRate - elapsed;
+                if (ahead > 0.0)
+                    QThread::msleep(static_cast<unsigned long>(ahead * 1000.0));
+            }
+            current = std::move(next);
+        }
+
+        double total = std::chrono::duration<double>(Clock::now() - start).count();
+        std::fprintf(stderr, "%s : %lld trames en %.1f s (%.0f trames/s), %lld decodages ecrits\n",
+                     g_stop ? "Interrompu" : "Termine", done, total, total > 0.0 ? done / total : 0.0, m_decoded);
+        return true;
+    }
+
+private:
+    /**
+     * @brief Lit la tranche de trames suivant une clé.
+     */
+    bool readChunk(const QString &after, Chunk &chunk)
+    {
+        m_read.bindValue(0, after);
+        m_read.bindValue(1, m_options.chunk);
+        if (!m_read.exec()) {
+            std::fprintf(stderr, "Erreur de lecture : %s\n", qPrintable(m_read.lastError().text()));
+            return false;
+        }
+        chunk.reserve(static_cast<std::size_t>(m_options.chunk));
+        while (m_read.next()) {
+            Row row;
+            row.tnc2 = m_read.value(0).toString().toLatin1();
+            row.timestamp = m_read.value(1).toDateTime().toMSecsSinceEpoch();
+            chunk.push_back(std::move(row));
+        }
+        m_read.finish();
+        return true;
+    }
+
+    /**
+     * @brief Écrit les décodages d'une tranche et le point de reprise dans une transaction.
+     */
+    bool writeChunk(const Chunk &chunk)
+    {
+        if (!m_db.transaction())
+            return fail(m_db.lastError().text());
+
+        std::vector<const Frame *> decoded;
+        decoded.reserve(chunk.size());
+        for (const Row &row : chunk) {
+            if (row.frame && FrameDecoding::isDecoded(*row.frame))
+                decoded.push_back(row.frame.data());
+        }
+
+        std::size_t i = 0;
+        const std::size_t batchRows = static_cast<std::size_t>(m_batchRows);
+        for (; i + batchRows <= decoded.size(); i += batchRows) {
+            for (int r = 0; r < m_batchRows; ++r)
+                FrameDecoding::bindValues(m_batch, r, *decoded[i + static_cast<std::size_t>(r)], m_db.driverName());
+            if (!m_batch.exec())
+                return fail(m_batch.lastError().text());
+        }
+        if (i < decoded.size()) {
+            QSqlQuery tail(m_db);
+            if (!tail.prepare(FrameDecoding::insertStatement(m_db.driverName(), static_cast<int>(decoded.size() - i))))
+                return fail(tail.lastError().text());
+            for (int r = 0; i + static_cast<std::size_t>(r) < decoded.size(); ++r)
+                FrameDecoding::bindValues(tail, r, *decoded[i + static_cast<std::size_t>(r)], m_db.driverName());
+            if (!tail.exec())
+                return fail(tail.lastError().text());
+        }
+
+        m_checkpoint.bindValue(0, m_options.name);
+        m_checkpoint.bindValue(1, QString::fromLatin1(chunk.back().tnc2));
+        m_checkpoint.bindValue(2, m_processed + static_cast<long long>(chunk.size()));
+        m_checkpoint.bindValue(3, QDateTime::currentDateTime());
+        if (!m_checkpoint.exec())
+            return fail(m_checkpoint.lastError().text());
+        if (!m_db.commit())
+            return fail(m_db.lastError().text());
+
+        m_processed += static_cast<long long>(chunk.size());
+        m_decoded += static_cast<long long>(decoded.size());
+        return true;
+    }
+
+    /**
+     * @brief Annule la transaction en cours et affiche l'erreur.
+     */
+    bool fail(const QString &error)
+    {
+        m_db.rollback();
+        std::fprintf(stderr, "Erreur d'ecriture : %s\n", qPrintable(error));
+        return false;
+    }
+
+    QSqlDatabase m_db;
+    Options m_options;
+    QSqlQuery m_read;               ///< Lecture d'une tranche de trames.
+    QSqlQuery m_batch;              ///< Insertion de m_batchRows décodages.
+    int m_batchRows = BATCH_ROWS;   ///< Lignes par insertion groupée, bornées par le nombre de paramètres du pilote.
+    QSqlQuery m_checkpoint;         ///< Mise à jour du point de reprise.
+    QString m_lastKey;              ///< Dernière trame traitée (point de reprise).
+    long long m_processed = 0;      ///< Trames traitées depuis le début du redécodage.
+    long long m_decoded = 0;        ///< Décodages écrits pendant cette exécution.
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    Options options;
+    if (!parseArguments(app, options))
+        return EXIT_FAILURE;
+    if (options.threads > 0)
+        QThreadPool::globalInstance()->setMaxThreadCount(options.threads);
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    // Les supports créent les tables decodages et reprises si nécessaire (SQLite)
+    std::unique_ptr<SQLiteStorage> sqlite;
+    std::unique_ptr<MySQLManager> mysql;
+    QSqlDatabase db;
+    if (options.sqlitePath.isEmpty()) {
+        mysql = std::make_unique<MySQLManager>();
+        if (!mysql->openConnection())
+            return EXIT_FAILURE;
+        db = mysql->database();
+    } else {
+        sqlite = std::make_unique<SQLiteStorage>(options.sqlitePath);
+        if (!sqlite->openConnection())
+            return EXIT_FAILURE;
+        db = sqlite->database();
+    }
+
+    bool ok = false;
+    {
+        Backfill backfill(db, options);
+        ok = backfill.prepare() && backfill.run();
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,33 @@
+TEMPLATE = app
+QT = core sql concurrent
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+# Redécodage parallèle des trames historiques (table trames vers table decodages)
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    ../../aprsparser.cpp \
+    ../../ax25converter.cpp \
+    ../../callsigntable.cpp \
+    ../../flightstateengine.cpp \
+    ../../frame.cpp \
+    ../../framedecoding.cpp \
+    ../../landingpredictor.cpp \
+    ../../mysqlmanager.cpp \
+    ../../sqlitestorage.cpp \
+    ../../stationstate.cpp
+
+HEADERS += \
+    ../../aprsparser.h \
+    ../../ax25converter.h \
+    ../../callsigntable.h \
+    ../../flightstateengine.h \
+    ../../frame.h \
+    ../../framedecoding.h \
+    ../../landingpredictor.h \
+    ../../mysqlmanager.h \
+    ../../sqlitestorage.h \
+    ../../stationstate.h \
+    ../../storagebackend.h
@@ -0,0 +1,459 @@
+/**
+ * @file main.cpp
+ * @brief Simulateur de TNC KISS sur pseudo-terminal.
+ *
+ * Ouvre une paire de pseudo-terminaux et émet sur le côté maître un trafic AX.25 encapsulé
+ * en KISS, comme le ferait le modem LoRa. Le côté esclave (affiché au démarrage, ou exposé via
+ * un lien symbolique) s'ouvre dans ServeurBallon comme un vrai port série.
+ *
+ * Le profil de trafic est configurable : débit, distribution des tailles, proportion d'octets
+ * nécessitant un échappement KISS, nombre de stations sources et rafales. Tout ce que le serveur
+ * renvoie vers le TNC est enregistré avec un horodatage.
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <random>
+#include <string>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr unsigned char FEND  = 0xC0;
+constexpr unsigned char FESC  = 0xDB;
+constexpr unsigned char TFEND = 0xDC;
+constexpr unsigned char TFESC = 0xDD;
+
+volatile std::sig_atomic_t g_stop = 0;
+
+/**
+ * @brief Profil de trafic simulé.
+ */
+struct Profile {
+    double rate = 10.0;         ///< Trames par seconde (hors rafales).
+    int sizeMin = 20;           ///< Taille minimale du champ d'information (octets).
+    int sizeMax = 120;          ///< Taille maximale du champ d'information (octets).
+    double escape = 0.0;        ///< Probabilité qu'un octet de remplissage soit 0xC0 ou 0xDB.
+    int sources = 1;            ///< Nombre de stations sources distinctes.
+    int burstSize = 0;          ///< Nombre de trames par rafale (0 : pas de rafale).
+    double burstPeriod = 10.0;  ///< Intervalle entre deux rafales (s).
+    double duration = 0.0;      ///< Durée de la simulation (s, 0 : illimitée).
+    long count = 0;             ///< Nombre de trames à émettre (0 : illimité).
+    unsigned seed = 0;          ///< Graine du générateur (0 : aléatoire).
+    std::string link;           ///< Lien symbolique vers le pseudo-terminal esclave.
+    std::string record;         ///< Fichier d'enregistrement des trames renvoyées par le serveur.
+};
+
+/**
+ * @brief Statistiques de la simulation.
+ */
+struct Stats {
+    long framesSent = 0;
+    long bytesSent = 0;
+    long framesDropped = 0;
+    long framesReceived = 0;
+    long bytesReceived = 0;
+};
+
+void onSignal(int)
+{
+    g_stop = 1;
+}
+
+std::int64_t nowMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Code un indicatif ("CALL-SSID") en adresse AX.25 sur 7 octets.
+ */
+void appendAddress(std::vector<unsigned char> &out, const std::string &callsign, bool last)
+{
+    std::string call = callsign;
+    int ssid = 0;
+    std::size_t dash = callsign.find('-');
+    if (dash != std::string::npos) {
+        call = callsign.substr(0, dash);
+        ssid = std::atoi(callsign.c_str() + dash + 1);
+    }
+    for (int i = 0; i < 6; ++i) {
+        char c = (i < static_cast<int>(call.size())) ? call[i] : ' ';
+        out.push_back(static_cast<unsigned char>(c << 1));
+    }
+    out.push_back(static_cast<unsigned char>(0x60 | ((ssid & 0x0F) << 1) | (last ? 0x01 : 0x00)));
+}
+
+/**
+ * @brief Décode une adresse AX.25 sur 7 octets.
+ */
+std::string decodeAddress(const unsigned char *addr)
+{
+    std::string call;
+    for (int i = 0; i < 6; ++i) {
+        char c = static_cast<char>(addr[i] >> 1);
+        if (c != ' ')
+            call += c;
+    }
+    int ssid = (addr[6] >> 1) & 0x0F;
+    if (ssid != 0)
+        call += "-" + std::to_string(ssid);
+    return call;
+}
+
+/**
+ * @brief Construit le champ d'information APRS d'une trame simulée.
+ *
+ * Le début du champ est une trame APRS valide (position, télémétrie ou message) portant un
+ * numéro de séquence et l'heure d'émission, complétée jusqu'à la taille tirée au sort.
+ */
+std::string buildInfo(long sequence, int size, const Profile &profile, std::mt19937 &rng)
+{
+    char head[128];
+    std::int64_t t = nowMicros();
+    switch (sequence % 3) {
+    case 0:
+        std::snprintf(head, sizeof(head), "!4542.%02ldN/00451.%02ldEO/A=%06ld seq=%ld t=%lld ",
+                      sequence % 100, (sequence / 100) % 100, (sequence * 7) % 100000,
+                      sequence, static_cast<long long>(t));
+        break;
+    case 1:
+        std::snprintf(head, sizeof(head), "T#%03ld,%ld,%ld,%ld,%ld,%ld,01010101 t=%lld ",
+                      sequence % 1000, sequence % 256, (sequence * 3) % 256, (sequence * 5) % 256,
+                      (sequence * 7) % 256, (sequence * 11) % 256, static_cast<long long>(t));
+        break;
+    default:
+        std::snprintf(head, sizeof(head), ":F4KMN-8  :QSA? seq=%ld t=%lld{%ld",
+                      sequence, static_cast<long long>(t), sequence % 100000);
+        break;
+    }
+
+    std::string info(head);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> printable(0x20, 0x7E);
+    while (static_cast<int>(info.size()) < size) {
+        if (profile.escape > 0.0 && unit(rng) < profile.escape)
+            info += static_cast<char>((unit(rng) < 0.5) ? FEND : FESC);
+        else
+            info += static_cast<char>(printable(rng));
+    }
+    return info;
+}
+
+/**
+ * @brief Construit une trame KISS complète (port 0) à partir d'une trame AX.25 UI.
+ */
+std::vector<unsigned char> buildKissFrame(const std::string &source, const std::string &info)
+{
+    std::vector<unsigned char> ax25;
+    appendAddress(ax25, "APLT00", false);
+    appendAddress(ax25, source, true);
+    ax25.push_back(0x03);
+    ax25.push_back(0xF0);
+    ax25.insert(ax25.end(), info.begin(), info.end());
+
+    std::vector<unsigned char> kiss;
+    kiss.reserve(ax25.size() * 2 + 3);
+    kiss.push_back(FEND);
+    kiss.push_back(0x00);
+    for (unsigned char b : ax25) {
+        if (b == FEND) {
+            kiss.push_back(FESC);
+            kiss.push_back(TFEND);
+        } else if (b == FESC) {
+            kiss.push_back(FESC);
+            kiss.push_back(TFESC);
+        } else {
+            kiss.push_back(b);
+        }
+    }
+    kiss.push_back(FEND);
+    return kiss;
+}
+
+/**
+ * @brief Décodeur KISS incrémental des données renvoyées par le serveur.
+ */
+class KissRecorder {
+public:
+    KissRecorder(FILE *file, Stats &stats) : m_file(file), m_stats(stats) { }
+
+    void feed(const unsigned char *data, std::size_t size)
+    {
+        std::int64_t t = nowMicros();
+        for (std::size_t i = 0; i < size; ++i) {
+            unsigned char c = data[i];
+            if (c == FEND) {
+                if (m_inFrame && !m_frame.empty())
+                    record(t);
+                m_frame.clear();
+                m_inFrame = true;
+                m_escape = false;
+            } else if (!m_inFrame) {
+                continue;
+            } else if (c == FESC) {
+                m_escape = true;
+            } else if (m_escape) {
+                m_frame.push_back((c == TFEND) ? FEND : (c == TFESC) ? FESC : c);
+                m_escape = false;
+            } else {
+                m_frame.push_back(c);
+            }
+        }
+    }
+
+private:
+    void record(std::int64_t t)
+    {
+        ++m_stats.framesReceived;
+        if (!m_file)
+            return;
+        std::string text;
+        // Port KISS, puis au moins deux adresses, contrôle et PID
+        if (m_frame.size() >= 17) {
+            std::size_t offset = 1;
+            while (offset + 7 <= m_frame.size() && !(m_frame[offset + 6] & 0x01))
+                offset += 7;
+            offset += 7 + 2;
+            if (offset <= m_frame.size()) {
+                text = decodeAddress(&m_frame[8]) + ">" + decodeAddress(&m_frame[1]) + ":";
+                text.append(reinterpret_cast<const char *>(m_frame.data() + offset), m_frame.size() - offset);
+            }
+        }
+        std::fprintf(m_file, "%lld %zu ", static_cast<long long>(t), m_frame.size());
+        for (unsigned char b : m_frame)
+            std::fprintf(m_file, "%02x", b);
+        std::fprintf(m_file, " %s\n", text.c_str());
+        std::fflush(m_file);
+    }
+
+    FILE *m_file;
+    Stats &m_stats;
+    std::vector<unsigned char> m_frame;
+    bool m_inFrame = false;
+    bool m_escape = false;
+};
+
+void usage(const char *program)
+{
+    std::fprintf(stderr,
+                 "Usage : %s [options]\n"
+                 "  -r, --rate N          trames par seconde (defaut 10)\n"
+                 "  -s, --size MIN:MAX    taille du champ d'information en octets (defaut 20:120)\n"
+                 "  -e, --escape P        probabilite d'octet 0xC0/0xDB dans le remplissage (defaut 0)\n"
+                 "  -n, --sources N       nombre de stations sources F4SIM-1..N (defaut 1)\n"
+                 "  -b, --burst N:PERIODE rafale de N trames toutes les PERIODE secondes\n"
+                 "  -d, --duration S      duree de la simulation en secondes (defaut illimitee)\n"
+                 "  -c, --count N         nombre de trames a emettre (defaut illimite)\n"
+                 "  -l, --link CHEMIN     lien symbolique vers le pseudo-terminal esclave\n"
+                 "  -o, --record FICHIER  enregistre les trames renvoyees par le serveur\n"
+                 "  -S, --seed N          graine du generateur aleatoire\n",
+                 program);
+}
+
+bool parseArguments(int argc, char *argv[], Profile &profile)
+{
+    static const option options[] = {
+        {"rate", required_argument, nullptr, 'r'},
+        {"size", required_argument, nullptr, 's'},
+        {"escape", required_argument, nullptr, 'e'},
+        {"sources", required_argument, nullptr, 'n'},
+        {"burst", required_argument, nullptr, 'b'},
+        {"duration", required_argument, nullptr, 'd'},
+        {"count", required_argument, nullptr, 'c'},
+        {"link", required_argument, nullptr, 'l'},
+        {"record", required_argument, nullptr, 'o'},
+        {"seed", required_argument, nullptr, 'S'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "r:s:e:n:b:d:c:l:o:S:h", options, nullptr)) != -1) {
+        switch (opt) {
+        case 'r': profile.rate = std::atof(optarg); break;
+        case 's':
+            if (std::sscanf(optarg, "%d:%d", &profile.sizeMin, &profile.sizeMax) != 2)
+                return false;
+            break;
+        case 'e': profile.escape = std::atof(optarg); break;
+        case 'n': profile.sources = std::atoi(optarg); break;
+        case 'b':
+            if (std::sscanf(optarg, "%d:%lf", &profile.burstSize, &profile.burstPeriod) != 2)
+                return false;
+            break;
+        case 'd': profile.duration = std::atof(optarg); break;
+        case 'c': profile.count = std::atol(optarg); break;
+        case 'l': profile.link = optarg; break;
+        case 'o': profile.record = optarg; break;
+        case 'S': profile.seed = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+        default: return false;
+        }
+    }
+    return profile.rate > 0.0 && profile.sizeMin > 0 && profile.sizeMax >= profile.sizeMin
+           && profile.sources > 0 && profile.burstPeriod > 0.0;
+}
+
+/**
+ * @brief Ouvre la paire de pseudo-terminaux et configure l'esclave en mode brut.
+ *
+ * Le simulateur garde lui-même l'esclave ouvert pour que la lecture du maître ne retourne pas
+ * EIO tant que le serveur ne l'a pas encore ouvert.
+ */
+bool openPty(int &master, int &slave, std::string &slaveName)
+{
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+        return false;
+    const char *name = ptsname(master);
+    if (!name)
+        return false;
+    slaveName = name;
+
+    slave = open(name, O_RDWR | O_NOCTTY);
+    if (slave < 0)
+        return false;
+    termios tio;
+    if (tcgetattr(slave, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B9600);
+        cfsetospeed(&tio, B9600);
+        tcsetattr(slave, TCSANOW, &tio);
+    }
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Profile profile;
+    if (!parseArguments(argc, argv, profile)) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int master, slave;
+    std::string slaveName;
+    if (!openPty(master, slave, slaveName)) {
+        std::perror("Erreur ouverture pseudo-terminal");
+        return EXIT_FAILURE;
+    }
+    if (!profile.link.empty()) {
+        unlink(profile.link.c_str());
+        if (symlink(slaveName.c_str(), profile.link.c_str()) != 0)
+            std::perror("Erreur creation du lien symbolique");
+    }
+
+    FILE *recordFile = nullptr;
+    if (!profile.record.empty()) {
+        recordFile = std::fopen(profile.record.c_str(), "w");
+        if (!recordFile) {
+            std::perror("Erreur ouverture du fichier d'enregistrement");
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    std::printf("TNC simule sur %s%s%s\n", slaveName.c_str(),
+                profile.link.empty() ? "" : " -> ", profile.link.c_str());
+    std::printf("Profil : %.1f trames/s, taille %d..%d, echappement %.2f, %d source(s), rafales %d/%.1fs\n",
+                profile.rate, profile.sizeMin, profile.sizeMax, profile.escape, profile.sources,
+                profile.burstSize, profile.burstPeriod);
+    std::fflush(stdout);
+
+    std::mt19937 rng(profile.seed ? profile.seed : std::random_device{}());
+    std::uniform_int_distribution<int> sizeDist(profile.sizeMin, profile.sizeMax);
+    std::uniform_int_distribution<int> sourceDist(1, profile.sources);
+
+    Stats stats;
+    KissRecorder recorder(recordFile, stats);
+    std::vector<unsigned char> pending;
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / profile.rate));
+    const auto burstPeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(profile.burstPeriod));
+    auto nextFrame = start;
+    auto nextBurst = start + burstPeriod;
+    long sequence = 0;
+    unsigned char buffer[4096];
+
+    while (!g_stop) {
+        auto now = Clock::now();
+        if (profile.duration > 0.0 && now - start >= std::chrono::duration<double>(profile.duration))
+            break;
+        if (profile.count > 0 && sequence >= profile.count && pending.empty())
+            break;
+
+        // Génération des trames échues (trafic régulier et rafales)
+        int due = 0;
+        while (now >= nextFrame) {
+            ++due;
+            nextFrame += period;
+        }
+        if (profile.burstSize > 0 && now >= nextBurst) {
+            due += profile.burstSize;
+            nextBurst += burstPeriod;
+        }
+        for (int i = 0; i < due && (profile.count == 0 || sequence < profile.count); ++i) {
+            std::string source = "F4SIM-" + std::to_string(sourceDist(rng));
+            std::vector<unsigned char> frame = buildKissFrame(source, buildInfo(sequence++, sizeDist(rng), profile, rng));
+            // Le tampon du pseudo-terminal est plein : le serveur ne suit pas, la trame est perdue
+            if (pending.size() > 65536) {
+                ++stats.framesDropped;
+                continue;
+            }
+            pending.insert(pending.end(), frame.begin(), frame.end());
+            ++stats.framesSent;
+            stats.bytesSent += static_cast<long>(frame.size());
+        }
+
+        if (!pending.empty()) {
+            ssize_t written = write(master, pending.data(), pending.size());
+            if (written > 0)
+                pending.erase(pending.begin(), pending.begin() + written);
+            else if (written < 0 && errno != EAGAIN && errno != EINTR)
+                break;
+        }
+
+        // Attente de la prochaine échéance en lisant ce que le serveur renvoie
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(nextFrame - Clock::now()).count();
+        pollfd pfd = {master, static_cast<short>(POLLIN | (pending.empty() ? 0 : POLLOUT)), 0};
+        if (poll(&pfd, 1, static_cast<int>(wait < 0 ? 0 : wait)) > 0 && (pfd.revents & POLLIN)) {
+            ssize_t n;
+            while ((n = read(master, buffer, sizeof(buffer))) > 0) {
+                stats.bytesReceived += n;
+                recorder.feed(buffer, static_cast<std::size_t>(n));
+            }
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    std::printf("\n%ld trames emises (%ld octets) en %.1f s : %.1f trames/s, %ld perdues\n",
+                stats.framesSent, stats.bytesSent, elapsed, stats.framesSent / elapsed, stats.framesDropped);
+    std::printf("%ld trames recues du serveur (%ld octets)\n", stats.framesReceived, stats.bytesReceived);
+
+    if (recordFile)
+        std::fclose(recordFile);
+    if (!profile.link.empty())
+        unlink(profile.link.c_str());
+    close(slave);
+    close(master);
+    return EXIT_SUCCESS;
+}
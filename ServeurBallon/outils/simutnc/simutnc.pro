@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+# Simulateur de TNC KISS sur pseudo-terminal (POSIX, sans dépendance Qt)
+SOURCES += \
+    main.cpp
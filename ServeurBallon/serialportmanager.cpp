@@ -1,4 +1,5 @@
 #include "serialportmanager.h"
+#include "tracer.h"
 #include <QDebug>
 #include <QSerialPortInfo>
 
@@ -32,7 +33,7 @@ SerialPortManager::SerialPortManager(QObject *parent)
  *
  * @return QStringList Liste des noms de ports disponibles.
  */
-QStringList SerialPortManager::availablePorts() const
+QStringList SerialPortManager::availablePorts()
 {
     QStringList ports;
     for (const QSerialPortInfo &info : QSerialPortInfo::availablePorts())
@@ -98,7 +99,11 @@ void SerialPortManager::closePort()
  */
 void SerialPortManager::onReadyRead()
 {
-    QByteArray data = m_serial.readAll();
+    QByteArray data;
+    {
+        TraceSpan span("lecture serie");
+        data = m_serial.readAll();
+    }
     emit dataReceived(data);
 }
 
@@ -38,10 +38,11 @@ public:
      * @brief Retourne la liste des ports série disponibles.
      *
      * Parcourt la liste des ports accessibles via QSerialPortInfo et retourne leurs noms.
+     * Peut être appelée depuis un autre thread (énumération en arrière-plan).
      *
      * @return QStringList Liste des noms de ports disponibles.
      */
-    QStringList availablePorts() const;
+    static QStringList availablePorts();
 
     /**
      * @brief Ouvre le port série spécifié.
@@ -0,0 +1,404 @@
+#include "sqlitestorage.h"
+#include "frame.h"
+#include "framedecoding.h"
+#include "flightstateengine.h"
+#include "landingpredictor.h"
+#include "stationstate.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QSqlError>
+
+/**
+ * @file sqlitestorage.cpp
+ * @brief Implémentation de la classe SQLiteStorage.
+ *
+ * Ce fichier contient l'ouverture de la base SQLite (mode WAL), la création du schéma commun
+ * avec la base MySQL et les insertions préparées.
+ */
+
+namespace {
+
+/**
+ * @brief Schéma de la base, identique à celui de BDD/Ballon2025.sql.
+ */
+const char *const SCHEMA[] = {
+    "CREATE TABLE IF NOT EXISTS machines ("
+    " indicatif varchar(10) NOT NULL PRIMARY KEY,"
+    " description varchar(255) DEFAULT NULL)",
+
+    "CREATE TABLE IF NOT EXISTS trames ("
+    " source varchar(255) NOT NULL,"
+    " destination varchar(255) NOT NULL,"
+    " trame varchar(100) NOT NULL PRIMARY KEY,"
+    " message text,"
+    " date_reception datetime NOT NULL DEFAULT CURRENT_TIMESTAMP)",
+    "CREATE INDEX IF NOT EXISTS idx_trames_date ON trames (date_reception)",
+    "CREATE INDEX IF NOT EXISTS idx_trames_source_date ON trames (source, date_reception)",
+
+    "CREATE TABLE IF NOT EXISTS evenements ("
+    " indicatif varchar(10) NOT NULL,"
+    " type varchar(16) NOT NULL,"
+    " date_evenement datetime(3) NOT NULL,"
+    " altitude double DEFAULT NULL,"
+    " latitude double DEFAULT NULL,"
+    " longitude double DEFAULT NULL,"
+    " vitesse_verticale double DEFAULT NULL,"
+    " PRIMARY KEY (indicatif, type, date_evenement))",
+
+    "CREATE TABLE IF NOT EXISTS predictions ("
+    " indicatif varchar(10) NOT NULL,"
+    " date_calcul datetime(3) NOT NULL,"
+    " latitude double NOT NULL,"
+    " longitude double NOT NULL,"
+    " date_atterrissage datetime(3) NOT NULL,"
+    " altitude double DEFAULT NULL,"
+    " vitesse_descente double DEFAULT NULL,"
+    " PRIMARY KEY (indicatif, date_calcul))",
+
+    "CREATE TABLE IF NOT EXISTS decodages ("
+    " trame varchar(100) NOT NULL PRIMARY KEY,"
+    " source varchar(255) NOT NULL,"
+    " date_reception datetime NOT NULL,"
+    " type varchar(16) NOT NULL,"
+    " latitude double DEFAULT NULL,"
+    " longitude double DEFAULT NULL,"
+    " altitude double DEFAULT NULL,"
+    " vitesse double DEFAULT NULL,"
+    " cap int DEFAULT NULL,"
+    " sequence int DEFAULT NULL,"
+    " a1 double DEFAULT NULL,"
+    " a2 double DEFAULT NULL,"
+    " a3 double DEFAULT NULL,"
+    " a4 double DEFAULT NULL,"
+    " a5 double DEFAULT NULL,"
+    " bits int DEFAULT NULL,"
+    " temperature double DEFAULT NULL,"
+    " pression double DEFAULT NULL,"
+    " humidite int DEFAULT NULL,"
+    " version int NOT NULL)",
+    "CREATE INDEX IF NOT EXISTS idx_decodages_source_date ON decodages (source, date_reception)",
+
+    "CREATE TABLE IF NOT EXISTS reprises ("
+    " nom varchar(64) NOT NULL PRIMARY KEY,"
+    " derniere_trame varchar(100) NOT NULL,"
+    " lignes bigint NOT NULL DEFAULT 0,"
+    " date_maj datetime NOT NULL)",
+
+    "CREATE TABLE IF NOT EXISTS station_state ("
+    " indicatif varchar(10) NOT NULL PRIMARY KEY,"
+    " trames bigint NOT NULL DEFAULT 0,"
+    " date_trame datetime(3) DEFAULT NULL,"
+    " derniere_trame text,"
+    " type varchar(16) DEFAULT NULL,"
+    " date_position datetime(3) DEFAULT NULL,"
+    " latitude double DEFAULT NULL,"
+    " longitude double DEFAULT NULL,"
+    " altitude double DEFAULT NULL,"
+    " vitesse double DEFAULT NULL,"
+    " cap int DEFAULT NULL,"
+    " date_telemetrie datetime(3) DEFAULT NULL,"
+    " sequence int DEFAULT NULL,"
+    " a1 double DEFAULT NULL,"
+    " a2 double DEFAULT NULL,"
+    " a3 double DEFAULT NULL,"
+    " a4 double DEFAULT NULL,"
+    " a5 double DEFAULT NULL,"
+    " bits int DEFAULT NULL,"
+    " date_meteo datetime(3) DEFAULT NULL,"
+    " temperature double DEFAULT NULL,"
+    " pression double DEFAULT NULL,"
+    " humidite int DEFAULT NULL)",
+};
+
+/**
+ * @brief Exécute une requête et journalise l'erreur éventuelle.
+ */
+bool execLogged(QSqlQuery &query, const char *context)
+{
+    if (query.exec())
+        return true;
+    qDebug() << "Erreur SQLite" << context << ":" << query.lastError().text();
+    return false;
+}
+
+} // namespace
+
+/**
+ * @brief Constructeur de la classe SQLiteStorage.
+ *
+ * Enregistre une connexion QSQLITE nommée d'après le fichier, sans l'ouvrir.
+ *
+ * @param path Chemin du fichier de base de données.
+ */
+SQLiteStorage::SQLiteStorage(const QString &path)
+    : m_path(path),
+    m_connectionName("sqlite:" + path)
+{
+    m_db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    m_db.setDatabaseName(m_path);
+    // Attend la fin d'une écriture concurrente (outils d'import ou de redécodage) au lieu d'échouer
+    m_db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+}
+
+/**
+ * @brief Destructeur de la classe SQLiteStorage.
+ *
+ * Ferme la base et retire la connexion de la liste des connexions Qt.
+ */
+SQLiteStorage::~SQLiteStorage()
+{
+    closeConnection();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+/**
+ * @brief Retourne le nom du support.
+ *
+ * @return QString "SQLite".
+ */
+QString SQLiteStorage::name() const
+{
+    return QStringLiteral("SQLite");
+}
+
+/**
+ * @brief Ouvre la base et la configure.
+ *
+ * Active le mode WAL et une synchronisation NORMAL (sûre en mode WAL, seule la dernière
+ * transaction peut être perdue en cas de coupure d'alimentation), puis crée le schéma.
+ *
+ * @return bool @c true si la base est prête, @c false sinon.
+ */
+bool SQLiteStorage::openConnection()
+{
+    if (!m_db.open()) {
+        qDebug() << "Erreur d'ouverture SQLite:" << m_db.lastError().text();
+        return false;
+    }
+
+    QSqlQuery pragma(m_db);
+    pragma.exec("PRAGMA journal_mode=WAL");
+    pragma.exec("PRAGMA synchronous=NORMAL");
+    pragma.exec("PRAGMA foreign_keys=OFF");
+
+    if (!createSchema()) {
+        closeConnection();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Ferme la base.
+ *
+ * Les requêtes préparées sont libérées avant la fermeture.
+ */
+void SQLiteStorage::closeConnection()
+{
+    m_machineQuery = QSqlQuery();
+    m_frameQuery = QSqlQuery();
+    m_decodingQuery = QSqlQuery();
+    m_eventQuery = QSqlQuery();
+    m_predictionQuery = QSqlQuery();
+    m_stationQuery = QSqlQuery();
+    m_knownMachines.clear();
+    if (m_db.isOpen())
+        m_db.close();
+}
+
+/**
+ * @brief Vérifie que la base est ouverte.
+ *
+ * @return bool @c true si la base est ouverte, @c false sinon.
+ */
+bool SQLiteStorage::ping()
+{
+    return m_db.isOpen();
+}
+
+/**
+ * @brief Ouvre une transaction.
+ *
+ * @return bool @c true si la transaction est ouverte, @c false sinon.
+ */
+bool SQLiteStorage::beginBatch()
+{
+    return m_db.transaction();
+}
+
+/**
+ * @brief Valide la transaction en cours.
+ *
+ * @return bool @c true si la transaction est validée, @c false sinon.
+ */
+bool SQLiteStorage::commitBatch()
+{
+    return m_db.commit();
+}
+
+/**
+ * @brief Annule la transaction en cours.
+ *
+ * Les machines insérées pendant la transaction sont annulées avec elle : le cache des machines
+ * connues est vidé.
+ */
+void SQLiteStorage::rollbackBatch()
+{
+    m_db.rollback();
+    m_knownMachines.clear();
+}
+
+/**
+ * @brief Crée les tables si nécessaire et prépare les requêtes d'insertion.
+ *
+ * @return bool @c true en cas de succès, @c false sinon.
+ */
+bool SQLiteStorage::createSchema()
+{
+    QSqlQuery query(m_db);
+    for (const char *statement : SCHEMA) {
+        if (!query.exec(statement)) {
+            qDebug() << "Erreur de création du schéma SQLite:" << query.lastError().text();
+            return false;
+        }
+    }
+
+    m_machineQuery = QSqlQuery(m_db);
+    m_frameQuery = QSqlQuery(m_db);
+    m_decodingQuery = QSqlQuery(m_db);
+    m_eventQuery = QSqlQuery(m_db);
+    m_predictionQuery = QSqlQuery(m_db);
+    m_stationQuery = QSqlQuery(m_db);
+    return m_machineQuery.prepare("INSERT OR IGNORE INTO machines (indicatif, description) "
+                                  "VALUES (?, 'Machine ajoutée automatiquement')")
+           && m_frameQuery.prepare("INSERT OR IGNORE INTO trames (source, destination, trame, message, date_reception) "
+                                   "VALUES (?, ?, ?, ?, ?)")
+           && m_decodingQuery.prepare(FrameDecoding::insertStatement(m_db.driverName(), 1))
+           && m_eventQuery.prepare("INSERT OR IGNORE INTO evenements (indicatif, type, date_evenement, altitude, latitude, longitude, vitesse_verticale) "
+                                   "VALUES (?, ?, ?, ?, ?, ?, ?)")
+           && m_predictionQuery.prepare("INSERT OR IGNORE INTO predictions (indicatif, date_calcul, latitude, longitude, date_atterrissage, altitude, vitesse_descente) "
+                                        "VALUES (?, ?, ?, ?, ?, ?, ?)")
+           && m_stationQuery.prepare(StationState::upsertStatement(m_db.driverName()));
+}
+
+/**
+ * @brief Ajoute une machine si elle n'a pas encore été vue.
+ *
+ * @param id L'identifiant de l'indicatif.
+ * @return bool @c true en cas de succès, @c false sinon.
+ */
+bool SQLiteStorage::ensureMachine(CallsignId id)
+{
+    if (m_knownMachines.contains(id))
+        return true;
+    m_machineQuery.bindValue(0, CallsignTable::name(id));
+    if (!execLogged(m_machineQuery, "insertMachine"))
+        return false;
+    m_knownMachines.insert(id);
+    return true;
+}
+
+/**
+ * @brief Insère une trame et, si elle a été reconnue, son décodage APRS.
+ *
+ * @param frame La trame à enregistrer.
+ * @return bool @c true si la trame a été insérée (ou existait déjà), même si son décodage a été
+ *         refusé, @c false sinon.
+ */
+bool SQLiteStorage::insertFrame(const Frame &frame)
+{
+    if (!ensureMachine(frame.source()) || !ensureMachine(frame.destination()))
+        return false;
+    m_frameQuery.bindValue(0, frame.sourceName());
+    m_frameQuery.bindValue(1, frame.destinationName());
+    m_frameQuery.bindValue(2, FrameDecoding::key(frame, m_db.driverName()));
+    m_frameQuery.bindValue(3, Frame::toString(frame.message()));
+    m_frameQuery.bindValue(4, QDateTime::fromMSecsSinceEpoch(frame.timestamp()));
+    if (!execLogged(m_frameQuery, "insertFrame"))
+        return false;
+    if (!FrameDecoding::isDecoded(frame))
+        return true;
+    // Un décodage refusé ne coûte pas la trame : redecodage pourra le réécrire
+    FrameDecoding::bindValues(m_decodingQuery, 0, frame, m_db.driverName());
+    execLogged(m_decodingQuery, "insertDecoding");
+    return true;
+}
+
+/**
+ * @brief Insère un événement de vol.
+ *
+ * @param event L'événement à enregistrer.
+ * @return bool @c true si l'insertion a réussi, @c false sinon.
+ */
+bool SQLiteStorage::insertFlightEvent(const FlightEvent &event)
+{
+    m_eventQuery.bindValue(0, event.callsign);
+    m_eventQuery.bindValue(1, FlightStateEngine::eventName(event.type));
+    m_eventQuery.bindValue(2, QDateTime::fromMSecsSinceEpoch(event.timestamp));
+    m_eventQuery.bindValue(3, event.altitude);
+    m_eventQuery.bindValue(4, event.latitude);
+    m_eventQuery.bindValue(5, event.longitude);
+    m_eventQuery.bindValue(6, event.verticalRate);
+    return execLogged(m_eventQuery, "insertFlightEvent");
+}
+
+/**
+ * @brief Insère une prédiction d'atterrissage.
+ *
+ * @param prediction La prédiction à enregistrer.
+ * @return bool @c true si l'insertion a réussi, @c false sinon.
+ */
+bool SQLiteStorage::insertLandingPrediction(const LandingPrediction &prediction)
+{
+    m_predictionQuery.bindValue(0, prediction.callsign);
+    m_predictionQuery.bindValue(1, QDateTime::fromMSecsSinceEpoch(prediction.timestamp));
+    m_predictionQuery.bindValue(2, prediction.latitude);
+    m_predictionQuery.bindValue(3, prediction.longitude);
+    m_predictionQuery.bindValue(4, QDateTime::fromMSecsSinceEpoch(prediction.landingTime));
+    m_predictionQuery.bindValue(5, prediction.altitude);
+    m_predictionQuery.bindValue(6, prediction.descentRate);
+    return execLogged(m_predictionQuery, "insertLandingPrediction");
+}
+
+/**
+ * @brief Insère ou remplace le dernier état connu d'une station.
+ *
+ * @param state L'état à enregistrer.
+ * @return bool @c true si l'écriture a réussi, @c false sinon.
+ */
+bool SQLiteStorage::upsertStationState(const StationState &state)
+{
+    state.bindValues(m_stationQuery);
+    return execLogged(m_stationQuery, "upsertStationState");
+}
+
+/**
+ * @brief Relit les derniers états connus de toutes les stations.
+ *
+ * @param states Les états lus.
+ * @return bool @c true si la lecture a réussi, @c false sinon.
+ */
+bool SQLiteStorage::loadStationStates(QVector<StationState> &states)
+{
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    if (!query.exec(StationState::selectStatement())) {
+        qDebug() << "Erreur SQLite loadStationStates :" << query.lastError().text();
+        return false;
+    }
+    while (query.next())
+        states.append(StationState::fromQuery(query));
+    return true;
+}
+
+/**
+ * @brief Retourne la connexion à la base.
+ *
+ * @return QSqlDatabase La connexion SQLite.
+ */
+QSqlDatabase SQLiteStorage::database() const
+{
+    return m_db;
+}
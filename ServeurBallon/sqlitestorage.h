@@ -0,0 +1,88 @@
+#ifndef SQLITESTORAGE_H
+#define SQLITESTORAGE_H
+
+/**
+ * @file sqlitestorage.h
+ * @brief Déclaration de la classe SQLiteStorage.
+ *
+ * Ce fichier définit le support de stockage local SQLite : un fichier de base embarqué, au même
+ * schéma que la base MySQL, utilisable sans aucune connectivité réseau.
+ */
+
+#pragma once
+
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+
+#include "callsigntable.h"
+#include "storagebackend.h"
+
+/**
+ * @brief Support de stockage SQLite embarqué.
+ *
+ * La base est ouverte en mode WAL (écritures sans blocage des lecteurs, synchronisation allégée)
+ * et le schéma (machines, trames, decodages, evenements, predictions, reprises, station_state) est créé s'il n'existe pas.
+ * Les requêtes d'insertion sont préparées une seule fois ; les doublons de clé primaire
+ * sont ignorés.
+ */
+class SQLiteStorage : public StorageBackend {
+public:
+    /**
+     * @brief Constructeur de la classe SQLiteStorage.
+     * @param path Chemin du fichier de base de données.
+     */
+    explicit SQLiteStorage(const QString &path);
+
+    /**
+     * @brief Destructeur : ferme la base et libère la connexion.
+     */
+    ~SQLiteStorage() override;
+
+    QString name() const override;
+    bool openConnection() override;
+    void closeConnection() override;
+    bool ping() override;
+    bool beginBatch() override;
+    bool commitBatch() override;
+    void rollbackBatch() override;
+    bool insertFrame(const Frame &frame) override;
+    bool insertFlightEvent(const FlightEvent &event) override;
+    bool insertLandingPrediction(const LandingPrediction &prediction) override;
+    bool upsertStationState(const StationState &state) override;
+    bool loadStationStates(QVector<StationState> &states) override;
+
+    /**
+     * @brief Retourne la connexion à la base, pour les outils qui la lisent directement.
+     * @return QSqlDatabase La connexion SQLite.
+     */
+    QSqlDatabase database() const;
+
+private:
+    /**
+     * @brief Crée les tables si nécessaire et prépare les requêtes d'insertion.
+     * @return bool @c true en cas de succès, @c false sinon.
+     */
+    bool createSchema();
+
+    /**
+     * @brief Ajoute une machine si elle n'a pas encore été vue.
+     * @param id L'identifiant de l'indicatif.
+     * @return bool @c true en cas de succès, @c false sinon.
+     */
+    bool ensureMachine(CallsignId id);
+
+    QString m_path;                   ///< Chemin du fichier de base.
+    QString m_connectionName;         ///< Nom de la connexion QSqlDatabase.
+    QSqlDatabase m_db;                ///< Connexion SQLite.
+    QSqlQuery m_machineQuery;         ///< Insertion d'une machine.
+    QSqlQuery m_frameQuery;           ///< Insertion d'une trame.
+    QSqlQuery m_decodingQuery;        ///< Insertion du décodage d'une trame.
+    QSqlQuery m_eventQuery;           ///< Insertion d'un événement de vol.
+    QSqlQuery m_predictionQuery;      ///< Insertion d'une prédiction.
+    QSqlQuery m_stationQuery;         ///< Insertion ou remplacement de l'état d'une station.
+    QSet<CallsignId> m_knownMachines; ///< Indicatifs déjà présents dans la table machines.
+};
+
+#endif // SQLITESTORAGE_H
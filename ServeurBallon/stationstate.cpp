@@ -0,0 +1,261 @@
+#include "stationstate.h"
+#include "frame.h"
+
+#include <QDateTime>
+#include <QVariant>
+
+/**
+ * @file stationstate.cpp
+ * @brief Implémentation de la structure StationState.
+ *
+ * Ce fichier contient la mise à jour de l'état d'une station par ses trames, la fusion avec
+ * l'état relu depuis la base et la correspondance avec les colonnes de la table station_state.
+ */
+
+namespace {
+
+/**
+ * @brief Colonnes de la table station_state, dans l'ordre de liaison et de lecture.
+ */
+const char *const COLUMNS[StationState::COLUMN_COUNT] = {
+    "indicatif", "trames", "date_trame", "derniere_trame", "type",
+    "date_position", "latitude", "longitude", "altitude", "vitesse", "cap",
+    "date_telemetrie", "sequence", "a1", "a2", "a3", "a4", "a5", "bits",
+    "date_meteo", "temperature", "pression", "humidite"
+};
+
+/**
+ * @brief Retourne la valeur si elle est présente, NULL sinon.
+ */
+template <typename T>
+QVariant optional(bool present, T value)
+{
+    return present ? QVariant(value) : QVariant();
+}
+
+/**
+ * @brief Retourne une date (ms) si elle est connue, NULL sinon.
+ */
+QVariant optionalDate(qint64 time)
+{
+    return time > 0 ? QVariant(QDateTime::fromMSecsSinceEpoch(time)) : QVariant();
+}
+
+/**
+ * @brief Retourne la date (ms) d'une colonne, 0 si elle est NULL.
+ */
+qint64 dateValue(const QSqlQuery &query, int column)
+{
+    const QVariant value = query.value(column);
+    return value.isNull() ? 0 : value.toDateTime().toMSecsSinceEpoch();
+}
+
+} // namespace
+
+/**
+ * @brief Met l'état à jour avec une trame de la station.
+ *
+ * Le compteur de trames est toujours incrémenté ; chaque partie de l'état n'est remplacée que par
+ * une information au moins aussi récente. Les mesures météo peuvent accompagner une position
+ * ou un bulletin météo.
+ *
+ * @param frame La trame.
+ */
+void StationState::update(const Frame &frame)
+{
+    const qint64 time = frame.timestamp();
+    ++frameCount;
+    const APRSPacket *packet = frame.packet();
+    if (time >= frameTime) {
+        frameTime = time;
+        lastFrame = Frame::toString(frame.tnc2());
+        lastType = QString::fromLatin1(APRSParser::typeName(packet ? packet->type : APRSPacketType::Unknown));
+    }
+    if (!packet)
+        return;
+
+    if ((packet->type == APRSPacketType::Position || packet->type == APRSPacketType::MicE) && time >= positionTime) {
+        const APRSPosition &position = packet->position;
+        positionTime = time;
+        latitude = position.latitude;
+        longitude = position.longitude;
+        altitude = position.altitude;
+        hasAltitude = position.hasAltitude;
+        speed = position.speed;
+        course = position.course;
+        hasCourseSpeed = position.hasCourseSpeed;
+    }
+    if ((packet->type == APRSPacketType::Telemetry || packet->telemetry.compressed) && time >= telemetryTime) {
+        telemetryTime = time;
+        telemetry = packet->telemetry;
+    }
+    const APRSWeather &measures = packet->weather;
+    if ((measures.hasTemperature || measures.hasPressure || measures.hasHumidity) && time >= weatherTime) {
+        weatherTime = time;
+        weather = measures;
+    }
+}
+
+/**
+ * @brief Complète l'état avec un autre état de la même station.
+ *
+ * Chaque partie est prise dans l'état le plus récent ; les compteurs de trames s'additionnent
+ * (l'autre état couvre les trames enregistrées avant le lancement).
+ *
+ * @param other L'autre état.
+ */
+void StationState::merge(const StationState &other)
+{
+    frameCount += other.frameCount;
+    if (other.frameTime > frameTime) {
+        frameTime = other.frameTime;
+        lastFrame = other.lastFrame;
+        lastType = other.lastType;
+    }
+    if (other.positionTime > positionTime) {
+        positionTime = other.positionTime;
+        latitude = other.latitude;
+        longitude = other.longitude;
+        altitude = other.altitude;
+        hasAltitude = other.hasAltitude;
+        speed = other.speed;
+        course = other.course;
+        hasCourseSpeed = other.hasCourseSpeed;
+    }
+    if (other.telemetryTime > telemetryTime) {
+        telemetryTime = other.telemetryTime;
+        telemetry = other.telemetry;
+    }
+    if (other.weatherTime > weatherTime) {
+        weatherTime = other.weatherTime;
+        weather = other.weather;
+    }
+}
+
+/**
+ * @brief Construit la requête d'insertion ou de remplacement d'un état.
+ *
+ * "INSERT OR REPLACE" avec SQLite, "ON DUPLICATE KEY UPDATE" avec MySQL : la ligne de la station
+ * est entièrement réécrite.
+ *
+ * @param driverName Nom du pilote Qt.
+ * @return QString La requête.
+ */
+QString StationState::upsertStatement(const QString &driverName)
+{
+    const bool sqlite = (driverName == QLatin1String("QSQLITE"));
+
+    QString columns;
+    QString update;
+    for (int i = 0; i < COLUMN_COUNT; ++i) {
+        if (i > 0)
+            columns += ", ";
+        columns += COLUMNS[i];
+        if (i > 0) {
+            if (i > 1)
+                update += ", ";
+            update += QString("%1 = VALUES(%1)").arg(COLUMNS[i]);
+        }
+    }
+
+    QString sql = sqlite ? "INSERT OR REPLACE INTO station_state (" : "INSERT INTO station_state (";
+    sql += columns + ") VALUES (?" + QString(", ?").repeated(COLUMN_COUNT - 1) + ")";
+    if (!sqlite)
+        sql += " ON DUPLICATE KEY UPDATE " + update;
+    return sql;
+}
+
+/**
+ * @brief Retourne la requête de lecture de tous les états.
+ *
+ * @return QString La requête.
+ */
+QString StationState::selectStatement()
+{
+    QString columns;
+    for (int i = 0; i < COLUMN_COUNT; ++i) {
+        if (i > 0)
+            columns += ", ";
+        columns += COLUMNS[i];
+    }
+    return "SELECT " + columns + " FROM station_state";
+}
+
+/**
+ * @brief Lie les valeurs de l'état à la requête d'insertion.
+ *
+ * @param query La requête préparée.
+ */
+void StationState::bindValues(QSqlQuery &query) const
+{
+    const bool hasPosition = positionTime > 0;
+    const bool hasTelemetry = telemetryTime > 0;
+    const bool hasWeather = weatherTime > 0;
+
+    query.bindValue(0, callsign);
+    query.bindValue(1, frameCount);
+    query.bindValue(2, optionalDate(frameTime));
+    query.bindValue(3, lastFrame);
+    query.bindValue(4, lastType);
+    query.bindValue(5, optionalDate(positionTime));
+    query.bindValue(6, optional(hasPosition, latitude));
+    query.bindValue(7, optional(hasPosition, longitude));
+    query.bindValue(8, optional(hasPosition && hasAltitude, altitude));
+    query.bindValue(9, optional(hasPosition && hasCourseSpeed, speed));
+    query.bindValue(10, optional(hasPosition && hasCourseSpeed, course));
+    query.bindValue(11, optionalDate(telemetryTime));
+    query.bindValue(12, optional(hasTelemetry && telemetry.sequence >= 0, telemetry.sequence));
+    for (int i = 0; i < APRSTelemetry::MAX_ANALOG; ++i)
+        query.bindValue(13 + i, optional(hasTelemetry && i < telemetry.analogCount, telemetry.analog[i]));
+    query.bindValue(18, optional(hasTelemetry && telemetry.hasDigital, int(telemetry.digital)));
+    query.bindValue(19, optionalDate(weatherTime));
+    query.bindValue(20, optional(hasWeather && weather.hasTemperature, weather.temperature));
+    query.bindValue(21, optional(hasWeather && weather.hasPressure, weather.pressure));
+    query.bindValue(22, optional(hasWeather && weather.hasHumidity, weather.humidity));
+}
+
+/**
+ * @brief Construit un état depuis la ligne courante d'une requête selectStatement().
+ *
+ * Les voies analogiques sont relues jusqu'à la première valeur NULL.
+ *
+ * @param query La requête positionnée sur une ligne.
+ * @return StationState L'état lu.
+ */
+StationState StationState::fromQuery(const QSqlQuery &query)
+{
+    StationState state;
+    state.callsign = query.value(0).toString();
+    state.frameCount = query.value(1).toLongLong();
+    state.frameTime = dateValue(query, 2);
+    state.lastFrame = query.value(3).toString();
+    state.lastType = query.value(4).toString();
+
+    state.positionTime = dateValue(query, 5);
+    state.latitude = query.value(6).toDouble();
+    state.longitude = query.value(7).toDouble();
+    state.hasAltitude = !query.value(8).isNull();
+    state.altitude = query.value(8).toDouble();
+    state.hasCourseSpeed = !query.value(9).isNull() && !query.value(10).isNull();
+    state.speed = query.value(9).toDouble();
+    state.course = query.value(10).toInt();
+
+    state.telemetryTime = dateValue(query, 11);
+    state.telemetry.sequence = query.value(12).isNull() ? -1 : query.value(12).toInt();
+    while (state.telemetry.analogCount < APRSTelemetry::MAX_ANALOG
+           && !query.value(13 + state.telemetry.analogCount).isNull()) {
+        state.telemetry.analog[state.telemetry.analogCount] = query.value(13 + state.telemetry.analogCount).toDouble();
+        ++state.telemetry.analogCount;
+    }
+    state.telemetry.hasDigital = !query.value(18).isNull();
+    state.telemetry.digital = static_cast<std::uint8_t>(query.value(18).toInt());
+
+    state.weatherTime = dateValue(query, 19);
+    state.weather.hasTemperature = !query.value(20).isNull();
+    state.weather.temperature = query.value(20).toDouble();
+    state.weather.hasPressure = !query.value(21).isNull();
+    state.weather.pressure = query.value(21).toDouble();
+    state.weather.hasHumidity = !query.value(22).isNull();
+    state.weather.humidity = query.value(22).toInt();
+    return state;
+}
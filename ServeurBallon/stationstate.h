@@ -0,0 +1,92 @@
+#ifndef STATIONSTATE_H
+#define STATIONSTATE_H
+
+/**
+ * @file stationstate.h
+ * @brief Déclaration de la structure StationState.
+ *
+ * Ce fichier définit le dernier état connu d'une station (dernière trame, position, télémétrie,
+ * météo), tenu à jour en mémoire à chaque trame reçue et recopié dans la table station_state :
+ * l'état courant d'une machine s'obtient par une simple lecture de clé primaire.
+ */
+
+#pragma once
+
+#include <QSqlQuery>
+#include <QString>
+
+#include "aprsparser.h"
+
+class Frame;
+
+/**
+ * @brief Dernier état connu d'une station.
+ *
+ * Chaque partie de l'état (trame, position, télémétrie, météo) porte sa propre date : une trame
+ * de télémétrie ne fait pas oublier la dernière position, et une trame plus ancienne (reçue
+ * en retard) ne remplace pas une information plus récente. Une date à 0 indique une partie
+ * encore inconnue, enregistrée à NULL.
+ */
+struct StationState {
+    static constexpr int COLUMN_COUNT = 23; ///< Nombre de colonnes de la table station_state.
+
+    QString callsign;                ///< Indicatif de la station (clé primaire).
+    qint64 frameCount = 0;           ///< Nombre de trames reçues de la station.
+    qint64 frameTime = 0;            ///< Date de la dernière trame (ms).
+    QString lastFrame;               ///< Dernière trame au format TNC2.
+    QString lastType;                ///< Type APRS de la dernière trame.
+
+    qint64 positionTime = 0;         ///< Date de la dernière position (ms, 0 : inconnue).
+    double latitude = 0.0;           ///< Latitude en degrés.
+    double longitude = 0.0;          ///< Longitude en degrés.
+    double altitude = 0.0;           ///< Altitude en mètres (valide si hasAltitude).
+    double speed = 0.0;              ///< Vitesse en km/h (valide si hasCourseSpeed).
+    int course = 0;                  ///< Cap en degrés (valide si hasCourseSpeed).
+    bool hasAltitude = false;        ///< Indique si l'altitude est connue.
+    bool hasCourseSpeed = false;     ///< Indique si le cap et la vitesse sont connus.
+
+    qint64 telemetryTime = 0;        ///< Date de la dernière télémétrie (ms, 0 : inconnue).
+    APRSTelemetry telemetry;         ///< Dernière télémétrie.
+
+    qint64 weatherTime = 0;          ///< Date des dernières mesures météo (ms, 0 : inconnues).
+    APRSWeather weather;             ///< Dernières mesures météo.
+
+    /**
+     * @brief Met l'état à jour avec une trame de la station.
+     * @param frame La trame (sa source doit être cette station).
+     */
+    void update(const Frame &frame);
+
+    /**
+     * @brief Complète l'état avec un autre état de la même station, partie par partie, en gardant la plus récente.
+     * @param other L'autre état (par exemple relu depuis la base).
+     */
+    void merge(const StationState &other);
+
+    /**
+     * @brief Construit la requête d'insertion ou de remplacement d'un état.
+     * @param driverName Nom du pilote Qt ("QMYSQL", "QSQLITE"), pour la syntaxe de remplacement.
+     * @return QString La requête, avec COLUMN_COUNT paramètres positionnels.
+     */
+    static QString upsertStatement(const QString &driverName);
+
+    /**
+     * @brief Retourne la requête de lecture de tous les états (colonnes dans l'ordre de fromQuery()).
+     */
+    static QString selectStatement();
+
+    /**
+     * @brief Lie les valeurs de l'état à la requête d'insertion.
+     * @param query La requête préparée avec upsertStatement().
+     */
+    void bindValues(QSqlQuery &query) const;
+
+    /**
+     * @brief Construit un état depuis la ligne courante d'une requête selectStatement().
+     * @param query La requête positionnée sur une ligne.
+     * @return StationState L'état lu.
+     */
+    static StationState fromQuery(const QSqlQuery &query);
+};
+
+#endif // STATIONSTATE_H
@@ -0,0 +1,109 @@
+#ifndef STORAGEBACKEND_H
+#define STORAGEBACKEND_H
+
+/**
+ * @file storagebackend.h
+ * @brief Déclaration de l'interface StorageBackend.
+ *
+ * Ce fichier définit l'interface commune des supports de stockage (MySQL distant, SQLite local).
+ * L'écrivain de base de données (DatabaseWriter) diffuse chaque écriture vers tous les supports
+ * configurés, chacun avec son propre état de santé.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+class Frame;
+struct FlightEvent;
+struct LandingPrediction;
+struct StationState;
+
+/**
+ * @brief Interface d'un support de stockage.
+ *
+ * Toutes les méthodes sont appelées depuis le thread de l'écrivain de base de données, qui est aussi
+ * celui dans lequel le support a été créé. Les écritures sont regroupées par l'écrivain entre
+ * beginBatch() et commitBatch().
+ */
+class StorageBackend {
+public:
+    virtual ~StorageBackend() = default;
+
+    /**
+     * @brief Retourne le nom du support, pour l'affichage ("MySQL", "SQLite").
+     */
+    virtual QString name() const = 0;
+
+    /**
+     * @brief Ouvre la connexion au support.
+     * @return bool @c true si la connexion est établie, @c false sinon.
+     */
+    virtual bool openConnection() = 0;
+
+    /**
+     * @brief Ferme la connexion au support.
+     */
+    virtual void closeConnection() = 0;
+
+    /**
+     * @brief Vérifie que le support répond encore.
+     * @return bool @c true si le support a répondu, @c false sinon.
+     */
+    virtual bool ping() = 0;
+
+    /**
+     * @brief Ouvre une transaction regroupant les écritures suivantes.
+     * @return bool @c true si la transaction est ouverte, @c false sinon.
+     */
+    virtual bool beginBatch() = 0;
+
+    /**
+     * @brief Valide la transaction ouverte par beginBatch().
+     * @return bool @c true si la transaction est validée, @c false sinon.
+     */
+    virtual bool commitBatch() = 0;
+
+    /**
+     * @brief Annule la transaction ouverte par beginBatch().
+     */
+    virtual void rollbackBatch() = 0;
+
+    /**
+     * @brief Insère une trame.
+     * @param frame La trame à enregistrer.
+     * @return bool @c true si l'insertion a réussi, @c false sinon.
+     */
+    virtual bool insertFrame(const Frame &frame) = 0;
+
+    /**
+     * @brief Insère un événement de vol.
+     * @param event L'événement à enregistrer.
+     * @return bool @c true si l'insertion a réussi, @c false sinon.
+     */
+    virtual bool insertFlightEvent(const FlightEvent &event) = 0;
+
+    /**
+     * @brief Insère une prédiction d'atterrissage.
+     * @param prediction La prédiction à enregistrer.
+     * @return bool @c true si l'insertion a réussi, @c false sinon.
+     */
+    virtual bool insertLandingPrediction(const LandingPrediction &prediction) = 0;
+
+    /**
+     * @brief Insère ou remplace le dernier état connu d'une station (table station_state).
+     * @param state L'état à enregistrer.
+     * @return bool @c true si l'écriture a réussi, @c false sinon.
+     */
+    virtual bool upsertStationState(const StationState &state) = 0;
+
+    /**
+     * @brief Relit les derniers états connus de toutes les stations.
+     * @param states Les états lus.
+     * @return bool @c true si la lecture a réussi, @c false sinon.
+     */
+    virtual bool loadStationStates(QVector<StationState> &states) = 0;
+};
+
+#endif // STORAGEBACKEND_H
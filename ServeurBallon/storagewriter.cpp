@@ -0,0 +1,535 @@
+#include "storagewriter.h"
+#include "storagebackend.h"
+#include "tracer.h"
+
+#include <utility>
+
+/**
+ * @file storagewriter.cpp
+ * @brief Implémentation de la classe StorageWriter.
+ *
+ * Ce fichier contient la connexion asynchrone d'un support, la mise en attente bornée des écritures
+ * et leur écriture groupée en transactions.
+ */
+
+/**
+ * @brief Constructeur de la classe StorageWriter.
+ *
+ * Le support n'est pas encore créé : il doit l'être dans le thread de l'écrivain (voir start()),
+ * une connexion QSqlDatabase n'étant utilisable que depuis son thread de création.
+ *
+ * @param factory Fonction créant le support.
+ * @param parent Pointeur vers l'objet parent (par défaut nullptr).
+ */
+StorageWriter::StorageWriter(BackendFactory factory, QObject *parent)
+    : QObject(parent),
+    m_factory(std::move(factory)),
+    m_reconnectTimer(this),
+    m_flushTimer(this),
+    m_stationTimer(this)
+{
+    m_reconnectTimer.setSingleShot(true);
+    connect(&m_reconnectTimer, &QTimer::timeout, this, &StorageWriter::connectBackend);
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, &StorageWriter::flush);
+    m_stationTimer.setSingleShot(true);
+    m_stationTimer.setInterval(STATION_DEBOUNCE);
+    connect(&m_stationTimer, &QTimer::timeout, this, &StorageWriter::publishStations);
+}
+
+/**
+ * @brief Destructeur de la classe StorageWriter.
+ *
+ * Le support a normalement déjà été fermé et détruit par stop(), dans le thread de l'écrivain.
+ */
+StorageWriter::~StorageWriter() = default;
+
+/**
+ * @brief Crée le support et lance sa première connexion.
+ */
+void StorageWriter::start()
+{
+    if (m_backend)
+        return;
+    m_backend.reset(m_factory());
+    m_name = m_backend->name();
+    Tracer::setThreadName("base de donnees " + m_name);
+    connectBackend();
+}
+
+/**
+ * @brief Écrit les éléments en attente puis ferme et détruit le support.
+ *
+ * Les derniers états de station sont publiés avant l'écriture. La connexion est détruite dans
+ * ce thread, celui de sa création.
+ */
+void StorageWriter::stop()
+{
+    if (!m_backend)
+        return;
+    m_reconnectTimer.stop();
+    publishStations();
+    flush();
+    m_backend->closeConnection();
+    m_backend.reset();
+}
+
+/**
+ * @brief Tente d'ouvrir la connexion du support.
+ *
+ * En cas de succès, le délai de reconnexion est réinitialisé et les files en attente sont écrites ;
+ * sinon une nouvelle tentative est programmée. L'ouverture peut bloquer (jusqu'au délai de
+ * connexion de MySQL) : seul le thread de ce support attend.
+ */
+void StorageWriter::connectBackend()
+{
+    setState(DatabaseState::Connecting);
+    if (!m_backend->openConnection()) {
+        setState(DatabaseState::Unavailable);
+        scheduleReconnect();
+        return;
+    }
+    m_reconnectDelay = MIN_RECONNECT_DELAY;
+    m_state = DatabaseState::Connected;
+    seedStations();
+    flushPending();
+    if (m_state == DatabaseState::Connected)
+        setState(DatabaseState::Connected);
+}
+
+/**
+ * @brief Complète les états en mémoire avec ceux enregistrés sur le support.
+ *
+ * N'a lieu qu'une fois, à la première connexion (ou à la première écriture suivante si la lecture
+ * échoue). Chaque état relu est fusionné partie par partie avec celui des trames reçues depuis le
+ * lancement. Les états en attente sont remplacés par l'état fusionné : aucune ligne de station_state
+ * n'est réécrite avec des compteurs remis à zéro ou des parties inconnues.
+ */
+void StorageWriter::seedStations()
+{
+    if (m_stationsSeeded)
+        return;
+    QVector<StationState> states;
+    if (!m_backend->loadStationStates(states))
+        return;
+    m_stationsSeeded = true;
+    for (const StationState &state : std::as_const(states)) {
+        QByteArray name = state.callsign.toLatin1();
+        CallsignId id = CallsignTable::intern(std::string_view(name.constData(), static_cast<std::size_t>(name.size())));
+        if (id == CallsignTable::NONE)
+            continue;
+        auto it = m_stations.find(id);
+        if (it == m_stations.end())
+            m_stations.insert(id, state);
+        else
+            it->merge(state);
+    }
+    for (auto it = m_pendingStations.begin(); it != m_pendingStations.end(); ++it)
+        *it = m_stations.value(it.key());
+    emit logMessage(QString("Base %1 : état de %2 station(s) relu.").arg(m_name).arg(states.size()));
+}
+
+/**
+ * @brief Indique s'il reste des éléments à écrire.
+ *
+ * Les états de station attendent que ceux du support aient été relus (seedStations()).
+ *
+ * @return bool @c true si une écriture est nécessaire.
+ */
+bool StorageWriter::hasPending() const
+{
+    return !m_frames.isEmpty() || !m_events.isEmpty() || !m_predictions.isEmpty()
+           || (m_stationsSeeded && !m_pendingStations.isEmpty());
+}
+
+/**
+ * @brief Change l'état de santé du support et émet stateChanged.
+ *
+ * @param state Le nouvel état.
+ */
+void StorageWriter::setState(DatabaseState state)
+{
+    if (state == DatabaseState::Unavailable)
+        m_recovering = true;
+    m_state = state;
+    emit stateChanged(m_name, state, m_frames.size());
+}
+
+/**
+ * @brief Programme une reconnexion avec un délai croissant.
+ */
+void StorageWriter::scheduleReconnect()
+{
+    if (m_reconnectTimer.isActive())
+        return;
+    emit logMessage(QString("Base %1 indisponible, nouvelle tentative dans %2 s.")
+                        .arg(m_name)
+                        .arg(m_reconnectDelay / 1000));
+    m_reconnectTimer.start(m_reconnectDelay);
+    m_reconnectDelay = qMin(m_reconnectDelay * 2, MAX_RECONNECT_DELAY);
+}
+
+/**
+ * @brief Traite l'échec d'une écriture.
+ *
+ * Si le support ne répond plus, sa connexion est fermée, son état passe à indisponible et une
+ * reconnexion est programmée. Sinon l'échec est propre à l'élément (donnée refusée).
+ *
+ * @return bool @c true si le support est perdu, @c false sinon.
+ */
+bool StorageWriter::handleWriteFailure()
+{
+    if (m_backend->ping())
+        return false;
+    m_backend->closeConnection();
+    setState(DatabaseState::Unavailable);
+    scheduleReconnect();
+    return true;
+}
+
+/**
+ * @brief Ajoute un élément à une file bornée.
+ *
+ * @param queue La file.
+ * @param item L'élément à ajouter.
+ * @param capacity La capacité de la file.
+ * @return bool @c true si l'élément le plus ancien a été abandonné.
+ */
+template <typename T>
+bool StorageWriter::enqueue(QQueue<T> &queue, const T &item, int capacity)
+{
+    bool dropped = false;
+    if (queue.size() >= capacity) {
+        queue.dequeue();
+        dropped = true;
+    }
+    queue.enqueue(item);
+    return dropped;
+}
+
+/**
+ * @brief Programme l'écriture des files.
+ *
+ * L'écriture a lieu au plus tard FLUSH_INTERVAL ms après le premier élément mis en attente,
+ * ou immédiatement si le support disponible a atteint FLUSH_THRESHOLD trames en attente.
+ */
+void StorageWriter::scheduleFlush()
+{
+    if (m_state == DatabaseState::Connected && m_frames.size() >= FLUSH_THRESHOLD)
+        flush();
+    else if (!m_flushTimer.isActive())
+        m_flushTimer.start(FLUSH_INTERVAL);
+}
+
+/**
+ * @brief Met une trame en attente d'écriture.
+ *
+ * Le dernier état connu de sa station source est mis à jour ; sa publication est différée de
+ * STATION_DEBOUNCE ms au plus.
+ *
+ * @param frame La trame à enregistrer.
+ */
+void StorageWriter::storeFrame(const FramePtr &frame)
+{
+    if (frame->source() != CallsignTable::NONE) {
+        StationState &station = m_stations[frame->source()];
+        if (station.callsign.isEmpty())
+            station.callsign = frame->sourceName();
+        station.update(*frame);
+        m_dirtyStations.insert(frame->source());
+        if (!m_stationTimer.isActive())
+            m_stationTimer.start();
+    }
+
+    if (enqueue(m_frames, frame, MAX_PENDING_FRAMES))
+        ++m_droppedFrames;
+    scheduleFlush();
+}
+
+/**
+ * @brief Met un événement de vol en attente d'écriture.
+ *
+ * @param event L'événement à enregistrer.
+ */
+void StorageWriter::storeFlightEvent(const FlightEvent &event)
+{
+    enqueue(m_events, event, MAX_PENDING_RECORDS);
+    scheduleFlush();
+}
+
+/**
+ * @brief Met une prédiction d'atterrissage en attente d'écriture.
+ *
+ * @param prediction La prédiction à enregistrer.
+ */
+void StorageWriter::storeLandingPrediction(const LandingPrediction &prediction)
+{
+    enqueue(m_predictions, prediction, MAX_PENDING_RECORDS);
+    scheduleFlush();
+}
+
+/**
+ * @brief Met en attente d'écriture les états de station modifiés.
+ *
+ * Seul le plus récent état de chaque station est conservé : la file est bornée par le nombre
+ * de stations, même pendant une longue indisponibilité.
+ */
+void StorageWriter::publishStations()
+{
+    m_stationTimer.stop();
+    if (m_dirtyStations.isEmpty())
+        return;
+    for (CallsignId id : std::as_const(m_dirtyStations))
+        m_pendingStations.insert(id, m_stations.value(id));
+    m_dirtyStations.clear();
+    scheduleFlush();
+}
+
+/**
+ * @brief Écrit les files en attente si le support est disponible.
+ *
+ * Sinon, le nombre de trames en attente est republié.
+ */
+void StorageWriter::flush()
+{
+    m_flushTimer.stop();
+    if (!m_backend)
+        return;
+    if (m_state == DatabaseState::Connected)
+        flushPending();
+    else
+        emit stateChanged(m_name, m_state, m_frames.size());
+}
+
+/**
+ * @brief Écrit dans une transaction les éléments en attente.
+ *
+ * Les files ne sont vidées qu'après validation de la transaction. En cas d'échec, la transaction
+ * est annulée et rien n'est perdu :
+ * - support perdu : tous les éléments sont conservés pour la prochaine connexion ;
+ * - validation refusée par un support qui répond : les éléments sont conservés, la connexion est
+ *   rouverte et l'écriture réessayée avec un délai croissant ;
+ * - élément refusé : les éléments acceptés avant lui sont validés dans une nouvelle transaction,
+ *   puis il est réessayé seul, et abandonné seulement s'il échoue encore (donnée invalide) ;
+ *   l'écriture reprend après lui. Chaque élément est ainsi écrit au plus deux fois, quel que soit
+ *   le nombre d'éléments refusés.
+ */
+void StorageWriter::flushPending()
+{
+    seedStations();
+    if (!hasPending())
+        return;
+
+    TraceSpan span("stockage");
+    int saved = 0;
+    while (hasPending()) {
+        PendingItem failed;
+        if (m_backend->beginBatch()) {
+            if (writePending(failed) && m_backend->commitBatch()) {
+                saved += m_frames.size();
+                m_frames.clear();
+                m_events.clear();
+                m_predictions.clear();
+                if (m_stationsSeeded)
+                    m_pendingStations.clear();
+                break;
+            }
+            m_backend->rollbackBatch();
+        }
+        if (handleWriteFailure())
+            return;
+
+        if (failed.queue != PendingItem::None) {
+            const int frames = m_frames.size();
+            if (commitBefore(failed)) {
+                saved += frames - m_frames.size();
+                failed.index = 0;
+            } else if (handleWriteFailure()) {
+                return;
+            } else {
+                failed.queue = PendingItem::None;
+            }
+        }
+
+        if (failed.queue == PendingItem::None) {
+            emit logMessage(QString("Base %1 : transaction refusée, %2 trame(s) conservée(s) pour une nouvelle tentative.")
+                                .arg(m_name)
+                                .arg(m_frames.size()));
+            m_backend->closeConnection();
+            setState(DatabaseState::Unavailable);
+            scheduleReconnect();
+            return;
+        }
+
+        if (writeAlone(failed)) {
+            if (failed.queue == PendingItem::Frames)
+                ++saved;
+        } else {
+            if (handleWriteFailure())
+                return;
+            emit logMessage(QString("Base %1 : élément refusé, abandonné.").arg(m_name));
+        }
+        removeItem(failed);
+    }
+
+    if (m_recovering) {
+        emit logMessage(QString("Base %1 : %2 trame(s) en attente enregistrée(s), %3 abandonnée(s).")
+                            .arg(m_name)
+                            .arg(saved)
+                            .arg(m_droppedFrames));
+        m_recovering = false;
+    }
+    m_droppedFrames = 0;
+}
+
+/**
+ * @brief Écrit les éléments en attente dans la transaction ouverte, dans l'ordre des files.
+ *
+ * @param failed Premier élément refusé, en cas d'échec.
+ * @param end Premier élément à ne pas écrire (None : tous les éléments sont écrits).
+ * @return bool @c true si tous les éléments ont été écrits, @c false au premier refus.
+ */
+bool StorageWriter::writePending(PendingItem &failed, const PendingItem &end)
+{
+    PendingItem item;
+    item.queue = PendingItem::Frames;
+    for (item.index = 0; item.index < m_frames.size(); ++item.index) {
+        if (end.queue == item.queue && end.index == item.index)
+            return true;
+        TraceSpan frameSpan("stockage trame", m_frames.at(item.index)->id());
+        if (!writeItem(item)) {
+            failed = item;
+            return false;
+        }
+    }
+    item.queue = PendingItem::Events;
+    for (item.index = 0; item.index < m_events.size(); ++item.index) {
+        if (end.queue == item.queue && end.index == item.index)
+            return true;
+        if (!writeItem(item)) {
+            failed = item;
+            return false;
+        }
+    }
+    item.queue = PendingItem::Predictions;
+    for (item.index = 0; item.index < m_predictions.size(); ++item.index) {
+        if (end.queue == item.queue && end.index == item.index)
+            return true;
+        if (!writeItem(item)) {
+            failed = item;
+            return false;
+        }
+    }
+    if (!m_stationsSeeded)
+        return true;
+    item.queue = PendingItem::Stations;
+    for (auto it = m_pendingStations.cbegin(); it != m_pendingStations.cend(); ++it) {
+        item.station = it.key();
+        if (end.queue == item.queue && end.station == item.station)
+            return true;
+        if (!writeItem(item)) {
+            failed = item;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Valide dans leur propre transaction les éléments qui précèdent un élément refusé.
+ *
+ * Ces éléments viennent d'être acceptés par le support : ils sont écrits une seconde fois puis
+ * retirés des files, l'élément refusé passant en tête de la sienne.
+ *
+ * @param end L'élément refusé.
+ * @return bool @c true si les éléments ont été validés, @c false sinon (transaction annulée).
+ */
+bool StorageWriter::commitBefore(const PendingItem &end)
+{
+    if (!m_backend->beginBatch())
+        return false;
+    PendingItem failed;
+    if (!writePending(failed, end) || !m_backend->commitBatch()) {
+        m_backend->rollbackBatch();
+        return false;
+    }
+
+    switch (end.queue) {
+    case PendingItem::Stations: {
+        QList<CallsignId> written;
+        for (auto it = m_pendingStations.cbegin(); it != m_pendingStations.cend() && it.key() != end.station; ++it)
+            written.append(it.key());
+        for (CallsignId id : std::as_const(written))
+            m_pendingStations.remove(id);
+        m_predictions.clear();
+        m_events.clear();
+        m_frames.clear();
+        break;
+    }
+    case PendingItem::Predictions:
+        m_predictions.erase(m_predictions.begin(), m_predictions.begin() + end.index);
+        m_events.clear();
+        m_frames.clear();
+        break;
+    case PendingItem::Events:
+        m_events.erase(m_events.begin(), m_events.begin() + end.index);
+        m_frames.clear();
+        break;
+    case PendingItem::Frames:
+        m_frames.erase(m_frames.begin(), m_frames.begin() + end.index);
+        break;
+    case PendingItem::None:
+        break;
+    }
+    return true;
+}
+
+/**
+ * @brief Écrit un élément en attente dans la transaction ouverte.
+ *
+ * @param item L'élément.
+ * @return bool @c true si l'écriture a réussi.
+ */
+bool StorageWriter::writeItem(const PendingItem &item)
+{
+    switch (item.queue) {
+    case PendingItem::Frames:      return m_backend->insertFrame(*m_frames.at(item.index));
+    case PendingItem::Events:      return m_backend->insertFlightEvent(m_events.at(item.index));
+    case PendingItem::Predictions: return m_backend->insertLandingPrediction(m_predictions.at(item.index));
+    case PendingItem::Stations:    return m_backend->upsertStationState(m_pendingStations.value(item.station));
+    case PendingItem::None:        break;
+    }
+    return true;
+}
+
+/**
+ * @brief Écrit un élément en attente dans sa propre transaction.
+ *
+ * @param item L'élément.
+ * @return bool @c true si l'élément a été écrit et validé, @c false sinon (transaction annulée).
+ */
+bool StorageWriter::writeAlone(const PendingItem &item)
+{
+    if (!m_backend->beginBatch())
+        return false;
+    if (writeItem(item) && m_backend->commitBatch())
+        return true;
+    m_backend->rollbackBatch();
+    return false;
+}
+
+/**
+ * @brief Retire un élément de sa file d'attente.
+ *
+ * @param item L'élément.
+ */
+void StorageWriter::removeItem(const PendingItem &item)
+{
+    switch (item.queue) {
+    case PendingItem::Frames:      m_frames.removeAt(item.index); break;
+    case PendingItem::Events:      m_events.removeAt(item.index); break;
+    case PendingItem::Predictions: m_predictions.removeAt(item.index); break;
+    case PendingItem::Stations:    m_pendingStations.remove(item.station); break;
+    case PendingItem::None:        break;
+    }
+}
@@ -0,0 +1,253 @@
+#ifndef STORAGEWRITER_H
+#define STORAGEWRITER_H
+
+/**
+ * @file storagewriter.h
+ * @brief Déclaration de la classe StorageWriter.
+ *
+ * Ce fichier définit l'écrivain d'un support de stockage : il s'exécute dans son propre thread,
+ * si bien qu'une connexion lente ou bloquée (MySQL injoignable) ne retarde jamais les écritures
+ * des autres supports (SQLite local).
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QQueue>
+#include <QSet>
+#include <QTimer>
+
+#include <functional>
+#include <memory>
+
+#include "frame.h"
+#include "flightstateengine.h"
+#include "landingpredictor.h"
+#include "stationstate.h"
+
+class StorageBackend;
+
+/**
+ * @brief État de santé d'un support de stockage.
+ */
+enum class DatabaseState {
+    Connecting,  ///< Connexion en cours.
+    Connected,   ///< Support disponible.
+    Unavailable  ///< Support indisponible, écritures mises en attente.
+};
+
+Q_DECLARE_METATYPE(DatabaseState)
+
+/**
+ * @brief Écrivain asynchrone d'un support de stockage.
+ *
+ * L'objet est destiné à être déplacé dans un QThread dédié : le support est créé et connecté par
+ * le slot start() dans ce thread, puis les trames, événements de vol et prédictions reçus via des
+ * connexions en file d'attente y sont écrits. Les files sont bornées (les éléments les plus anciens
+ * sont abandonnés en cas de débordement) ; un support indisponible est reconnecté avec un délai
+ * croissant. Les files d'un support disponible sont écrites en une transaction toutes les
+ * FLUSH_INTERVAL ms, ou dès que FLUSH_THRESHOLD trames sont en attente.
+ *
+ * L'écrivain tient aussi en mémoire le dernier état connu de chaque station (StationState), mis à
+ * jour à chaque trame. Les états modifiés sont recopiés dans la table station_state au plus une fois
+ * toutes les STATION_DEBOUNCE ms par station. Les états déjà enregistrés sur ce support y sont
+ * relus pour compléter ceux de la mémoire avant la première écriture d'un état : chaque support
+ * fusionne son propre historique, qu'il soit écrit le premier ou non.
+ */
+class StorageWriter : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int MAX_PENDING_FRAMES  = 10000; ///< Capacité de la file des trames en attente.
+    static constexpr int MAX_PENDING_RECORDS = 1000;  ///< Capacité des files d'événements et de prédictions.
+    static constexpr int FLUSH_INTERVAL      = 100;   ///< Délai maximal avant écriture d'une transaction (ms).
+    static constexpr int FLUSH_THRESHOLD     = 500;   ///< Nombre de trames déclenchant une écriture immédiate.
+    static constexpr int MIN_RECONNECT_DELAY = 2000;  ///< Délai initial avant reconnexion (ms).
+    static constexpr int MAX_RECONNECT_DELAY = 60000; ///< Délai maximal avant reconnexion (ms).
+    static constexpr int STATION_DEBOUNCE    = 1000;  ///< Délai de regroupement des mises à jour de station_state (ms).
+
+    /**
+     * @brief Fonction créant le support, appelée dans le thread de l'écrivain.
+     */
+    using BackendFactory = std::function<StorageBackend *()>;
+
+    /**
+     * @brief Constructeur de la classe StorageWriter.
+     * @param factory Fonction créant le support (l'écrivain en devient propriétaire).
+     * @param parent Pointeur vers l'objet parent (par défaut nullptr, nécessaire pour moveToThread).
+     */
+    explicit StorageWriter(BackendFactory factory, QObject *parent = nullptr);
+
+    /**
+     * @brief Destructeur.
+     */
+    ~StorageWriter();
+
+public slots:
+    /**
+     * @brief Crée le support et lance sa première connexion.
+     *
+     * Doit être appelé dans le thread de l'écrivain (par exemple connecté à QThread::started).
+     */
+    void start();
+
+    /**
+     * @brief Écrit les éléments en attente puis ferme et détruit le support.
+     *
+     * Doit être appelé dans le thread de l'écrivain, avant l'arrêt de ce thread.
+     */
+    void stop();
+
+    /**
+     * @brief Met une trame en attente d'écriture.
+     * @param frame La trame à enregistrer.
+     */
+    void storeFrame(const FramePtr &frame);
+
+    /**
+     * @brief Met un événement de vol en attente d'écriture.
+     * @param event L'événement à enregistrer.
+     */
+    void storeFlightEvent(const FlightEvent &event);
+
+    /**
+     * @brief Met une prédiction d'atterrissage en attente d'écriture.
+     * @param prediction La prédiction à enregistrer.
+     */
+    void storeLandingPrediction(const LandingPrediction &prediction);
+
+signals:
+    /**
+     * @brief Signal émis à chaque changement d'état du support.
+     * @param backend Nom du support ("SQLite", "MySQL").
+     * @param state Le nouvel état.
+     * @param pending Nombre de trames en attente.
+     */
+    void stateChanged(const QString &backend, DatabaseState state, int pending);
+
+    /**
+     * @brief Signal pour la journalisation des messages (erreurs, reprise après indisponibilité).
+     * @param msg Le message à journaliser.
+     */
+    void logMessage(const QString &msg);
+
+private slots:
+    /**
+     * @brief Tente d'ouvrir la connexion du support.
+     */
+    void connectBackend();
+
+    /**
+     * @brief Écrit dans une transaction les éléments en attente, si le support est disponible.
+     */
+    void flush();
+
+    /**
+     * @brief Met en attente d'écriture les états de station modifiés.
+     */
+    void publishStations();
+
+private:
+    /**
+     * @brief Désigne un élément en attente.
+     */
+    struct PendingItem {
+        enum Queue { None, Frames, Events, Predictions, Stations };
+        Queue queue = None;                       ///< File de l'élément (None : aucun).
+        int index = 0;                            ///< Position dans la file (trames, événements, prédictions).
+        CallsignId station = CallsignTable::NONE; ///< Station (états de station).
+    };
+
+    /**
+     * @brief Change l'état de santé du support et émet stateChanged.
+     */
+    void setState(DatabaseState state);
+
+    /**
+     * @brief Traite l'échec d'une écriture : bascule en indisponible si le support ne répond plus.
+     * @return bool @c true si le support est perdu.
+     */
+    bool handleWriteFailure();
+
+    /**
+     * @brief Programme une reconnexion avec un délai croissant.
+     */
+    void scheduleReconnect();
+
+    /**
+     * @brief Écrit dans une transaction les éléments en attente.
+     */
+    void flushPending();
+
+    /**
+     * @brief Écrit les éléments en attente dans la transaction ouverte.
+     * @param failed Premier élément refusé, en cas d'échec.
+     * @param end Premier élément à ne pas écrire (None : tous).
+     * @return bool @c true si tous les éléments ont été écrits.
+     */
+    bool writePending(PendingItem &failed, const PendingItem &end = PendingItem());
+
+    /**
+     * @brief Valide les éléments qui précèdent un élément refusé et les retire des files.
+     * @return bool @c true si les éléments ont été validés.
+     */
+    bool commitBefore(const PendingItem &end);
+
+    /**
+     * @brief Écrit un élément en attente dans la transaction ouverte.
+     */
+    bool writeItem(const PendingItem &item);
+
+    /**
+     * @brief Écrit un élément en attente dans sa propre transaction.
+     * @return bool @c true si l'élément a été écrit et validé.
+     */
+    bool writeAlone(const PendingItem &item);
+
+    /**
+     * @brief Retire un élément de sa file d'attente.
+     */
+    void removeItem(const PendingItem &item);
+
+    /**
+     * @brief Complète les états en mémoire avec ceux enregistrés sur le support (une seule fois).
+     */
+    void seedStations();
+
+    /**
+     * @brief Indique s'il reste des éléments à écrire (les états de station seulement une fois relus).
+     */
+    bool hasPending() const;
+
+    /**
+     * @brief Programme l'écriture des files, immédiate si le seuil est atteint.
+     */
+    void scheduleFlush();
+
+    /**
+     * @brief Ajoute un élément à une file bornée, en abandonnant le plus ancien si elle est pleine.
+     * @return bool @c true si un élément a été abandonné.
+     */
+    template <typename T>
+    static bool enqueue(QQueue<T> &queue, const T &item, int capacity);
+
+    BackendFactory m_factory;                     ///< Fonction créant le support.
+    std::unique_ptr<StorageBackend> m_backend;    ///< Support de stockage.
+    QString m_name;                               ///< Nom du support, pour l'affichage.
+    DatabaseState m_state = DatabaseState::Connecting; ///< État de santé.
+    QTimer m_reconnectTimer;                      ///< Minuteur de reconnexion.
+    int m_reconnectDelay = MIN_RECONNECT_DELAY;   ///< Délai de la prochaine reconnexion (ms).
+    bool m_recovering = false;                    ///< Indique une reprise après indisponibilité.
+    QQueue<FramePtr> m_frames;                    ///< Trames en attente.
+    QQueue<FlightEvent> m_events;                 ///< Événements de vol en attente.
+    QQueue<LandingPrediction> m_predictions;      ///< Prédictions en attente.
+    QHash<CallsignId, StationState> m_pendingStations; ///< États de station en attente (le plus récent par station).
+    quint64 m_droppedFrames = 0;                  ///< Trames abandonnées depuis la dernière écriture.
+    QTimer m_flushTimer;                          ///< Minuteur d'écriture des transactions.
+    QHash<CallsignId, StationState> m_stations;   ///< Dernier état connu de chaque station.
+    QSet<CallsignId> m_dirtyStations;             ///< Stations modifiées depuis la dernière publication.
+    QTimer m_stationTimer;                        ///< Minuteur de regroupement des mises à jour de station_state.
+    bool m_stationsSeeded = false;                ///< Indique si les états enregistrés ont été relus.
+};
+
+#endif // STORAGEWRITER_H
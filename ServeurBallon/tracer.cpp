@@ -0,0 +1,238 @@
+#include "tracer.h"
+
+#include <QSaveFile>
+
+#include <chrono>
+#include <cstdio>
+
+/**
+ * @file tracer.cpp
+ * @brief Implémentation des classes Tracer et TraceSpan.
+ *
+ * Ce fichier contient l'écriture sans verrou des événements dans les tampons par thread,
+ * leur relecture cohérente pendant l'écriture et l'export au format JSON « trace event ».
+ */
+
+std::atomic<bool> Tracer::s_enabled{false};
+QMutex Tracer::s_lock;
+std::vector<Tracer::Buffer *> Tracer::s_buffers;
+
+namespace {
+
+std::atomic<qint64> s_origin{0}; ///< Origine des temps de la trace (ns, horloge monotone).
+
+/**
+ * @brief Retourne l'instant courant de l'horloge monotone (ns).
+ */
+qint64 steadyNow()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Ajoute une chaîne JSON (entre guillemets, caractères spéciaux échappés).
+ */
+void appendString(std::string &out, const char *text)
+{
+    out += '"';
+    for (const char *c = text; *c; ++c) {
+        unsigned char ch = static_cast<unsigned char>(*c);
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += *c;
+        } else if (ch < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+            out += escaped;
+        } else {
+            out += *c;
+        }
+    }
+    out += '"';
+}
+
+/**
+ * @brief Ajoute une durée en microsecondes (unité du format) à partir d'une valeur en ns.
+ */
+void appendMicroseconds(std::string &out, qint64 ns)
+{
+    char number[32];
+    std::snprintf(number, sizeof(number), "%lld.%03lld",
+                  static_cast<long long>(ns / 1000), static_cast<long long>(ns % 1000));
+    out += number;
+}
+
+} // namespace
+
+/**
+ * @brief Active le traçage.
+ *
+ * L'origine des temps n'est fixée qu'à la première activation : une trace couvre toute l'exécution.
+ */
+void Tracer::enable()
+{
+    qint64 expected = 0;
+    s_origin.compare_exchange_strong(expected, steadyNow());
+    s_enabled.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Nomme le thread appelant dans la trace.
+ *
+ * @param name Le nom du thread.
+ */
+void Tracer::setThreadName(const QString &name)
+{
+    if (!enabled())
+        return;
+    Buffer &buffer = threadBuffer();
+    QMutexLocker locker(&s_lock);
+    buffer.name = name.toStdString();
+}
+
+/**
+ * @brief Retourne l'instant courant.
+ *
+ * @return qint64 Nombre de ns écoulées depuis l'activation du traçage.
+ */
+qint64 Tracer::now()
+{
+    return steadyNow() - s_origin.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Enregistre un intervalle terminé.
+ *
+ * Le thread appelant est le seul écrivain de son tampon : l'événement est écrit dans la case
+ * suivante (en écrasant le plus ancien si le tampon est plein), puis publié en avançant le compteur.
+ * La barrière placée avant l'écriture garantit qu'un lecteur qui observe une case en cours
+ * de réécriture observe aussi le compteur de l'événement précédent, et peut donc l'écarter.
+ *
+ * @param name Nom de l'étape.
+ * @param begin Début de l'intervalle (ns).
+ * @param end Fin de l'intervalle (ns).
+ * @param frameId Identifiant de la trame traitée (0 : aucune).
+ */
+void Tracer::record(const char *name, qint64 begin, qint64 end, quint64 frameId)
+{
+    Buffer &buffer = threadBuffer();
+    const quint64 index = buffer.written.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Event &event = buffer.events[static_cast<std::size_t>(index % BUFFER_CAPACITY)];
+    event.name.store(name, std::memory_order_relaxed);
+    event.begin.store(begin, std::memory_order_relaxed);
+    event.duration.store(end - begin, std::memory_order_relaxed);
+    event.frameId.store(frameId, std::memory_order_relaxed);
+
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Retourne le tampon du thread appelant.
+ *
+ * Le tampon est créé et enregistré au premier appel depuis un thread ; il n'est jamais libéré.
+ *
+ * @return Buffer& Le tampon du thread.
+ */
+Tracer::Buffer &Tracer::threadBuffer()
+{
+    thread_local Buffer *buffer = nullptr;
+    if (!buffer) {
+        QMutexLocker locker(&s_lock);
+        buffer = new Buffer(static_cast<int>(s_buffers.size()) + 1);
+        s_buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+/**
+ * @brief Construit la trace au format JSON « trace event ».
+ *
+ * Pour chaque tampon, les événements publiés sont recopiés, puis le compteur est relu : les cases
+ * qui ont pu être réécrites pendant la copie sont écartées. Chaque thread est décrit par un
+ * événement de métadonnées thread_name ; chaque intervalle est un événement complet ("ph": "X")
+ * portant l'identifiant de la trame dans ses arguments.
+ *
+ * @return std::string Le document JSON.
+ */
+std::string Tracer::toJson()
+{
+    struct Copy {
+        const char *name;
+        qint64 begin;
+        qint64 duration;
+        quint64 frameId;
+    };
+
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&out, &first]() {
+        if (!first)
+            out += ",\n";
+        first = false;
+    };
+
+    QMutexLocker locker(&s_lock);
+    std::vector<Copy> copies;
+    copies.reserve(BUFFER_CAPACITY);
+    for (const Buffer *buffer : s_buffers) {
+        const std::string tid = std::to_string(buffer->tid);
+        if (!buffer->name.empty()) {
+            separator();
+            out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":";
+            appendString(out, buffer->name.c_str());
+            out += "}}";
+        }
+
+        const quint64 written = buffer->written.load(std::memory_order_acquire);
+        const quint64 start = written > static_cast<quint64>(BUFFER_CAPACITY) ? written - BUFFER_CAPACITY : 0;
+        copies.clear();
+        for (quint64 i = start; i < written; ++i) {
+            const Event &event = buffer->events[static_cast<std::size_t>(i % BUFFER_CAPACITY)];
+            copies.push_back({event.name.load(std::memory_order_relaxed),
+                              event.begin.load(std::memory_order_relaxed),
+                              event.duration.load(std::memory_order_relaxed),
+                              event.frameId.load(std::memory_order_relaxed)});
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const quint64 after = buffer->written.load(std::memory_order_relaxed);
+        // La case de l'événement « after » est peut-être en cours d'écriture
+        const quint64 valid = after >= static_cast<quint64>(BUFFER_CAPACITY) ? after - BUFFER_CAPACITY + 1 : 0;
+
+        for (quint64 i = qMax(start, valid); i < written; ++i) {
+            const Copy &event = copies[static_cast<std::size_t>(i - start)];
+            separator();
+            out += "{\"name\":";
+            appendString(out, event.name);
+            out += ",\"cat\":\"reception\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+            appendMicroseconds(out, event.begin);
+            out += ",\"dur\":";
+            appendMicroseconds(out, event.duration);
+            if (event.frameId != 0)
+                out += ",\"args\":{\"trame\":" + std::to_string(event.frameId) + "}";
+            out += '}';
+        }
+    }
+    out += "]}\n";
+    return out;
+}
+
+/**
+ * @brief Écrit la trace dans un fichier.
+ *
+ * Le fichier est remplacé d'un bloc : une trace précédente n'est jamais laissée à moitié écrite.
+ *
+ * @param path Chemin du fichier.
+ * @return bool @c true si le fichier a été écrit.
+ */
+bool Tracer::dump(const QString &path)
+{
+    const std::string json = toJson();
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(json.data(), static_cast<qint64>(json.size()));
+    return file.commit();
+}
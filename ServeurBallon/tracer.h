@@ -0,0 +1,165 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+/**
+ * @file tracer.h
+ * @brief Déclaration des classes Tracer et TraceSpan.
+ *
+ * Ce fichier définit le traçage optionnel de la chaîne de réception : chaque étape (lecture série,
+ * déramage KISS, décodage AX.25, passerelle APRS-IS, stockage, interface) enregistre des intervalles
+ * horodatés, rattachés au thread et à la trame traitée, exportés au format « trace event » de
+ * Chrome / Perfetto.
+ */
+
+#pragma once
+
+#include <QMutex>
+#include <QString>
+#include <QtGlobal>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Enregistreur d'intervalles de traçage.
+ *
+ * Le traçage est désactivé par défaut : un TraceSpan ne coûte alors qu'une lecture atomique.
+ * Une fois activé (enable()), chaque thread écrit dans son propre tampon circulaire de
+ * BUFFER_CAPACITY événements, sans verrou : le thread est le seul écrivain de son tampon et publie
+ * chaque événement en avançant son compteur. Lorsque le tampon est plein, les événements les plus
+ * anciens sont écrasés. Les tampons sont créés au premier événement d'un thread et ne sont jamais
+ * libérés, ce qui permet d'exporter la trace (toJson(), dump()) à tout moment, depuis n'importe quel
+ * thread, pendant que les autres continuent d'écrire.
+ */
+class Tracer {
+public:
+    static constexpr int BUFFER_CAPACITY = 1 << 16; ///< Nombre d'événements conservés par thread.
+
+    /**
+     * @brief Indique si le traçage est actif.
+     */
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Active le traçage ; l'origine des temps de la trace est l'instant de la première activation.
+     */
+    static void enable();
+
+    /**
+     * @brief Nomme le thread appelant dans la trace.
+     * @param name Le nom du thread.
+     */
+    static void setThreadName(const QString &name);
+
+    /**
+     * @brief Retourne l'instant courant (ns depuis l'activation du traçage).
+     */
+    static qint64 now();
+
+    /**
+     * @brief Enregistre un intervalle terminé dans le tampon du thread appelant.
+     *
+     * @param name Nom de l'étape (chaîne statique, elle n'est pas recopiée).
+     * @param begin Début de l'intervalle (valeur de now()).
+     * @param end Fin de l'intervalle (valeur de now()).
+     * @param frameId Identifiant de la trame traitée (0 : aucune).
+     */
+    static void record(const char *name, qint64 begin, qint64 end, quint64 frameId);
+
+    /**
+     * @brief Construit la trace au format JSON « trace event » (objet traceEvents).
+     * @return std::string Le document JSON.
+     */
+    static std::string toJson();
+
+    /**
+     * @brief Écrit la trace dans un fichier.
+     * @param path Chemin du fichier (ouvert ensuite dans chrome://tracing ou ui.perfetto.dev).
+     * @return bool @c true si le fichier a été écrit.
+     */
+    static bool dump(const QString &path);
+
+private:
+    /**
+     * @brief Événement enregistré (champs atomiques : lus pendant l'écriture par un autre thread).
+     */
+    struct Event {
+        std::atomic<const char *> name{nullptr}; ///< Nom de l'étape.
+        std::atomic<qint64> begin{0};            ///< Début (ns).
+        std::atomic<qint64> duration{0};         ///< Durée (ns).
+        std::atomic<quint64> frameId{0};         ///< Trame traitée (0 : aucune).
+    };
+
+    /**
+     * @brief Tampon circulaire d'un thread.
+     */
+    struct Buffer {
+        explicit Buffer(int tid) : tid(tid), events(BUFFER_CAPACITY) {}
+        const int tid;                      ///< Identifiant du thread dans la trace.
+        std::vector<Event> events;          ///< Événements (indice : numéro modulo BUFFER_CAPACITY).
+        std::atomic<quint64> written{0};    ///< Nombre d'événements publiés.
+        std::string name;                   ///< Nom du thread (protégé par s_lock).
+    };
+
+    /**
+     * @brief Retourne le tampon du thread appelant, en le créant si nécessaire.
+     */
+    static Buffer &threadBuffer();
+
+    static std::atomic<bool> s_enabled;     ///< Traçage actif.
+    static QMutex s_lock;                   ///< Protège la liste des tampons et les noms de threads.
+    static std::vector<Buffer *> s_buffers; ///< Tampons de tous les threads tracés.
+};
+
+/**
+ * @brief Intervalle de traçage couvrant une portée.
+ *
+ * L'intervalle commence à la construction et est enregistré à la destruction, si le traçage était
+ * actif à la construction.
+ *
+ * @code
+ * TraceSpan span("decodage AX.25");
+ * FramePtr frame = Frame::fromAX25(...);
+ * span.setFrame(frame ? frame->id() : 0);
+ * @endcode
+ */
+class TraceSpan {
+public:
+    /**
+     * @brief Ouvre un intervalle.
+     * @param name Nom de l'étape (chaîne statique).
+     * @param frameId Identifiant de la trame traitée (0 : aucune).
+     */
+    explicit TraceSpan(const char *name, quint64 frameId = 0)
+        : m_name(Tracer::enabled() ? name : nullptr),
+        m_frameId(frameId),
+        m_begin(m_name ? Tracer::now() : 0)
+    {
+    }
+
+    /**
+     * @brief Ferme et enregistre l'intervalle.
+     */
+    ~TraceSpan()
+    {
+        if (m_name)
+            Tracer::record(m_name, m_begin, Tracer::now(), m_frameId);
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+    /**
+     * @brief Rattache l'intervalle à une trame connue après son ouverture.
+     * @param frameId Identifiant de la trame.
+     */
+    void setFrame(quint64 frameId) { m_frameId = frameId; }
+
+private:
+    const char *m_name;  ///< Nom de l'étape (nullptr : traçage inactif).
+    quint64 m_frameId;   ///< Trame traitée.
+    qint64 m_begin;      ///< Début de l'intervalle (ns).
+};
+
+#endif // TRACER_H